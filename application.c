@@ -2276,7 +2276,10 @@ void InitializeApplication(APPLICATION* app, char* init_file_name)
 	}
 	
 	// CEBhE\
-	gtk_widget_show_all(app->window);
+	if((app->flags & APPLICATION_HEADLESS) == 0)
+	{
+		gtk_widget_show_all(app->window);
+	}
 
 	// FIEBWFbg̕\E\ݒ
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(app->tool_window.color_chooser->circle_button),
@@ -2493,7 +2496,10 @@ void InitializeApplication(APPLICATION* app, char* init_file_name)
 	app->flags |= APPLICATION_INITIALIZED;
 
 	// obNAbvt@C𕜌
-	RecoverBackUp(app);
+	if((app->flags & APPLICATION_HEADLESS) == 0)
+	{
+		RecoverBackUp(app);
+	}
 }
 
 /*********************************************************************
@@ -4682,6 +4688,7 @@ void ExecuteChangeCanvasIccProfile(GtkWidget* menu, APPLICATION* app)
 
 						if(window->icc_transform)
 						{
+							ReleaseIccDisplayLut(&window->icc_lut);
 							cmsDeleteTransform(window->icc_transform);
 						}
 
@@ -4719,6 +4726,7 @@ void ExecuteChangeCanvasIccProfile(GtkWidget* menu, APPLICATION* app)
 
 			if(window->icc_transform)
 			{
+				ReleaseIccDisplayLut(&window->icc_lut);
 				cmsDeleteTransform(window->icc_transform);
 			}
 
@@ -106,7 +106,8 @@ typedef enum _eAPPLICATION_FLAGS
 	APPLICATION_SHOW_PREVIEW_ON_TASK_BAR = 0x2000,		// vr[EBhE^XNo[ɕ\
 	APPLICATION_IN_SWITCH_DRAW_WINDOW = 0x4000,			// `̈̐ؑ֒
 	APPLICATION_WRITE_PROGRAM_DATA_DIRECTORY = 0x8000,	// t@C̏oProgram DatatFI_ɂ
-	APPLICATION_HAS_3D_LAYER = 0x10000					// 3DfO̎gp
+	APPLICATION_HAS_3D_LAYER = 0x10000,					// 3DfO̎gp
+	APPLICATION_HEADLESS = 0x20000						// EBhE\ɏ(\vp)
 } eAPPLICATION_FLAGS;
 
 #define DND_THRESHOLD 20
@@ -424,6 +425,8 @@ typedef struct _APPLICATION
 	cmsHPROFILE output_icc;
 	// ICCvt@CɂFϊp
 	cmsHTRANSFORM icc_transform;
+	// ICCvt@CKp̕ϊe[u
+	ICC_DISPLAY_LUT icc_lut;
 
 	// p^[hׂp
 	PATTERNS patterns;
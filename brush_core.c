@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <gtk/gtk.h>
@@ -7,6 +8,7 @@
 #include "anti_alias.h"
 #include "memory_stream.h"
 #include "layer.h"
+#include "display.h"
 #include "memory.h"
 #include "bezier.h"
 
@@ -38,6 +40,218 @@ void BrushCorePointReset(BRUSH_CORE* core)
 	core->max_y = -1.0;
 }
 
+/***************************************************
+* GenerateCircleDab֐                            *
+* A`GCAXt̉~`uV̉摜쐬 *
+*                                              *
+* pixels			: 摜ރsNZf[^ *
+* width				: 摜̕()         *
+* stride			: 1s̃oCg              *
+* r					: a                         *
+* outline_hardness	: ֊s̍d                   *
+* blur				: {P                       *
+* alpha				: sx                     *
+* color				: F                           *
+***************************************************/
+static void GenerateCircleDab(
+	uint8* pixels,
+	int width,
+	int stride,
+	FLOAT_T r,
+	FLOAT_T outline_hardness,
+	FLOAT_T blur,
+	FLOAT_T alpha,
+	const uint8 color[3]
+)
+{
+	FLOAT_T blur_start = 1 - blur;
+	FLOAT_T div_r;
+	int i;
+
+	if(r < 0.5)
+	{
+		r = 0.5;
+	}
+	div_r = 1 / r;
+
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(width, stride, r, div_r, blur_start)
+#endif
+	for(i=0; i<width; i++)
+	{
+		uint8 *line = &pixels[i*stride];
+		FLOAT_T dy = i + 0.5 - r;
+		FLOAT_T dx, d, t, value, edge;
+		int a;
+		int j;
+
+		for(j=0; j<width; j++)
+		{
+			dx = j + 0.5 - r;
+			d = sqrt(dx*dx + dy*dy);
+			edge = r + 0.5 - d;
+			if(edge <= 0)
+			{
+				line[j*4] = line[j*4+1] = line[j*4+2] = line[j*4+3] = 0;
+				continue;
+			}
+			else if(edge > 1)
+			{
+				edge = 1;
+			}
+
+			// S̋ŕsx߂
+			t = d * div_r;
+			if(t <= blur_start)
+			{
+				value = alpha;
+			}
+			else if(t < 1)
+			{
+				value = alpha + (alpha * outline_hardness - alpha) * (t - blur_start) / blur;
+			}
+			else
+			{
+				value = alpha * outline_hardness;
+			}
+
+			a = (int)(value * edge * 255 + 0.5);
+			if(a > 255)
+			{
+				a = 255;
+			}
+			// CairõsNZf[^̓v}`vChAt@
+			line[j*4] = (uint8)((color[2] * a + 127) / 255);
+			line[j*4+1] = (uint8)((color[1] * a + 127) / 255);
+			line[j*4+2] = (uint8)((color[0] * a + 127) / 255);
+			line[j*4+3] = (uint8)a;
+		}
+	}
+}
+
+/*****************************************
+* ClearBrushDabCache֐                 *
+* LbV~`uV̉摜̂Ă *
+*                                    *
+* cache	: ~`uV̉摜̃LbV   *
+*****************************************/
+static void ClearBrushDabCache(BRUSH_DAB_CACHE* cache)
+{
+	int i;
+
+	for(i=0; i<cache->num_dabs; i++)
+	{
+		cairo_surface_destroy(cache->dabs[i].surface);
+		MEM_FREE_FUNC(cache->dabs[i].pixels);
+	}
+	cache->num_dabs = 0;
+	cache->total_size = 0;
+}
+
+/***************************************************
+* GetCachedCircleDab֐                           *
+* w肵ả~`uV̉摜LbV   *
+* 擾(΍쐬ăLbVɒǉ)   *
+*                                              *
+* cache	: ~`uV̉摜̃LbV             *
+* r		: `悷锼a                             *
+* dab_r	: LbV摜̔a󂯎ϐ   *
+* Ԃl                                           *
+*	~`uV̉摜(쐬łȂNULL)         *
+***************************************************/
+static BRUSH_DAB* GetCachedCircleDab(
+	BRUSH_DAB_CACHE* cache,
+	FLOAT_T r,
+	FLOAT_T* dab_r
+)
+{
+	BRUSH_DAB *dab;
+	FLOAT_T quantized_r;
+	int radius_key;
+	int hardness_key = (int)(cache->outline_hardness * 255 + 0.5);
+	int blur_key = (int)(cache->blur * 255 + 0.5);
+	int width, stride, data_size;
+	int i;
+
+	// a͈݂̍ŁA傫a͑ΐŗʎq
+	if(r <= 16)
+	{
+		radius_key = (int)(r * BRUSH_DAB_RADIUS_STEPS + 0.5);
+		if(radius_key < 1)
+		{
+			radius_key = 1;
+		}
+		quantized_r = (FLOAT_T)radius_key / BRUSH_DAB_RADIUS_STEPS;
+	}
+	else
+	{
+		radius_key = 16 * BRUSH_DAB_RADIUS_STEPS
+			+ (int)(log(r / 16) * 16 * BRUSH_DAB_RADIUS_STEPS + 0.5);
+		quantized_r = 16 * exp((FLOAT_T)(radius_key - 16 * BRUSH_DAB_RADIUS_STEPS)
+			/ (16 * BRUSH_DAB_RADIUS_STEPS));
+	}
+	*dab_r = quantized_r;
+
+	for(i=0; i<cache->num_dabs; i++)
+	{
+		dab = &cache->dabs[i];
+		if(dab->radius_key == radius_key && dab->hardness_key == hardness_key
+			&& dab->blur_key == blur_key)
+		{
+			dab->last_used = ++cache->counter;
+			return dab;
+		}
+	}
+
+	width = (int)(quantized_r * 2 + 1);
+	stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+	data_size = stride * width;
+	if(data_size > BRUSH_DAB_CACHE_MAX_BYTES)
+	{
+		return NULL;
+	}
+
+	// eʂ𒴂ȂłÂ摜̂Ă
+	while(cache->num_dabs > 0 && (cache->num_dabs >= BRUSH_DAB_CACHE_SIZE
+		|| cache->total_size + data_size > BRUSH_DAB_CACHE_MAX_BYTES))
+	{
+		int oldest = 0;
+		for(i=1; i<cache->num_dabs; i++)
+		{
+			if(cache->dabs[i].last_used < cache->dabs[oldest].last_used)
+			{
+				oldest = i;
+			}
+		}
+		cairo_surface_destroy(cache->dabs[oldest].surface);
+		MEM_FREE_FUNC(cache->dabs[oldest].pixels);
+		cache->total_size -= cache->dabs[oldest].data_size;
+		cache->num_dabs--;
+		cache->dabs[oldest] = cache->dabs[cache->num_dabs];
+	}
+
+	dab = &cache->dabs[cache->num_dabs];
+	dab->pixels = (uint8*)MEM_ALLOC_FUNC(data_size);
+	// mۂłȂ΃LbVg킸ɕ`悳
+	if(dab->pixels == NULL)
+	{
+		return NULL;
+	}
+	GenerateCircleDab(dab->pixels, width, stride, quantized_r,
+		cache->outline_hardness, cache->blur, cache->alpha, cache->color);
+	dab->surface = cairo_image_surface_create_for_data(dab->pixels,
+		CAIRO_FORMAT_ARGB32, width, width, stride);
+	dab->radius_key = radius_key;
+	dab->hardness_key = hardness_key;
+	dab->blur_key = blur_key;
+	dab->data_size = data_size;
+	dab->last_used = ++cache->counter;
+	cache->total_size += data_size;
+	cache->num_dabs++;
+
+	return dab;
+}
+
 /***************************************
 * BrushCoreSetCirclePattern֐        *
 * uV̉~`摜p^[쐬       *
@@ -58,9 +272,32 @@ void BrushCoreSetCirclePattern(
 	const uint8 color[3]
 )
 {
-	cairo_t *cairo_p;
-	cairo_pattern_t *radial_pattern;
-	FLOAT_T float_color[3] = {color[0] * DIV_PIXEL, color[1] * DIV_PIXEL, color[2] * DIV_PIXEL};
+	BRUSH_DAB_CACHE *cache;
+	int width = (int)(r*2+1);
+
+	// MŃTCYς鎞̂߂ɃLbV̐ݒXV
+	if(core->dab_cache == NULL)
+	{
+		core->dab_cache = (BRUSH_DAB_CACHE*)MEM_ALLOC_FUNC(sizeof(*core->dab_cache));
+		if(core->dab_cache != NULL)
+		{
+			(void)memset(core->dab_cache, 0, sizeof(*core->dab_cache));
+		}
+	}
+	// LbVȂΖ쐬摜ŕ`悷
+	if((cache = core->dab_cache) != NULL)
+	{
+		if(cache->alpha != alpha || cache->color[0] != color[0]
+			|| cache->color[1] != color[1] || cache->color[2] != color[2])
+		{
+			ClearBrushDabCache(cache);
+		}
+		cache->r = r;
+		cache->outline_hardness = outline_hardness;
+		cache->blur = blur;
+		cache->alpha = alpha;
+		cache->color[0] = color[0], cache->color[1] = color[1], cache->color[2] = color[2];
+	}
 
 	if(core->brush_pattern != NULL)
 	{
@@ -87,31 +324,19 @@ void BrushCoreSetCirclePattern(
 		cairo_destroy(core->temp_cairo);
 	}
 
+	// ˃Of[Vg킸ڃsNZf[^쐬
+	GenerateCircleDab(*core->brush_pattern_buff, width, width*4,
+		r, outline_hardness, blur, alpha, color);
 	core->brush_surface = cairo_image_surface_create_for_data(*core->brush_pattern_buff,
-		CAIRO_FORMAT_ARGB32, (int)(r*2+1), (int)(r*2+1), (int)(r*2+1)*4);
-	cairo_p = cairo_create(core->brush_surface);
-	cairo_set_operator(cairo_p, CAIRO_OPERATOR_SOURCE);
-	radial_pattern = cairo_pattern_create_radial(r, r, 0, r, r, r);
-	cairo_pattern_set_extend(radial_pattern, CAIRO_EXTEND_NONE);
-	cairo_pattern_add_color_stop_rgba(radial_pattern, 0, float_color[0],
-		float_color[1], float_color[2], alpha);
-	cairo_pattern_add_color_stop_rgba(radial_pattern, 1.0-blur, float_color[0],
-		float_color[1], float_color[2], alpha);
-	cairo_pattern_add_color_stop_rgba(radial_pattern, 1, float_color[0],
-		float_color[1], float_color[2], alpha * outline_hardness);
-	cairo_set_source(cairo_p, radial_pattern);
-	cairo_paint(cairo_p);
+		CAIRO_FORMAT_ARGB32, width, width, width*4);
 
 	core->temp_surface = cairo_image_surface_create_for_data(*core->temp_pattern_buff,
-		CAIRO_FORMAT_ARGB32, (int)(r*2+1), (int)(r*2+1), (int)(r*2+1)*4);
+		CAIRO_FORMAT_ARGB32, width, width, width*4);
 	core->temp_cairo = cairo_create(core->temp_surface);
 	cairo_set_operator(core->temp_cairo, CAIRO_OPERATOR_SOURCE);
 	core->temp_pattern = cairo_pattern_create_for_surface(core->temp_surface);
 
 	core->brush_pattern = cairo_pattern_create_for_surface(core->brush_surface);
-
-	cairo_pattern_destroy(radial_pattern);
-	cairo_destroy(cairo_p);
 }
 
 /***********************************************
@@ -138,6 +363,9 @@ void BrushCoreSetGrayCirclePattern(
 
 	core->stride = width + (4 - (width % 4)) % 4;
 
+	// O[XP[̃p^[ł̓J[̃LbV͎gȂ
+	ReleaseBrushDabCache(core);
+
 	if(core->brush_pattern != NULL)
 	{
 		cairo_pattern_destroy(core->brush_pattern);
@@ -188,131 +416,778 @@ void BrushCoreSetGrayCirclePattern(
 	cairo_destroy(cairo_p);
 }
 
-
-typedef struct _BRUSH_HISTORY_DATA
-{
-	int32 x, y;
-	int32 width, height;
-	int32 name_len;
-	gchar *layer_name;
-	uint8 *pixels;
-} BRUSH_HISTORY_DATA;
-
-void AddBrushHistory(
+/**************************************************************
+* BrushCoreSetCircleDabSource֐                             *
+* MŕωTCỶ~`uV\[Xɐݒ肷          *
+*                                                         *
+* core		: uV̊{                                *
+* cairo_p	: \[Xݒ肷Cairo                       *
+* zoom		: uV̉摜̊gk(̔a/`悷锼a) *
+**************************************************************/
+void BrushCoreSetCircleDabSource(
 	BRUSH_CORE* core,
-	LAYER* active
+	cairo_t* cairo_p,
+	FLOAT_T zoom
 )
 {
-	BRUSH_HISTORY_DATA data;
-	MEMORY_STREAM_PTR stream;
-	int i;
+	cairo_matrix_t matrix;
 
-	data.x = (int32)core->min_x - 1;
-	data.y = (int32)core->min_y - 1;
-	data.width = (int32)(core->max_x + 1.5 - core->min_x);
-	data.height = (int32)(core->max_y + 1.5 - core->min_y);
-	if(data.x < 0)
+	if(core->dab_cache != NULL && zoom != 1)
 	{
-		data.x = 0;
+		BRUSH_DAB *dab;
+		FLOAT_T r = core->dab_cache->r / zoom;
+		FLOAT_T dab_r;
+
+		if((dab = GetCachedCircleDab(core->dab_cache, r, &dab_r)) != NULL)
+		{
+			// LbV摜̒S`悷~̒Sɍ킹
+			cairo_set_source_surface(cairo_p, dab->surface, r - dab_r, r - dab_r);
+			return;
+		}
 	}
-	else if(data.x > active->width)
+
+	cairo_matrix_init_scale(&matrix, zoom, zoom);
+	cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+	cairo_set_source(cairo_p, core->brush_pattern);
+}
+
+/*****************************************
+* ReleaseBrushDabCache֐               *
+* ~`uV̉摜̃LbVJ *
+*                                    *
+* core	: uV̊{               *
+*****************************************/
+void ReleaseBrushDabCache(BRUSH_CORE* core)
+{
+	if(core->dab_cache == NULL)
 	{
 		return;
 	}
-	if(data.y < 0)
+
+	ClearBrushDabCache(core->dab_cache);
+	MEM_FREE_FUNC(core->dab_cache);
+	core->dab_cache = NULL;
+}
+
+/*****************************************
+* ClearBrushImageCache֐               *
+* LbV摜uV̉摜̂Ă *
+*                                    *
+* cache	: 摜uṼLbV         *
+*****************************************/
+static void ClearBrushImageCache(BRUSH_IMAGE_CACHE* cache)
+{
+	int i;
+
+	for(i=0; i<cache->num_images; i++)
 	{
-		data.y = 0;
+		cairo_pattern_destroy(cache->images[i].pattern);
+		cairo_surface_destroy(cache->images[i].surface);
+		MEM_FREE_FUNC(cache->images[i].pixels);
 	}
-	else if(data.y > active->height)
+	for(i=0; i<cache->num_levels; i++)
 	{
-		return;
+		cairo_surface_destroy(cache->levels[i]);
+		MEM_FREE_FUNC(cache->level_pixels[i]);
 	}
-	if (data.width < 0)
+	cache->num_images = 0;
+	cache->num_levels = 0;
+	cache->total_size = 0;
+	cache->source = NULL;
+}
+
+/********************************************
+* CreateBrushImageMipLevels֐             *
+* uV摜1/2k摜쐬 *
+*                                       *
+* cache	: 摜uṼLbV            *
+* source	: ̃uV摜                *
+********************************************/
+static void CreateBrushImageMipLevels(BRUSH_IMAGE_CACHE* cache, cairo_surface_t* source)
+{
+	cairo_surface_t *src_surface = source;
+	uint8 *src_pixels;
+	int src_width, src_height, src_stride;
+	int width, height, stride;
+	int level;
+
+	cache->source = source;
+	cache->levels[0] = cairo_surface_reference(source);
+	cache->level_pixels[0] = NULL;
+	cache->num_levels = 1;
+
+	cairo_surface_flush(source);
+	for(level=1; level<BRUSH_IMAGE_MAX_LEVELS; level++)
 	{
-		return;
+		int y;
+
+		src_pixels = cairo_image_surface_get_data(src_surface);
+		src_width = cairo_image_surface_get_width(src_surface);
+		src_height = cairo_image_surface_get_height(src_surface);
+		src_stride = cairo_image_surface_get_stride(src_surface);
+		if(src_width <= 1 && src_height <= 1)
+		{
+			break;
+		}
+
+		width = (src_width + 1) / 2;
+		height = (src_height + 1) / 2;
+		stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+		cache->level_pixels[level] = (uint8*)MEM_ALLOC_FUNC(stride * height);
+
+		// 2~2sNZ̕ςŏk([͍Ō̍sEJԂ)
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(width, src_width, src_height, src_stride, src_pixels, stride)
+#endif
+		for(y=0; y<height; y++)
+		{
+			uint8 *dst = &cache->level_pixels[level][y*stride];
+			uint8 *src0 = &src_pixels[(y*2)*src_stride];
+			uint8 *src1 = &src_pixels[MINIMUM(y*2+1, src_height-1)*src_stride];
+			int x, x0, x1, c;
+
+			for(x=0; x<width; x++)
+			{
+				x0 = x * 2 * 4;
+				x1 = MINIMUM(x*2+1, src_width-1) * 4;
+				for(c=0; c<4; c++)
+				{
+					dst[x*4+c] = (uint8)((src0[x0+c] + src0[x1+c] + src1[x0+c] + src1[x1+c] + 2) >> 2);
+				}
+			}
+		}
+
+		cache->levels[level] = cairo_image_surface_create_for_data(cache->level_pixels[level],
+			CAIRO_FORMAT_ARGB32, width, height, stride);
+		src_surface = cache->levels[level];
+		cache->num_levels++;
 	}
-	else if(data.x + data.width > active->width)
+}
+
+/********************************************************
+* GetBrushImageKey֐                                  *
+* g嗦Ɗpxgpk摜̒i              *
+* ʎq]p߂                              *
+*                                                   *
+* cache		: 摜uṼLbV                    *
+* zoom		: `1sNŽ摜̃sNZ *
+* angle		: 摜̊px                                *
+* level		: k摜̒i󂯎ϐ              *
+* angle_key	: ʎq]p󂯎ϐ            *
+********************************************************/
+static void GetBrushImageKey(
+	BRUSH_IMAGE_CACHE* cache,
+	FLOAT_T zoom,
+	FLOAT_T angle,
+	int* level,
+	int* angle_key
+)
+{
+	// `ւ̏k1`1/2Ɏ܂ȉk摜g
+	*level = 0;
+	while(*level + 1 < cache->num_levels && zoom >= (FLOAT_T)(2 << *level))
 	{
-		data.width = active->width - data.x;
+		(*level)++;
 	}
-	if(data.height < 0)
+
+	*angle_key = (int)floor(angle * BRUSH_IMAGE_ANGLE_STEPS / (2 * G_PI) + 0.5) % BRUSH_IMAGE_ANGLE_STEPS;
+	if(*angle_key < 0)
 	{
-		return;
+		*angle_key += BRUSH_IMAGE_ANGLE_STEPS;
 	}
-	else if(data.y + data.height > active->height)
+}
+
+/*******************************************
+* GetCachedBrushImage֐                  *
+* w肵iƊpx̉]ς݂̉摜     *
+* LbV擾(΍쐬) *
+*                                      *
+* cache		: 摜uṼLbV       *
+* level		: k摜̒i               *
+* angle_key	: ʎq]p             *
+* Ԃl                                   *
+*	]ς݂̉摜(쐬łȂNULL)   *
+*******************************************/
+static BRUSH_IMAGE* GetCachedBrushImage(
+	BRUSH_IMAGE_CACHE* cache,
+	int level,
+	int angle_key
+)
+{
+	BRUSH_IMAGE *image;
+	cairo_surface_t *surface;
+	cairo_pattern_t *pattern;
+	cairo_matrix_t matrix;
+	cairo_t *cairo_p;
+	FLOAT_T level_scale = 1.0 / (1 << level);
+	FLOAT_T quantized_angle = angle_key * (2 * G_PI) / BRUSH_IMAGE_ANGLE_STEPS;
+	FLOAT_T cos_value, sin_value;
+	int source_width = cairo_image_surface_get_width(cache->source);
+	int source_height = cairo_image_surface_get_height(cache->source);
+	int width, height, stride, data_size;
+	int i;
+
+	for(i=0; i<cache->num_images; i++)
 	{
-		data.height = active->height - data.y;
+		image = &cache->images[i];
+		if(image->level == level && image->angle_key == angle_key)
+		{
+			image->last_used = ++cache->counter;
+			return image;
+		}
 	}
-	data.name_len = (int32)strlen(active->name) + 1;
 
-	stream = CreateMemoryStream(
-		offsetof(BRUSH_HISTORY_DATA, layer_name)
-		+ data.name_len+data.height*data.width*active->channel);
-	(void)MemWrite(&data, offsetof(BRUSH_HISTORY_DATA, layer_name), 1, stream);
-	(void)MemWrite(active->name, 1, data.name_len, stream);
-	for(i=0; i<data.height; i++)
+	cos_value = fabs(cos(quantized_angle)),	sin_value = fabs(sin(quantized_angle));
+	width = (int)ceil((source_width * cos_value + source_height * sin_value) * level_scale) + 2;
+	height = (int)ceil((source_width * sin_value + source_height * cos_value) * level_scale) + 2;
+	stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+	data_size = stride * height;
+	if(data_size > BRUSH_IMAGE_CACHE_MAX_BYTES)
 	{
-		(void)MemWrite(&active->pixels[(data.y+i)*active->stride+data.x*active->channel],
-			1, data.width * active->channel, stream);
+		return NULL;
 	}
-	AddHistory(
-		&active->window->history,
-		core->name,
-		stream->buff_ptr,
-		(uint32)stream->data_size,
-		BrushCoreUndoRedo,
-		BrushCoreUndoRedo
+
+	// eʂ𒴂ȂłÂ摜̂Ă
+	while(cache->num_images > 0 && (cache->num_images >= BRUSH_IMAGE_CACHE_SIZE
+		|| cache->total_size + data_size > BRUSH_IMAGE_CACHE_MAX_BYTES))
+	{
+		int oldest = 0;
+		for(i=1; i<cache->num_images; i++)
+		{
+			if(cache->images[i].last_used < cache->images[oldest].last_used)
+			{
+				oldest = i;
+			}
+		}
+		cairo_pattern_destroy(cache->images[oldest].pattern);
+		cairo_surface_destroy(cache->images[oldest].surface);
+		MEM_FREE_FUNC(cache->images[oldest].pixels);
+		cache->total_size -= cache->images[oldest].data_size;
+		cache->num_images--;
+		cache->images[oldest] = cache->images[cache->num_images];
+	}
+
+	image = &cache->images[cache->num_images];
+	image->pixels = (uint8*)MEM_ALLOC_FUNC(data_size);
+	(void)memset(image->pixels, 0, data_size);
+	image->surface = cairo_image_surface_create_for_data(image->pixels,
+		CAIRO_FORMAT_ARGB32, width, height, stride);
+
+	// ]̉摜̒S̉摜̒SɂȂ悤ɏk摜]ĕ`
+	surface = cache->levels[level];
+	pattern = cairo_pattern_create_for_surface(surface);
+	cairo_pattern_set_extend(pattern, CAIRO_EXTEND_NONE);
+	cairo_pattern_set_filter(pattern, CAIRO_FILTER_BILINEAR);
+	cairo_matrix_init_scale(&matrix,
+		(FLOAT_T)cairo_image_surface_get_width(surface) / source_width,
+		(FLOAT_T)cairo_image_surface_get_height(surface) / source_height
 	);
-	(void)DeleteMemoryStream(stream);
+	cairo_matrix_translate(&matrix, source_width * 0.5, source_height * 0.5);
+	cairo_matrix_rotate(&matrix, quantized_angle);
+	cairo_matrix_scale(&matrix, 1 / level_scale, 1 / level_scale);
+	cairo_matrix_translate(&matrix, - width * 0.5, - height * 0.5);
+	cairo_pattern_set_matrix(pattern, &matrix);
+	cairo_p = cairo_create(image->surface);
+	cairo_set_source(cairo_p, pattern);
+	cairo_paint(cairo_p);
+	cairo_destroy(cairo_p);
+	cairo_pattern_destroy(pattern);
+	cairo_surface_flush(image->surface);
+
+	image->pattern = cairo_pattern_create_for_surface(image->surface);
+	cairo_pattern_set_extend(image->pattern, CAIRO_EXTEND_NONE);
+	cairo_pattern_set_filter(image->pattern, CAIRO_FILTER_BILINEAR);
+	image->level = level;
+	image->angle_key = angle_key;
+	image->data_size = data_size;
+	image->last_used = ++cache->counter;
+	cache->total_size += data_size;
+	cache->num_images++;
+
+	return image;
 }
 
-void BrushCoreUndoRedo(DRAW_WINDOW* window, void* p)
+/*********************************************
+* PrepareBrushImageCache֐                 *
+* 摜uṼLbVgԂɂ   *
+*                                        *
+* core		: uV̊{               *
+* source	: LbV錳̉摜         *
+* Ԃl                                     *
+*	摜uṼLbV(gȂNULL) *
+*********************************************/
+static BRUSH_IMAGE_CACHE* PrepareBrushImageCache(BRUSH_CORE* core, cairo_surface_t* source)
 {
-	BRUSH_HISTORY_DATA data;
-	LAYER* layer = window->layer;
-	uint8* buff = (uint8*)p;
-	uint8* before_data;
-	int i;
-
-	(void)memcpy(&data, buff, offsetof(BRUSH_HISTORY_DATA, layer_name));
-	buff += offsetof(BRUSH_HISTORY_DATA, layer_name);
-	data.layer_name = (gchar*)buff;
-	buff += data.name_len;
-	data.pixels = buff;
+	if(source == NULL
+		|| cairo_surface_get_type(source) != CAIRO_SURFACE_TYPE_IMAGE
+		|| cairo_image_surface_get_format(source) != CAIRO_FORMAT_ARGB32)
+	{
+		return NULL;
+	}
 
-	while(strcmp(layer->name, data.layer_name) != 0)
+	if(core->image_cache == NULL)
+	{
+		core->image_cache = (BRUSH_IMAGE_CACHE*)MEM_ALLOC_FUNC(sizeof(*core->image_cache));
+		(void)memset(core->image_cache, 0, sizeof(*core->image_cache));
+	}
+	// uV̉摜蒼Ăk摜蒼
+	if(core->image_cache->source != source)
 	{
-		layer = layer->next;
+		ClearBrushImageCache(core->image_cache);
+		CreateBrushImageMipLevels(core->image_cache, source);
 	}
 
-	before_data = (uint8*)MEM_ALLOC_FUNC(data.height*data.width*layer->channel);
-	for(i=0; i<data.height; i++)
+	return core->image_cache;
+}
+
+/********************************************************
+* SetCachedImageSource֐                              *
+* LbV]ς݂̉摜\[Xɐݒ肷        *
+*                                                   *
+* core		: uV̊{                          *
+* source	: LbV錳̉摜                    *
+* cairo_p	: \[Xݒ肷Cairo                 *
+* zoom		: `1sNŽ摜̃sNZ *
+* angle		: 摜̊px                                *
+* center_x	: 摜̒SuXW                     *
+* center_y	: 摜̒SuYW                     *
+* Ԃl                                                *
+*	ݒłTRUEAłȂFALSE                 *
+********************************************************/
+static int SetCachedImageSource(
+	BRUSH_CORE* core,
+	cairo_surface_t* source,
+	cairo_t* cairo_p,
+	FLOAT_T zoom,
+	FLOAT_T angle,
+	FLOAT_T center_x,
+	FLOAT_T center_y
+)
+{
+	BRUSH_IMAGE_CACHE *cache;
+	BRUSH_IMAGE *image;
+	cairo_matrix_t matrix;
+	FLOAT_T image_zoom;
+	int level, angle_key;
+
+	if((cache = PrepareBrushImageCache(core, source)) == NULL)
 	{
-		(void)memcpy(&before_data[i*data.width*layer->channel],
-			&layer->pixels[(data.y+i)*layer->stride+data.x*layer->channel],
-			data.width*layer->channel);
+		return FALSE;
 	}
 
-	for(i=0; i<data.height; i++)
+	GetBrushImageKey(cache, zoom, angle, &level, &angle_key);
+	if((image = GetCachedBrushImage(cache, level, angle_key)) == NULL)
 	{
-		(void)memcpy(&layer->pixels[(data.y+i)*layer->stride+data.x*layer->channel],
-			&data.pixels[i*data.width*layer->channel], data.width*layer->channel);
+		return FALSE;
 	}
 
-	(void)memcpy(data.pixels, before_data, data.height*data.width*layer->channel);
+	// ]ς݂̉摜̒SwWɍ킹ĊgEk̂ݍs
+	image_zoom = zoom / (1 << image->level);
+	cairo_matrix_init_scale(&matrix, image_zoom, image_zoom);
+	cairo_matrix_translate(&matrix,
+		cairo_image_surface_get_width(image->surface) * 0.5 / image_zoom - center_x,
+		cairo_image_surface_get_height(image->surface) * 0.5 / image_zoom - center_y
+	);
+	cairo_pattern_set_matrix(image->pattern, &matrix);
+	cairo_set_source(cairo_p, image->pattern);
 
-	MEM_FREE_FUNC(before_data);
+	return TRUE;
 }
 
-typedef struct _EDIT_SELECTION_DATA
+/********************************************************
+* SetBrushImageSource֐                               *
+* LbV]ς݂̉摜\[Xɐݒ肷        *
+*                                                   *
+* core		: uV̊{                          *
+* cairo_p	: \[Xݒ肷Cairo                 *
+* zoom		: `1sNŽ摜̃sNZ *
+* angle		: 摜̊px                                *
+* size		: `͈͂̒S܂ł̋                  *
+* Ԃl                                                *
+*	ݒłTRUEAłȂFALSE                 *
+********************************************************/
+static int SetBrushImageSource(
+	BRUSH_CORE* core,
+	cairo_t* cairo_p,
+	FLOAT_T zoom,
+	FLOAT_T angle,
+	FLOAT_T size
+)
 {
-	int32 x, y;
-	int32 width, height;
-	uint8 *pixels;
-} EDIT_SELECTION_DATA;
+	return SetCachedImageSource(core, core->brush_surface, cairo_p, zoom, angle, size, size);
+}
 
-void EditSelectionUndoRedo(DRAW_WINDOW* window, void* p)
-{
+/************************************************************
+* SetStampImageSource֐                                   *
+* X^vnc[̉摜LbV]ς݂̉摜  *
+* \[Xɐݒ肷(̊gkE]̑Ɏg)      *
+*                                                       *
+* core		: uV̊{                              *
+* source	: X^v̉摜                                *
+* cairo_p	: \[Xݒ肷Cairo                     *
+* zoom		: `1sNŽ摜̃sNZ     *
+* angle		: 摜̊px                                    *
+* trans_x	: ]Ỏ摜̍uXW                 *
+* trans_y	: ]Ỏ摜̍uYW                 *
+* Ԃl                                                    *
+*	ݒłTRUEAłȂFALSE                     *
+************************************************************/
+int SetStampImageSource(
+	BRUSH_CORE* core,
+	cairo_surface_t* source,
+	cairo_t* cairo_p,
+	FLOAT_T zoom,
+	FLOAT_T angle,
+	FLOAT_T trans_x,
+	FLOAT_T trans_y
+)
+{
+	FLOAT_T half_width, half_height;
+	FLOAT_T cos_value = cos(angle), sin_value = sin(angle);
+
+	if(source == NULL || zoom <= 0)
+	{
+		return FALSE;
+	}
+
+	// gkE]̍sŉ摜̒SڂW߂
+	half_width = cairo_image_surface_get_width(source) * 0.5 / zoom;
+	half_height = cairo_image_surface_get_height(source) * 0.5 / zoom;
+
+	return SetCachedImageSource(core, source, cairo_p, zoom, angle,
+		trans_x + half_width * cos_value + half_height * sin_value,
+		trans_y - half_width * sin_value + half_height * cos_value
+	);
+}
+
+/***********************************
+* ReleaseBrushImageCache֐       *
+* 摜uṼLbVJ *
+*                              *
+* core	: uV̊{         *
+***********************************/
+void ReleaseBrushImageCache(BRUSH_CORE* core)
+{
+	if(core->image_cache == NULL)
+	{
+		return;
+	}
+
+	ClearBrushImageCache(core->image_cache);
+	MEM_FREE_FUNC(core->image_cache);
+	core->image_cache = NULL;
+}
+
+
+// ^CPʂŕۑuV̗̊e^C̏
+typedef struct _BRUSH_TILE_HISTORY_TILE
+{
+	int32 x, y;
+	int32 width, height;
+} BRUSH_TILE_HISTORY_TILE;
+
+typedef struct _BRUSH_TILE_HISTORY_DATA
+{
+	int32 num_tiles;
+	int32 name_len;
+	uint32 layer_id;
+	gchar *layer_name;
+	// ȍ~̓^CBRUSH_TILE_HISTORY_TILEƃsNZf[^
+} BRUSH_TILE_HISTORY_DATA;
+
+/*****************************************
+* IsWorkLayerTileTransparent֐         *
+* ƃC[̃^CSēׂ *
+*                                    *
+* work	: ƃC[                   *
+* rect	: ^C͈̔                   *
+* Ԃl                                 *
+*	Sē:TRUE	`悳Ă:FALSE *
+*****************************************/
+static int IsWorkLayerTileTransparent(LAYER* work, UPDATE_RECTANGLE* rect)
+{
+	int start_x = (int)rect->x, start_y = (int)rect->y;
+	int width = (int)rect->width, height = (int)rect->height;
+	uint8 *pixels;
+	int i, j;
+
+	for(i=0; i<height; i++)
+	{
+		pixels = &work->pixels[(start_y+i)*work->stride+start_x*work->channel];
+		for(j=0; j<width; j++, pixels += work->channel)
+		{
+			if(pixels[3] != 0)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+/*******************************************************
+* BrushTileUndoRedo֐                                *
+* ^CPʂŕۑuV̗ɖ߂E蒼 *
+*                                                  *
+* window	: LoX̏                         *
+* p		: f[^                                   *
+*******************************************************/
+static void BrushTileUndoRedo(DRAW_WINDOW* window, void* p)
+{
+	BRUSH_TILE_HISTORY_DATA data;
+	BRUSH_TILE_HISTORY_TILE tile;
+	LAYER *layer;
+	uint8 *buff = (uint8*)p;
+	uint8 *row, *swap;
+	int row_size;
+	int i, j;
+
+	(void)memcpy(&data, buff, offsetof(BRUSH_TILE_HISTORY_DATA, layer_name));
+	buff += offsetof(BRUSH_TILE_HISTORY_DATA, layer_name);
+	data.layer_name = (gchar*)buff;
+	buff += data.name_len;
+
+	layer = SearchLayerByIDAndName(window, data.layer_id, data.layer_name);
+
+	swap = (uint8*)MEM_ALLOC_FUNC(UPDATE_TILE_SIZE * layer->channel);
+	for(i=0; i<data.num_tiles; i++)
+	{
+		(void)memcpy(&tile, buff, sizeof(tile));
+		buff += sizeof(tile);
+		row_size = tile.width * layer->channel;
+
+		// ̃sNZf[^ƃC[̃sNZf[^ւ
+		for(j=0; j<tile.height; j++, buff += row_size)
+		{
+			row = &layer->pixels[(tile.y+j)*layer->stride+tile.x*layer->channel];
+			(void)memcpy(swap, row, row_size);
+			(void)memcpy(row, buff, row_size);
+			(void)memcpy(buff, swap, row_size);
+		}
+	}
+
+	MEM_FREE_FUNC(swap);
+}
+
+/*************************************************************
+* AddBrushTileHistory֐                                    *
+* Xg[Nŕ`悵^Ĉ݂uV̗Ƃĕۑ *
+*                                                        *
+* core	: uV̊{                                   *
+* active	: ANeBuȃC[                           *
+* Ԃl                                                     *
+*	I:0	s:̒l(^CPʂŕۑłȂ)        *
+*************************************************************/
+static int AddBrushTileHistory(BRUSH_CORE* core, LAYER* active)
+{
+	DRAW_WINDOW *window = active->window;
+	UPDATE_TILES *tiles = &window->work_tiles;
+	BRUSH_TILE_HISTORY_DATA data;
+	BRUSH_TILE_HISTORY_TILE *tile_rects;
+	UPDATE_RECTANGLE rect;
+	MEMORY_STREAM_PTR stream;
+	size_t data_size;
+	int i, j, k;
+
+	// ȕʂɉe鍇@ł͕`悵ĂȂ^Cω
+	if((window->flags & DRAW_WINDOW_TRACK_WORK_TILES) == 0
+		|| window->work_layer->layer_mode >= LAYER_BLEND_SLELECTABLE_NUM
+		|| tiles->num_dirty <= 0)
+	{
+		return -1;
+	}
+
+	// ƃC[Ȃ܂܂̃^C͍ĂωȂ̂ŏ
+	tile_rects = (BRUSH_TILE_HISTORY_TILE*)MEM_ALLOC_FUNC(sizeof(*tile_rects) * tiles->num_dirty);
+	data.num_tiles = 0;
+	data_size = 0;
+	for(i=tiles->min_y; i<=tiles->max_y; i++)
+	{
+		for(j=tiles->min_x; j<=tiles->max_x; j++)
+		{
+			if(tiles->dirty[i*tiles->num_x+j] == 0)
+			{
+				continue;
+			}
+
+			rect.x = j * UPDATE_TILE_SIZE;
+			rect.y = i * UPDATE_TILE_SIZE;
+			rect.width = MINIMUM((j + 1) * UPDATE_TILE_SIZE, active->width) - rect.x;
+			rect.height = MINIMUM((i + 1) * UPDATE_TILE_SIZE, active->height) - rect.y;
+			if(IsWorkLayerTileTransparent(window->work_layer, &rect) != FALSE)
+			{
+				continue;
+			}
+
+			tile_rects[data.num_tiles].x = (int32)rect.x;
+			tile_rects[data.num_tiles].y = (int32)rect.y;
+			tile_rects[data.num_tiles].width = (int32)rect.width;
+			tile_rects[data.num_tiles].height = (int32)rect.height;
+			data_size += sizeof(*tile_rects)
+				+ tile_rects[data.num_tiles].width * tile_rects[data.num_tiles].height * active->channel;
+			data.num_tiles++;
+		}
+	}
+	data.name_len = (int32)strlen(active->name) + 1;
+	data.layer_id = active->id;
+	data_size += offsetof(BRUSH_TILE_HISTORY_DATA, layer_name) + data.name_len;
+
+	stream = CreateMemoryStream(data_size);
+	(void)MemWrite(&data, offsetof(BRUSH_TILE_HISTORY_DATA, layer_name), 1, stream);
+	(void)MemWrite(active->name, 1, data.name_len, stream);
+	for(i=0; i<data.num_tiles; i++)
+	{
+		(void)MemWrite(&tile_rects[i], sizeof(*tile_rects), 1, stream);
+		for(k=0; k<tile_rects[i].height; k++)
+		{
+			(void)MemWrite(&active->pixels[(tile_rects[i].y+k)*active->stride+tile_rects[i].x*active->channel],
+				1, tile_rects[i].width * active->channel, stream);
+		}
+	}
+	AddHistory(
+		&window->history,
+		core->name,
+		stream->buff_ptr,
+		(uint32)data_size,
+		BrushTileUndoRedo,
+		BrushTileUndoRedo
+	);
+	(void)DeleteMemoryStream(stream);
+	MEM_FREE_FUNC(tile_rects);
+
+	return 0;
+}
+
+typedef struct _BRUSH_HISTORY_DATA
+{
+	int32 x, y;
+	int32 width, height;
+	int32 name_len;
+	uint32 layer_id;
+	gchar *layer_name;
+	uint8 *pixels;
+} BRUSH_HISTORY_DATA;
+
+void AddBrushHistory(
+	BRUSH_CORE* core,
+	LAYER* active
+)
+{
+	BRUSH_HISTORY_DATA data;
+	MEMORY_STREAM_PTR stream;
+	int i;
+
+	// `悵^CL^Ă΃^CPʂŕۑ
+	if(AddBrushTileHistory(core, active) == 0)
+	{
+		return;
+	}
+
+	data.x = (int32)core->min_x - 1;
+	data.y = (int32)core->min_y - 1;
+	data.width = (int32)(core->max_x + 1.5 - core->min_x);
+	data.height = (int32)(core->max_y + 1.5 - core->min_y);
+	if(data.x < 0)
+	{
+		data.x = 0;
+	}
+	else if(data.x > active->width)
+	{
+		return;
+	}
+	if(data.y < 0)
+	{
+		data.y = 0;
+	}
+	else if(data.y > active->height)
+	{
+		return;
+	}
+	if (data.width < 0)
+	{
+		return;
+	}
+	else if(data.x + data.width > active->width)
+	{
+		data.width = active->width - data.x;
+	}
+	if(data.height < 0)
+	{
+		return;
+	}
+	else if(data.y + data.height > active->height)
+	{
+		data.height = active->height - data.y;
+	}
+	data.name_len = (int32)strlen(active->name) + 1;
+	data.layer_id = active->id;
+
+	stream = CreateMemoryStream(
+		offsetof(BRUSH_HISTORY_DATA, layer_name)
+		+ data.name_len+data.height*data.width*active->channel);
+	(void)MemWrite(&data, offsetof(BRUSH_HISTORY_DATA, layer_name), 1, stream);
+	(void)MemWrite(active->name, 1, data.name_len, stream);
+	for(i=0; i<data.height; i++)
+	{
+		(void)MemWrite(&active->pixels[(data.y+i)*active->stride+data.x*active->channel],
+			1, data.width * active->channel, stream);
+	}
+	AddHistory(
+		&active->window->history,
+		core->name,
+		stream->buff_ptr,
+		(uint32)stream->data_size,
+		BrushCoreUndoRedo,
+		BrushCoreUndoRedo
+	);
+	(void)DeleteMemoryStream(stream);
+}
+
+void BrushCoreUndoRedo(DRAW_WINDOW* window, void* p)
+{
+	BRUSH_HISTORY_DATA data;
+	LAYER* layer;
+	uint8* buff = (uint8*)p;
+	uint8* before_data;
+	int i;
+
+	(void)memcpy(&data, buff, offsetof(BRUSH_HISTORY_DATA, layer_name));
+	buff += offsetof(BRUSH_HISTORY_DATA, layer_name);
+	data.layer_name = (gchar*)buff;
+	buff += data.name_len;
+	data.pixels = buff;
+
+	layer = SearchLayerByIDAndName(window, data.layer_id, data.layer_name);
+
+	before_data = (uint8*)MEM_ALLOC_FUNC(data.height*data.width*layer->channel);
+	for(i=0; i<data.height; i++)
+	{
+		(void)memcpy(&before_data[i*data.width*layer->channel],
+			&layer->pixels[(data.y+i)*layer->stride+data.x*layer->channel],
+			data.width*layer->channel);
+	}
+
+	for(i=0; i<data.height; i++)
+	{
+		(void)memcpy(&layer->pixels[(data.y+i)*layer->stride+data.x*layer->channel],
+			&data.pixels[i*data.width*layer->channel], data.width*layer->channel);
+	}
+
+	(void)memcpy(data.pixels, before_data, data.height*data.width*layer->channel);
+
+	MEM_FREE_FUNC(before_data);
+}
+
+typedef struct _EDIT_SELECTION_DATA
+{
+	int32 x, y;
+	int32 width, height;
+	uint8 *pixels;
+} EDIT_SELECTION_DATA;
+
+void EditSelectionUndoRedo(DRAW_WINDOW* window, void* p)
+{
 	EDIT_SELECTION_DATA *data = (EDIT_SELECTION_DATA*)p;
 	uint8 *buff = (uint8*)p;
 	uint8 *pixels, *src, *before_data;
@@ -395,6 +1270,109 @@ void AddSelectionEditHistory(BRUSH_CORE* core, LAYER* selection)
 	MEM_FREE_FUNC(buff);
 }
 
+/*****************************************************
+* ApplyBrushMaskLayers֐                           *
+* uV̕`挋ʂɑÍ͈AeNX`A           *
+* sی̃}XN1ł܂Ƃ߂Ċ|            *
+*                                                *
+* window	: LoX̏                       *
+* pixels	: uV̕`挋ʂ̓sNZf[^ *
+* x		: `͈͂̍XW                      *
+* y		: `͈͂̍YW                      *
+* width	: `͈͂̕                               *
+* height	: `͈͂̍                         *
+*****************************************************/
+static void ApplyBrushMaskLayers(
+	DRAW_WINDOW* window,
+	uint8* pixels,
+	gdouble x,
+	gdouble y,
+	gdouble width,
+	gdouble height
+)
+{
+	uint8 *selection_pixels = NULL;
+	uint8 *lock_pixels = NULL;
+	uint8 *texture_pixels = NULL;
+	int stride = window->mask_temp->stride;
+	int layer_stride = window->active_layer->stride;
+	int mask_stride = window->selection->stride;
+	int start_x = (int)x,	start_y = (int)y;
+	int end_x = (int)ceil(x + width),	end_y = (int)ceil(y + height);
+	int i;
+
+	if(start_x < 0)
+	{
+		start_x = 0;
+	}
+	if(start_y < 0)
+	{
+		start_y = 0;
+	}
+	if(end_x > window->width)
+	{
+		end_x = window->width;
+	}
+	if(end_y > window->height)
+	{
+		end_y = window->height;
+	}
+
+	if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) != 0)
+	{
+		selection_pixels = window->selection->pixels;
+	}
+	if((window->active_layer->flags & LAYER_LOCK_OPACITY) != 0)
+	{
+		lock_pixels = window->active_layer->pixels;
+	}
+	if(window->app->textures.active_texture != 0)
+	{
+		texture_pixels = window->texture->pixels;
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(selection_pixels, lock_pixels, texture_pixels, \
+	stride, layer_stride, mask_stride, start_x, end_x)
+#endif
+	for(i=start_y; i<end_y; i++)
+	{
+		uint8 *pix = &pixels[i*stride+start_x*4];
+		int mask;
+		int j;
+
+		for(j=start_x; j<end_x; j++, pix+=4)
+		{
+			if(pix[3] == 0)
+			{
+				continue;
+			}
+
+			mask = 255;
+			if(selection_pixels != NULL)
+			{
+				mask = mask * selection_pixels[i*mask_stride+j] / 255;
+			}
+			if(texture_pixels != NULL)
+			{
+				mask = mask * texture_pixels[i*mask_stride+j] / 255;
+			}
+			if(lock_pixels != NULL)
+			{
+				mask = mask * lock_pixels[i*layer_stride+j*4+3] / 255;
+			}
+
+			if(mask < 255)
+			{
+				pix[0] = (uint8)((pix[0] * mask + 127) / 255);
+				pix[1] = (uint8)((pix[1] * mask + 127) / 255);
+				pix[2] = (uint8)((pix[2] * mask + 127) / 255);
+				pix[3] = (uint8)((pix[3] * mask + 127) / 255);
+			}
+		}
+	}
+}
+
 /*****************************************************
 * DrawCircleBrush֐                                *
 * uV}XNC[ɕ`悷                   *
@@ -436,230 +1414,30 @@ void DrawCircleBrush(
 	// forp̃JE^
 	int i;
 
-	// `pCairo쐬
-	update_surface = cairo_surface_create_for_rectangle(
-		window->mask_temp->surface_p, x, y,
-			width, height);
-	update = cairo_create(update_surface);
+	core->num_dabs++;
 
-	*mask = window->mask_temp->pixels;
-	if(window->app->textures.active_texture == 0)
-	{	// eNX`	
-		if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
-		{	// I͈͖
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// uṼTCYݒ肵ĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(update, core->brush_pattern);
-				cairo_paint_with_alpha(update, alpha);
-			}
-			else
-			{	// sیL
-					// uṼTCYݒ肵
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				// xAꎞۑ̈ɕ`
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `悷ʒuZbg
-				cairo_matrix_init_translate(&matrix, 0,0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				// `挋ʂg
-				cairo_set_source(update, core->temp_pattern);
-				// ANeBuȃC[Ń}XN
-				cairo_mask_surface(update,
-					window->active_layer->surface_p, - x, - y);
-			}
-		}
-		else
-		{	// I͈͗L
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// uṼTCYݒ肵
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				// xꎞۑ̈ɕ`
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `悷ʒuZbg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				// `挋ʂg
-				cairo_set_source(update, core->temp_pattern);
-				// I͈͂Ń}XN
-				cairo_mask_surface(window->mask_temp->cairo_p,
-					window->selection->surface_p, - x, - y);
-			}
-			else
-			{
-				// I͈͗L
-					// ANeBuȃC[ƑI͈͂Ń}XN
-				// `pɈꎞICairo쐬
-				cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-					window->temp_layer->surface_p, x, y, width, height);
-				cairo_t *update_temp = cairo_create(temp_surface);
-
-				// ܂͈ꎞۑC[ɑI͈͂Ń}XNĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-
-				// `OɃsNZf[^Ă
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
-				}
-
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-				cairo_set_source_surface(update_temp,
-					update_surface, 0, 0);
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
-
-				// gp}XNύX
-				*mask = window->temp_layer->pixels;
-
-				// ꎞIɍ쐬Cairoj
-				cairo_surface_destroy(temp_surface);
-				cairo_destroy(update_temp);
-			}
-		}
-	}
-	else
-	{	// eNX`L
-			// ꎞۑpCairo쐬
-		cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-			window->temp_layer->surface_p, x, y, width, height);
-		cairo_t *update_temp = cairo_create(temp_surface);
-
-		// `OɈꎞۑC[̃sNZf[^
-		for(i=0; i<height; i++)
-		{
-			(void)memset(&window->temp_layer->pixels[
-				(i+start_y)*window->temp_layer->stride+start_x*4],
-				0, stride
-			);
-		}
-
-		if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
-		{	// I͈͖
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// gEkAsxݒ肵ĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(update_temp, core->brush_pattern);
-				cairo_paint_with_alpha(update_temp, alpha);
-			}
-			else
-			{	// sیL
-					// ANeBuȃC[Ń}XNĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update_temp, core->temp_pattern);
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
-			}
-
-			cairo_set_source_surface(update, temp_surface, 0, 0);
-			cairo_mask_surface(update, window->texture->surface_p, - x, - y);
-
-			*mask = window->temp_layer->pixels;
-		}
-		else
-		{	// I͈͗L
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// I͈͂ƃeNX`Ń}XN
-				// ܂͈ꎞۑ̈ɕsxw肵ĕ`悵Ă
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `挋ʂg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-				// I͈͂Ń}XN
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-
-				// ꎞۑ̈̃sNZf[^xZbg
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
-				}
-
-				// eNX`Ń}XNĕ`
-				cairo_set_source_surface(update_temp, update_surface, 0, 0);
-				cairo_mask_surface(update_temp, window->texture->surface_p, - x, - y);
-			}
-			else
-			{	// sیL
-					// Í͈AeNX`AANeBuȃC[Ń}XN
-				// ܂͕sxݒ肵ĕ`悵Ă
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `挋ʂg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-
-				// `OɈꎞۑ̈̃sNZf[^
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
-				}
-
-				// I͈͂Ń}XN
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-				cairo_set_source_surface(update_temp,
-					update_surface, 0, 0);
-				// ANeBuȃC[Ń}XN
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
-
-				// 2߂̈ꎞۑ̈̃sNZf[^
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->mask_temp->pixels[
-						(i+start_y)*window->mask_temp->stride+start_x*4],
-						0, stride
-					);
-				}
+	// `pCairo쐬
+	update_surface = cairo_surface_create_for_rectangle(
+		window->mask_temp->surface_p, x, y,
+			width, height);
+	update = cairo_create(update_surface);
 
-				// eNX`Ń}XNĕ`
-				cairo_set_source_surface(update, temp_surface, 0, 0);
-				cairo_mask_surface(update, window->texture->surface_p, - x, - y);
-			}
-		}
+	*mask = window->mask_temp->pixels;
+	// O̕`挋ʂĂuṼTCYݒ肵ĕ`
+	cairo_set_operator(update, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(update);
+	cairo_set_operator(update, CAIRO_OPERATOR_OVER);
+	cairo_matrix_init_scale(&matrix, zoom, zoom);
+	cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+	cairo_set_source(update, core->brush_pattern);
+	cairo_paint_with_alpha(update, alpha);
 
-		// ꎞIɍ쐬Cairoj
-		cairo_surface_destroy(temp_surface);
-		cairo_destroy(update_temp);
+	if(window->app->textures.active_texture != 0
+		|| (window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) != 0
+		|| (window->active_layer->flags & LAYER_LOCK_OPACITY) != 0)
+	{	// Í͈AeNX`Asی̃}XN͂܂Ƃ߂Ċ|
+		cairo_surface_flush(update_surface);
+		ApplyBrushMaskLayers(window, *mask, x, y, width, height);
 	}
 
 	// XVpɍ쐬Cairoj
@@ -741,258 +1519,714 @@ void DrawCircleBrushWorkLayer(
 	cairo_surface_t *update_surface;
 	// `掞̊gEkAʒuݒp
 	cairo_matrix_t matrix;
-	// 摜s̃oCg
-	int stride = (int)width * 4;
-	// sNZf[^ZbgW
-	int start_x = (int)x, start_y = (int)y;
-	// forp̃JE^
+
+	core->num_dabs++;
+
+	// `pCairo쐬
+	update_surface = cairo_surface_create_for_rectangle(
+		window->mask_temp->surface_p, x, y,
+			width, height);
+	update = cairo_create(update_surface);
+
+	*mask = window->mask_temp->pixels;
+	// O̕`挋ʂĂuṼTCYݒ肵ĕ`
+	cairo_set_operator(update, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(update);
+	cairo_set_operator(update, CAIRO_OPERATOR_OVER);
+	cairo_matrix_init_scale(&matrix, zoom, zoom);
+	cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+	cairo_set_source(update, core->brush_pattern);
+	cairo_paint_with_alpha(update, alpha);
+
+	if(window->app->textures.active_texture != 0
+		|| (window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) != 0
+		|| (window->active_layer->flags & LAYER_LOCK_OPACITY) != 0)
+	{	// Í͈AeNX`Asی̃}XN͂܂Ƃ߂Ċ|
+		cairo_surface_flush(update_surface);
+		ApplyBrushMaskLayers(window, *mask, x, y, width, height);
+	}
+
+	// XVpɍ쐬Cairoj
+	cairo_surface_destroy(update_surface);
+	cairo_destroy(update);
+}
+
+/*******************************************************
+* BeginWorkLayerTiles֐                              *
+* ƃC[̕`͈͂̃^CPʂł̋L^Jn *
+* (uṼ{^̃R[obN֐ŌĂ)   *
+*                                                  *
+* window	: LoX̏                         *
+*******************************************************/
+void BeginWorkLayerTiles(DRAW_WINDOW* window)
+{
+	window->flags |= DRAW_WINDOW_TRACK_WORK_TILES;
+}
+
+/***********************************************
+* AddWorkLayerTiles֐                        *
+* ƃC[ɕ`悵͈͂̃^CL^ *
+*                                          *
+* window	: LoX̏                 *
+* x		: `͈͂̍XW                *
+* y		: `͈͂̍YW                *
+* width	: `͈͂̕                         *
+* height	: `͈͂̍                   *
+***********************************************/
+void AddWorkLayerTiles(
+	DRAW_WINDOW* window,
+	int x,
+	int y,
+	int width,
+	int height
+)
+{
+	if((window->flags & DRAW_WINDOW_TRACK_WORK_TILES) != 0)
+	{
+		AddUpdateTiles(&window->work_tiles, x, y, width, height);
+	}
+}
+
+/*****************************************
+* ClearWorkLayerRectangle֐            *
+* ƃC[̎w͈݂͂̂   *
+*                                    *
+* window	: LoX̏           *
+* rect		: ͈               *
+*****************************************/
+static void ClearWorkLayerRectangle(DRAW_WINDOW* window, UPDATE_RECTANGLE* rect)
+{
+	LAYER *work = window->work_layer;
+	int start_x = (int)rect->x, start_y = (int)rect->y;
+	int width = (int)rect->width, height = (int)rect->height;
 	int i;
 
+	for(i=0; i<height; i++)
+	{
+		(void)memset(&work->pixels[(start_y+i)*work->stride+start_x*work->channel],
+			0, width * work->channel);
+	}
+}
+
+/***************************************************************
+* CommitWorkLayerTiles֐                                     *
+* ƃC[̕`悵^Ĉ݂C[ɍď *
+* (L^̏I͑ČĂяoClearWorkLayerōs)             *
+*                                                          *
+* window	: LoX̏                                 *
+* target	: ̃C[                                 *
+* Ԃl                                                       *
+*	I:0	s:̒l(^CL^ĂȂ)            *
+***************************************************************/
+int CommitWorkLayerTiles(DRAW_WINDOW* window, LAYER* target)
+{
+	UPDATE_RECTANGLE update;
+
+	// ȕʂɉe鍇@̓^CPʂōłȂ
+	if((window->flags & DRAW_WINDOW_TRACK_WORK_TILES) == 0
+		|| window->work_layer->layer_mode >= LAYER_BLEND_SLELECTABLE_NUM)
+	{
+		return -1;
+	}
+
+	update.target = target;
+	while(NextUpdateTilesRectangle(&window->work_tiles, window->work_layer->width,
+		window->work_layer->height, &update) != FALSE)
+	{
+		update.surface_p = cairo_surface_create_for_rectangle(
+			target->surface_p, update.x, update.y, update.width, update.height);
+		update.cairo_p = cairo_create(update.surface_p);
+		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &update);
+		cairo_destroy(update.cairo_p);
+		cairo_surface_destroy(update.surface_p);
+
+		ClearWorkLayerRectangle(window, &update);
+	}
+
+	return 0;
+}
+
+/*****************************************************
+* ClearWorkLayer֐                                 *
+* ƃC[                             *
+* (^CL^ĂΕ`悵^Ĉݏ) *
+*                                                *
+* window	: LoX̏                       *
+*****************************************************/
+void ClearWorkLayer(DRAW_WINDOW* window)
+{
+	UPDATE_RECTANGLE rect;
+
+	if((window->flags & DRAW_WINDOW_TRACK_WORK_TILES) != 0)
+	{
+		while(NextUpdateTilesRectangle(&window->work_tiles, window->work_layer->width,
+			window->work_layer->height, &rect) != FALSE)
+		{
+			ClearWorkLayerRectangle(window, &rect);
+		}
+
+		window->flags &= ~(DRAW_WINDOW_TRACK_WORK_TILES);
+	}
+	else
+	{
+		(void)memset(window->work_layer->pixels, 0,
+			window->work_layer->stride * window->work_layer->height);
+	}
+}
+
+/*********************************************************
+* ResetWorkLayerTiles֐                                *
+* ÕXg[Ñ^C̋L^cĂ             *
+* L^^CċL^I                 *
+* ({^ăuVɓnOɌĂяo)               *
+*                                                    *
+* window	: LoX̏                           *
+*********************************************************/
+void ResetWorkLayerTiles(DRAW_WINDOW* window)
+{
+	if((window->flags & DRAW_WINDOW_TRACK_WORK_TILES) != 0)
+	{
+		ClearWorkLayer(window);
+	}
+}
+
+/*****************************************
+* InitializeBrushStampBatch֐          *
+* ~`uV܂Ƃ߂ĕ`悷鏀 *
+*                                    *
+* batch	: ܂Ƃ߂ĕ`悷uV̏   *
+*****************************************/
+void InitializeBrushStampBatch(BRUSH_STAMP_BATCH* batch)
+{
+	batch->num_stamps = 0;
+	batch->anti_alias = FALSE;
+	batch->image = NULL;
+}
+
+/**************************************************
+* AddCircleBrushStamp֐                         *
+* ~`uV1܂Ƃ߂ĕ`悷\ɒǉ *
+* (\񂪈tȂ`悵Ăǉ)            *
+*                                             *
+* window		: LoX̏                *
+* core		: uV̊{                    *
+* batch		: ܂Ƃ߂ĕ`悷uV̏        *
+* x			: `͈͂̍XW               *
+* y			: `͈͂̍YW               *
+* start_x		: `͈͂̍XW()     *
+* start_y		: `͈͂̍YW()     *
+* width		: `͈͂̕                        *
+* height		: `͈͂̍                  *
+* zoom		: gEk                        *
+* alpha		: sx                            *
+* anti_alias	: A`GCAXsۂ    *
+**************************************************/
+void AddCircleBrushStamp(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch,
+	gdouble x,
+	gdouble y,
+	int start_x,
+	int start_y,
+	int width,
+	int height,
+	gdouble zoom,
+	gdouble alpha,
+	int anti_alias
+)
+{
+	BRUSH_STAMP *stamp;
+
 	if(start_x < 0)
 	{
+		width += start_x;
 		start_x = 0;
 	}
 	if(start_y < 0)
 	{
+		height += start_y;
 		start_y = 0;
 	}
+	if(start_x + width > window->work_layer->width)
+	{
+		width = window->work_layer->width - start_x;
+	}
+	if(start_y + height > window->work_layer->height)
+	{
+		height = window->work_layer->height - start_y;
+	}
+	if(width <= 0 || height <= 0)
+	{
+		return;
+	}
 
-	// `pCairo쐬
-	update_surface = cairo_surface_create_for_rectangle(
-		window->mask_temp->surface_p, x, y,
-			width, height);
-	update = cairo_create(update_surface);
+	if(batch->num_stamps >= BRUSH_STAMP_BATCH_SIZE)
+	{
+		FlushCircleBrushStamps(window, core, batch);
+	}
 
-	*mask = window->mask_temp->pixels;
-	for(i=0; i<(int)height; i++)
+	stamp = &batch->stamps[batch->num_stamps];
+	stamp->x = x,	stamp->y = y;
+	stamp->zoom = zoom;
+	stamp->alpha = alpha;
+	stamp->start_x = start_x,	stamp->start_y = start_y;
+	stamp->width = width,	stamp->height = height;
+	stamp->anti_alias = anti_alias;
+
+	if(batch->num_stamps == 0)
+	{
+		batch->min_x = start_x,	batch->min_y = start_y;
+		batch->max_x = start_x + width,	batch->max_y = start_y + height;
+	}
+	else
 	{
-		(void)memset(&((*mask)[(i+start_y)*stride+start_x*4]),
-			0, stride
-		);
+		batch->min_x = MINIMUM(batch->min_x, start_x);
+		batch->min_y = MINIMUM(batch->min_y, start_y);
+		batch->max_x = MAXIMUM(batch->max_x, start_x + width);
+		batch->max_y = MAXIMUM(batch->max_y, start_y + height);
+	}
+	if(anti_alias != FALSE)
+	{
+		batch->anti_alias = TRUE;
 	}
 
-	if(window->app->textures.active_texture == 0)
-	{	// eNX`	
-		if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
-		{	// I͈͖
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// uṼTCYݒ肵ĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(update, core->brush_pattern);
-				cairo_paint_with_alpha(update, alpha);
-			}
-			else
-			{	// sیL
-					// uṼTCYݒ肵
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				// xAꎞۑ̈ɕ`
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `悷ʒuZbg
-				cairo_matrix_init_translate(&matrix, 0,0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				// `挋ʂg
-				cairo_set_source(update, core->temp_pattern);
-				// ANeBuȃC[Ń}XN
-				cairo_mask_surface(update,
-					window->active_layer->surface_p, - x, - y);
-			}
+	batch->num_stamps++;
+}
+
+/***************************************************************
+* DrawCircleBrushStampLine֐                                 *
+* \񂵂~`uV1sƃC[ɕ`悷            *
+*                                                          *
+* stamp	: `悷uV                                       *
+* y	: `悷s                                               *
+* work_pixels	: ƃC[̃sNZf[^                 *
+* brush_pixels	: uV̉摜̃sNZf[^                 *
+* brush_width	: uV̉摜̕                             *
+* brush_height	: uV̉摜̍                           *
+* brush_stride	: uV̉摜1s̃oCg                *
+* selection_pixels	: I͈͂̃sNZf[^(NULL)   *
+* lock_pixels	: sی̃sNZf[^(NULL)     *
+* texture_pixels	: eNX`̃sNZf[^(NULL) *
+* layer_stride	: ƃC[1s̃oCg                *
+* mask_stride	: }XN1s̃oCg                      *
+***************************************************************/
+static INLINE void DrawCircleBrushStampLine(
+	const BRUSH_STAMP* stamp,
+	int y,
+	uint8* work_pixels,
+	const uint8* brush_pixels,
+	int brush_width,
+	int brush_height,
+	int brush_stride,
+	const uint8* selection_pixels,
+	const uint8* lock_pixels,
+	const uint8* texture_pixels,
+	int layer_stride,
+	int mask_stride
+)
+{
+	uint8 *work_line = &work_pixels[y*layer_stride];
+	FLOAT_T v, u;
+	int row, column;
+	int weight_v, weight_u;
+	int j;
+	const uint8 *rows[2];
+	int alpha = (int)(stamp->alpha * 255 + 0.5);
+
+	if(y < stamp->start_y || y >= stamp->start_y + stamp->height)
+	{
+		return;
+	}
+
+	// uV̉摜̍W(Cairȏo`ԂƓʒu)
+	v = ((y + 0.5) - stamp->y) * stamp->zoom - 0.5;
+	row = (int)floor(v);
+	if(row < -1 || row >= brush_height)
+	{
+		return;
+	}
+	weight_v = (int)((v - row) * 256);
+	rows[0] = (row >= 0) ? &brush_pixels[row*brush_stride] : NULL;
+	rows[1] = (row + 1 < brush_height) ? &brush_pixels[(row+1)*brush_stride] : NULL;
+
+	for(j=stamp->start_x; j<stamp->start_x+stamp->width; j++)
+	{
+		uint8 *ref_pix = &work_line[j*4];
+		uint32 sample[4] = {0, 0, 0, 0};
+		uint32 weight;
+		int mask = 255;
+		int draw[4];
+		int k, l, c;
+
+		u = ((j + 0.5) - stamp->x) * stamp->zoom - 0.5;
+		column = (int)floor(u);
+		if(column < -1 || column >= brush_width)
+		{
+			continue;
 		}
-		else
-		{	// I͈͗L
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// uṼTCYݒ肵
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				// xꎞۑ̈ɕ`
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `悷ʒuZbg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				// `挋ʂg
-				cairo_set_source(update, core->temp_pattern);
-				// I͈͂Ń}XN
-				cairo_mask_surface(window->mask_temp->cairo_p,
-					window->selection->surface_p, - x, - y);
+		weight_u = (int)((u - column) * 256);
+
+		for(k=0; k<2; k++)
+		{
+			if(rows[k] == NULL)
+			{
+				continue;
 			}
-			else
+			for(l=0; l<2; l++)
 			{
-				// I͈͗L
-					// ANeBuȃC[ƑI͈͂Ń}XN
-				// `pɈꎞICairo쐬
-				cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-					window->temp_layer->surface_p, x, y, width, height);
-				cairo_t *update_temp = cairo_create(temp_surface);
-
-				// ܂͈ꎞۑC[ɑI͈͂Ń}XNĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-
-				// `OɃsNZf[^Ă
-				for(i=0; i<height; i++)
+				if(column + l < 0 || column + l >= brush_width)
 				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
+					continue;
+				}
+				weight = (uint32)(((k == 0) ? 256 - weight_v : weight_v)
+					* ((l == 0) ? 256 - weight_u : weight_u));
+				for(c=0; c<4; c++)
+				{
+					sample[c] += rows[k][(column+l)*4+c] * weight;
 				}
+			}
+		}
+		if(sample[3] == 0)
+		{
+			continue;
+		}
+
+		// Í͈AsیAeNX`̃}XN܂Ƃ߂Ċ|
+		if(selection_pixels != NULL)
+		{
+			mask = mask * selection_pixels[y*mask_stride+j] / 255;
+		}
+		if(lock_pixels != NULL)
+		{
+			mask = mask * lock_pixels[y*layer_stride+j*4+3] / 255;
+		}
+		if(texture_pixels != NULL)
+		{
+			mask = mask * texture_pixels[y*mask_stride+j] / 255;
+		}
+		mask = mask * alpha / 255;
+
+		for(c=0; c<4; c++)
+		{
+			draw[c] = (int)((((sample[c] + 32768) >> 16) * mask + 127) / 255);
+		}
+
+		// AdaptNormalBrushƓKōƃC[ɔf
+		if(ref_pix[3] < draw[3])
+		{
+			ref_pix[0] = (uint8)((uint32)((draw[0]-(int)ref_pix[0])
+				* draw[3] >> 8) + ref_pix[0]);
+			ref_pix[1] = (uint8)((uint32)((draw[1]-(int)ref_pix[1])
+				* draw[3] >> 8) + ref_pix[1]);
+			ref_pix[2] = (uint8)((uint32)((draw[2]-(int)ref_pix[2])
+				* draw[3] >> 8) + ref_pix[2]);
+			ref_pix[3] = (uint8)((uint32)((draw[3]-(int)ref_pix[3])
+				* draw[3] >> 8) + ref_pix[3]);
+		}
+	}
+}
+
+/*****************************************************
+* FlushCircleBrushStamps֐                         *
+* \񂵂~`uVƃC[ɂ܂Ƃ߂ĕ`悷 *
+*                                                *
+* window	: LoX̏                       *
+* core	: uV̊{                           *
+* batch	: ܂Ƃ߂ĕ`悷uV̏               *
+*****************************************************/
+void FlushCircleBrushStamps(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch
+)
+{
+	// uV̉摜
+	cairo_surface_t *brush_surface = core->brush_surface;
+	uint8 *brush_pixels;
+	int brush_width, brush_height, brush_stride;
+	// `ƃ}XÑsNZf[^
+	uint8 *work_pixels = window->work_layer->pixels;
+	uint8 *selection_pixels = NULL;
+	uint8 *lock_pixels = NULL;
+	uint8 *texture_pixels = NULL;
+	int layer_stride = window->work_layer->stride;
+	int mask_stride = window->selection->stride;
+	int num_stamps = batch->num_stamps;
+	BRUSH_STAMP *stamps = batch->stamps;
+	int i;
+
+	if(num_stamps == 0)
+	{
+		return;
+	}
+
+	// A`GCAX͈̔͂܂߂ĕ`悷^CL^
+	for(i=0; i<num_stamps; i++)
+	{
+		AddWorkLayerTiles(window, stamps[i].start_x - 1, stamps[i].start_y - 1,
+			stamps[i].width + 3, stamps[i].height + 3);
+	}
+
+	if(batch->image != NULL)
+	{	// 摜uV͏kE]ς݂̉摜`悷
+		brush_surface = batch->image->surface;
+	}
+	else if(core->brush_surface == NULL
+		|| cairo_image_surface_get_format(core->brush_surface) != CAIRO_FORMAT_ARGB32)
+	{	// ړǂ߂Ȃ摜Ȃ1`悷
+		uint8 *draw_pixel;
+		for(i=0; i<num_stamps; i++)
+		{
+			DrawCircleBrushWorkLayer(window, core, stamps[i].x, stamps[i].y,
+				stamps[i].width, stamps[i].height, &draw_pixel, stamps[i].zoom, stamps[i].alpha);
+			AdaptNormalBrush(window, draw_pixel, stamps[i].width, stamps[i].height,
+				stamps[i].start_x, stamps[i].start_y, stamps[i].anti_alias);
+		}
+		goto finish;
+	}
 
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-				cairo_set_source_surface(update_temp,
-					update_surface, 0, 0);
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
+	core->num_dabs += num_stamps;
+	cairo_surface_flush(brush_surface);
+	brush_pixels = cairo_image_surface_get_data(brush_surface);
+	brush_width = cairo_image_surface_get_width(brush_surface);
+	brush_height = cairo_image_surface_get_height(brush_surface);
+	brush_stride = cairo_image_surface_get_stride(brush_surface);
+
+	if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) != 0)
+	{
+		selection_pixels = window->selection->pixels;
+	}
+	if((window->active_layer->flags & LAYER_LOCK_OPACITY) != 0)
+	{
+		lock_pixels = window->active_layer->pixels;
+	}
+	if(window->app->textures.active_texture != 0)
+	{
+		texture_pixels = window->texture->pixels;
+	}
 
-				// gp}XNύX
-				*mask = window->temp_layer->pixels;
+	if(batch->anti_alias == FALSE)
+	{
+		// 1sA̍sɊ|uV\񂵂ɕ`悷
+			// (sNZւ̕`揇1`悵ꍇƕςȂ)
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(brush_pixels, brush_width, brush_height, brush_stride, \
+	work_pixels, selection_pixels, lock_pixels, texture_pixels, layer_stride, mask_stride, num_stamps, stamps)
+#endif
+		for(i=batch->min_y; i<batch->max_y; i++)
+		{
+			int n;
+			for(n=0; n<num_stamps; n++)
+			{
+				DrawCircleBrushStampLine(&stamps[n], i, work_pixels,
+					brush_pixels, brush_width, brush_height, brush_stride,
+					selection_pixels, lock_pixels, texture_pixels, layer_stride, mask_stride);
+			}
+		}
+	}
+	else
+	{
+		// A`GCAX1`悵ꍇƓuVɓKp̂
+			// uVɍs񉻂ĕ`悷
+		int n;
+		for(n=0; n<num_stamps; n++)
+		{
+			const BRUSH_STAMP *stamp = &stamps[n];
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(brush_pixels, brush_width, brush_height, brush_stride, \
+	work_pixels, selection_pixels, lock_pixels, texture_pixels, layer_stride, mask_stride, stamp)
+#endif
+			for(i=stamp->start_y; i<stamp->start_y+stamp->height; i++)
+			{
+				DrawCircleBrushStampLine(stamp, i, work_pixels,
+					brush_pixels, brush_width, brush_height, brush_stride,
+					selection_pixels, lock_pixels, texture_pixels, layer_stride, mask_stride);
+			}
 
-				// ꎞIɍ쐬Cairoj
-				cairo_surface_destroy(temp_surface);
-				cairo_destroy(update_temp);
+			if(stamp->anti_alias != FALSE)
+			{
+				ANTI_ALIAS_RECTANGLE range = {stamp->start_x - 1, stamp->start_y - 1,
+					stamp->width + 3, stamp->height + 3};
+				AntiAliasLayer(window->work_layer, window->temp_layer, &range);
 			}
 		}
-	}
-	else
-	{	// eNX`L
-			// ꎞۑpCairo쐬
-		cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-			window->temp_layer->surface_p, x, y, width, height);
-		cairo_t *update_temp = cairo_create(temp_surface);
+	}
+
+finish:
+	InitializeBrushStampBatch(batch);
+}
+
+/*****************************************************
+* AddImageBrushStamp֐                             *
+* 摜uV1܂Ƃ߂ĕ`悷\ɒǉ    *
+* (kE]ς݂̉摜gȂ΂ɕ`悷) *
+*                                                *
+* window			: LoX̏               *
+* core			: uV̊{                   *
+* batch			: ܂Ƃ߂ĕ`悷uV̏       *
+* x				: `͈͂̒SXW                *
+* y				: `͈͂̒SYW                *
+* start_x			: `͈͂̍XW          *
+* start_y			: `͈͂̍YW          *
+* width			: `͈͂̕                       *
+* height			: `͈͂̍                 *
+* scale			: `悷g嗦                     *
+* size			: 摜̒ӂ̒                   *
+* angle			: 摜̊px                         *
+* image_width		: 摜̕                       *
+* image_height	: 摜̍                         *
+* alpha			: Zx                               *
+* anti_alias		: A`GCAXsۂ   *
+*****************************************************/
+void AddImageBrushStamp(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch,
+	gdouble x,
+	gdouble y,
+	int start_x,
+	int start_y,
+	int width,
+	int height,
+	gdouble scale,
+	gdouble size,
+	gdouble angle,
+	gdouble image_width,
+	gdouble image_height,
+	gdouble alpha,
+	int anti_alias
+)
+{
+	BRUSH_IMAGE_CACHE *cache;
+	BRUSH_IMAGE *image;
+	uint8 *draw_pixel;
+	FLOAT_T zoom = 1 / scale;
+	FLOAT_T image_zoom;
+	int level, angle_key;
+
+	if((cache = PrepareBrushImageCache(core, core->brush_surface)) != NULL)
+	{
+		// g摜ς邩\񂪈tȂɕ`悷
+			// (LbV摜̂ĂOɕ`悵Ă)
+		GetBrushImageKey(cache, zoom, angle, &level, &angle_key);
+		if(batch->num_stamps > 0 && (batch->image == NULL || batch->image->level != level
+			|| batch->image->angle_key != angle_key || batch->num_stamps >= BRUSH_STAMP_BATCH_SIZE))
+		{
+			FlushCircleBrushStamps(window, core, batch);
+		}
 
-		// `OɈꎞۑC[̃sNZf[^
-		for(i=0; i<height; i++)
+		if((image = GetCachedBrushImage(cache, level, angle_key)) != NULL)
 		{
-			(void)memset(&window->temp_layer->pixels[
-				(i+start_y)*window->temp_layer->stride+start_x*4],
-				0, stride
+			// ]ς݂̉摜̒S`͈͂̒Sɍ킹
+			image_zoom = zoom / (1 << level);
+			batch->image = image;
+			AddCircleBrushStamp(window, core, batch,
+				x - cairo_image_surface_get_width(image->surface) * 0.5 / image_zoom,
+				y - cairo_image_surface_get_height(image->surface) * 0.5 / image_zoom,
+				start_x, start_y, width, height, image_zoom, alpha, anti_alias
 			);
+			return;
 		}
+	}
 
-		if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
-		{	// I͈͖
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// gEkAsxݒ肵ĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(update_temp, core->brush_pattern);
-				cairo_paint_with_alpha(update_temp, alpha);
-			}
-			else
-			{	// sیL
-					// ANeBuȃC[Ń}XNĕ`
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update_temp, core->temp_pattern);
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
-			}
+	// LbVgȂΗ\񕪂`悵Ă1`悷
+	FlushCircleBrushStamps(window, core, batch);
+	DrawImageBrushWorkLayer(window, core, x, y, width, height, scale,
+		size, angle, image_width, image_height, &draw_pixel, alpha);
+	AdaptNormalBrush(window, draw_pixel, width, height, start_x, start_y, anti_alias);
+}
 
-			cairo_set_source_surface(update, temp_surface, 0, 0);
-			cairo_mask_surface(update, window->texture->surface_p, - x, - y);
+/*********************************************
+* BrushScatterRandom֐                     *
+* ̎Ɣԍ0`1̗         *
+* (ԍɓƗĂ̂ŕɐł) *
+*                                        *
+* seed	: ̎                           *
+* index	: ̔ԍ                         *
+* Ԃl                                     *
+*	0`1̗                               *
+*********************************************/
+static FLOAT_T BrushScatterRandom(uint32 seed, uint32 index)
+{
+	uint32 hash = seed ^ (index * 0x9E3779B9u);
 
-			*mask = window->temp_layer->pixels;
-		}
-		else
-		{	// I͈͗L
-			if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
-			{	// sی얳
-					// I͈͂ƃeNX`Ń}XN
-				// ܂͈ꎞۑ̈ɕsxw肵ĕ`悵Ă
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `挋ʂg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-				// I͈͂Ń}XN
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-
-				// ꎞۑ̈̃sNZf[^xZbg
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
-				}
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
 
-				// eNX`Ń}XNĕ`
-				cairo_set_source_surface(update_temp, update_surface, 0, 0);
-				cairo_mask_surface(update_temp, window->texture->surface_p, - x, - y);
-			}
-			else
-			{	// sیL
-					// Í͈AeNX`AANeBuȃC[Ń}XN
-				// ܂͕sxݒ肵ĕ`悵Ă
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-				cairo_set_source(core->temp_cairo, core->brush_pattern);
-				cairo_paint_with_alpha(core->temp_cairo, alpha);
-				// `挋ʂg
-				cairo_matrix_init_translate(&matrix, 0, 0);
-				cairo_pattern_set_matrix(core->temp_pattern, &matrix);
-				cairo_set_source(update, core->temp_pattern);
-
-				// `OɈꎞۑ̈̃sNZf[^
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->temp_layer->pixels[
-						(i+start_y)*window->temp_layer->stride+start_x*4],
-						0, stride
-					);
-				}
+	return hash / (FLOAT_T)0xFFFFFFFFu;
+}
 
-				// I͈͂Ń}XN
-				cairo_mask_surface(update,
-					window->selection->surface_p, - x, - y);
-				cairo_set_source_surface(update_temp,
-					update_surface, 0, 0);
-				// ANeBuȃC[Ń}XN
-				cairo_mask_surface(update_temp,
-					window->active_layer->surface_p, - x, - y);
-
-				// 2߂̈ꎞۑ̈̃sNZf[^
-				for(i=0; i<height; i++)
-				{
-					(void)memset(&window->mask_temp->pixels[
-						(i+start_y)*window->mask_temp->stride+start_x*4],
-						0, stride
-					);
-				}
+/*********************************************
+* InitializeBrushScatter֐                 *
+* Xg[N̊JnɎUz̗̎߂ *
+*                                        *
+* scatter	: Uz̏                     *
+* time	: Xg[NJn           *
+* x		: Xg[NJnXW          *
+* y		: Xg[NJnYW          *
+*********************************************/
+void InitializeBrushScatter(BRUSH_SCATTER* scatter, guint32 time, FLOAT_T x, FLOAT_T y)
+{
+	// ͂̋L^ĐɂUzɂȂ悤͂̓e猈߂
+	scatter->seed = (uint32)time * 2654435761u
+		^ (uint32)(x * 16) * 40503u ^ (uint32)(y * 16) * 2246822519u;
+	scatter->num_generated = 0;
+}
 
-				// eNX`Ń}XNĕ`
-				cairo_set_source_surface(update, temp_surface, 0, 0);
-				cairo_mask_surface(update, window->texture->surface_p, - x, - y);
-			}
-		}
+/*************************************************************
+* GenerateBrushScatterDabs֐                               *
+* Xg[N̗̎킩Uz̈ʒuATCYAZx𐶐 *
+*                                                        *
+* scatter		: Uz̏                                 *
+* x			: Uz̒SXW                                *
+* y			: Uz̒SYW                                *
+* range		: Uz͈                                   *
+* size		: UzTCY                                     *
+* random_size	: UzTCỸ_                     *
+* random_flow	: UzZx̃_                       *
+* alpha		: Uz̊̔Zx                               *
+* num_dabs	: 鐔                                     *
+* dabs		: ʂi[z                         *
+*************************************************************/
+void GenerateBrushScatterDabs(
+	BRUSH_SCATTER* scatter,
+	FLOAT_T x,
+	FLOAT_T y,
+	FLOAT_T range,
+	FLOAT_T size,
+	FLOAT_T random_size,
+	FLOAT_T random_flow,
+	FLOAT_T alpha,
+	int num_dabs,
+	BRUSH_SCATTER_DAB* dabs
+)
+{
+	uint32 seed = scatter->seed;
+	uint32 first = scatter->num_generated;
+	int i;
 
-		// ꎞIɍ쐬Cairoj
-		cairo_surface_destroy(temp_surface);
-		cairo_destroy(update_temp);
+	// Uzɗ̔ԍ܂Ă̂ŏԂɊ֌WȂʂɂȂ
+#ifdef _OPENMP
+#pragma omp parallel for if(num_dabs >= 64) firstprivate(seed, first, x, y, range, size, random_size, random_flow, alpha)
+#endif
+	for(i=0; i<num_dabs; i++)
+	{
+		uint32 index = (first + (uint32)i) * 6;
+		FLOAT_T direction;
+
+		direction = (BrushScatterRandom(seed, index) < 0.5) ? 1 : -1;
+		dabs[i].x = BrushScatterRandom(seed, index + 1) * range * direction + x;
+		direction = (BrushScatterRandom(seed, index + 2) < 0.5) ? 1 : -1;
+		dabs[i].y = BrushScatterRandom(seed, index + 3) * range * direction + y;
+		dabs[i].zoom = (1 - BrushScatterRandom(seed, index + 4) * random_size) * size;
+		dabs[i].flow = (1 - BrushScatterRandom(seed, index + 5) * random_flow) * alpha;
 	}
 
-	// XVpɍ쐬Cairoj
-	cairo_surface_destroy(update_surface);
-	cairo_destroy(update);
+	scatter->num_generated += (uint32)num_dabs;
 }
 
 /*************************************************
@@ -1054,6 +2288,8 @@ void DrawImageBrush(
 	// forp̃JE^
 	int i;
 
+	core->num_dabs++;
+
 	if(start_x < 0)
 	{
 		width += start_x;
@@ -1119,8 +2355,12 @@ void DrawImageBrush(
 	{
 		if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 		{
-			cairo_set_source(update, core->brush_pattern);
-			cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+			// kE]ς݂̉摜ΊgEkŕ`悷
+			if(SetBrushImageSource(core, update, zoom, angle, size) == FALSE)
+			{
+				cairo_set_source(update, core->brush_pattern);
+				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+			}
 			cairo_paint_with_alpha(update, alpha);
 		}
 		else
@@ -1305,6 +2545,8 @@ void DrawImageBrushWorkLayer(
 	// forp̃JE^
 	int i;
 
+	core->num_dabs++;
+
 	if(start_x < 0)
 	{
 		width += start_x;
@@ -1370,8 +2612,12 @@ void DrawImageBrushWorkLayer(
 	{
 		if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 		{
-			cairo_set_source(update, core->brush_pattern);
-			cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+			// kE]ς݂̉摜ΊgEkŕ`悷
+			if(SetBrushImageSource(core, update, zoom, angle, size) == FALSE)
+			{
+				cairo_set_source(update, core->brush_pattern);
+				cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+			}
 			cairo_paint_with_alpha(update, alpha);
 		}
 		else
@@ -1500,6 +2746,9 @@ void AdaptNormalBrush(
 	int layer_stride = window->work_layer->stride;
 	int i;
 
+	// A`GCAX͈̔͂܂߂ĕ`悵^CL^
+	AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 #ifdef _OPENMP
 #pragma omp parallel for firstprivate(width, work_pixel, layer_stride, start_x, start_y, draw_pixel)
 #endif
@@ -2535,11 +3784,7 @@ void UpdateBrushPreviewWindow(
 	release_func(window, points[sizeof(points)/sizeof(*points)-1].x,
 		points[sizeof(points)/sizeof(*points)-1].y, 1, core, &event_info);
 
-	MEM_FREE_FUNC(window->history.history[0].data);
-	window->history.history[0].data = NULL;
-	window->history.num_step = 0;
-	window->history.rest_redo = 0;
-	window->history.rest_undo = 0;
+	ReleaseHistory(&window->history);
 
 	gtk_widget_queue_draw(window->window);
 }
@@ -2990,6 +4235,574 @@ void BlendWaterBrush(
 	}
 }
 
+// uV̊֐L^p̂̂ɍւĂL^
+static STROKE_RECORD *installed_record = NULL;
+
+/*******************************************************
+* WriteStrokeRecordEvent֐                           *
+* uVɓnꂽ͂1so                  *
+*                                                  *
+* type		: ͂̎(P:NbN M:hbO R:I) *
+* x			: `̈XW                          *
+* y			: `̈YW                          *
+* pressure	: M                                     *
+* state		: CL[̏                           *
+* button		: ꂽ{^                       *
+* time		: Cxg̎                           *
+*******************************************************/
+static void WriteStrokeRecordEvent(
+	char type,
+	gdouble x,
+	gdouble y,
+	gdouble pressure,
+	GdkModifierType state,
+	guint button,
+	guint32 time
+)
+{
+	// W̓P[Ɋ֌WȂAۂ߂ɏo
+	char x_str[G_ASCII_DTOSTR_BUF_SIZE];
+	char y_str[G_ASCII_DTOSTR_BUF_SIZE];
+	char pressure_str[G_ASCII_DTOSTR_BUF_SIZE];
+
+	(void)fprintf(installed_record->fp, "%c %" G_GINT64_FORMAT " %s %s %s %u %u %u\n",
+		type, g_get_monotonic_time() - installed_record->start_time,
+		g_ascii_dtostr(x_str, sizeof(x_str), x),
+		g_ascii_dtostr(y_str, sizeof(y_str), y),
+		g_ascii_dtostr(pressure_str, sizeof(pressure_str), pressure),
+		(unsigned int)state, (unsigned int)button, (unsigned int)time
+	);
+	installed_record->num_events++;
+}
+
+static void StrokeRecordPress(DRAW_WINDOW* window, gdouble x, gdouble y,
+	gdouble pressure, BRUSH_CORE* core, void* state);
+
+/*******************************************
+* RestoreRecordingBrush֐                *
+* L^pɍւuV̊֐ɖ߂ *
+*******************************************/
+static void RestoreRecordingBrush(void)
+{
+	BRUSH_CORE *core;
+
+	if(installed_record == NULL)
+	{
+		return;
+	}
+
+	// L^ɃuV̎ނύXĂ炻̂܂܂ɂ
+	core = installed_record->core;
+	if(core->press_func == StrokeRecordPress)
+	{
+		core->press_func = installed_record->press_func;
+		core->motion_func = installed_record->motion_func;
+		core->release_func = installed_record->release_func;
+	}
+
+	(void)fflush(installed_record->fp);
+	installed_record->core = NULL;
+	installed_record = NULL;
+}
+
+/***************************************
+* StrokeRecordPress֐                *
+* L^̃NbÑR[obN֐ *
+*                                  *
+* window		: `̈̏       *
+* x			: `̈XW          *
+* y			: `̈YW          *
+* pressure	: M                     *
+* core		: uV̊{         *
+* state		: }EX̏             *
+***************************************/
+static void StrokeRecordPress(
+	DRAW_WINDOW* window,
+	gdouble x,
+	gdouble y,
+	gdouble pressure,
+	BRUSH_CORE* core,
+	void* state
+)
+{
+	GdkEventButton *event = (GdkEventButton*)state;
+
+	WriteStrokeRecordEvent('P', x, y, pressure, event->state, event->button, event->time);
+	installed_record->press_func(window, x, y, pressure, core, state);
+}
+
+/***************************************
+* StrokeRecordMotion֐               *
+* L^̃hbÕR[obN֐ *
+*                                  *
+* window		: `̈̏       *
+* x			: `̈XW          *
+* y			: `̈YW          *
+* pressure	: M                     *
+* core		: uV̊{         *
+* state		: {^ACL[̏   *
+***************************************/
+static void StrokeRecordMotion(
+	DRAW_WINDOW* window,
+	gdouble x,
+	gdouble y,
+	gdouble pressure,
+	BRUSH_CORE* core,
+	void* state
+)
+{
+	WriteStrokeRecordEvent('M', x, y, pressure, *(GdkModifierType*)state, 0, window->motion_time);
+	installed_record->motion_func(window, x, y, pressure, core, state);
+}
+
+/*******************************************
+* StrokeRecordRelease֐                  *
+* L^̃hbOĨR[obN֐ *
+*                                      *
+* window		: `̈̏           *
+* x			: `̈XW              *
+* y			: `̈YW              *
+* pressure	: M                         *
+* core		: uV̊{             *
+* state		: }EX̏                 *
+*******************************************/
+static void StrokeRecordRelease(
+	DRAW_WINDOW* window,
+	gdouble x,
+	gdouble y,
+	gdouble pressure,
+	BRUSH_CORE* core,
+	void* state
+)
+{
+	GdkEventButton *event = (GdkEventButton*)state;
+
+	WriteStrokeRecordEvent('R', x, y, pressure, event->state, event->button, event->time);
+	installed_record->release_func(window, x, y, pressure, core, state);
+	// Xg[NÎŌ̊֐ɖ߂
+	RestoreRecordingBrush();
+}
+
+/***************************************************
+* StartStrokeRecord֐                            *
+* uVɓn͂̃t@Cւ̋L^Jn *
+* (Ƀt@CΖɒǋL)             *
+*                                              *
+* window		: `̈̏                   *
+* file_path	: L^̃t@C̃pX               *
+* Ԃl                                           *
+*	I:0	s:̒l                        *
+***************************************************/
+int StartStrokeRecord(DRAW_WINDOW* window, const char* file_path)
+{
+	STROKE_RECORD *record;
+	FILE *fp;
+
+	StopStrokeRecord(window);
+
+	// ̃LoXœt@CɋL^ĂȂ悤ɒǋL
+	if((fp = fopen(file_path, "a")) == NULL)
+	{
+		return -1;
+	}
+
+	if((record = (STROKE_RECORD*)MEM_ALLOC_FUNC(sizeof(*record))) == NULL)
+	{
+		(void)fclose(fp);
+		return -1;
+	}
+	(void)memset(record, 0, sizeof(*record));
+
+	// L^ɐ擪ɃLoX̃TCYo
+	(void)fprintf(fp, "%s %d %d\n", STROKE_RECORD_HEADER, window->width, window->height);
+	(void)fflush(fp);
+	record->fp = fp;
+	record->start_time = g_get_monotonic_time();
+	window->stroke_record = record;
+
+	return 0;
+}
+
+/***************************************
+* StopStrokeRecord֐                 *
+* uVɓn͂̋L^I *
+*                                  *
+* window	: `̈̏           *
+***************************************/
+void StopStrokeRecord(DRAW_WINDOW* window)
+{
+	if(window->stroke_record == NULL)
+	{
+		return;
+	}
+
+	if(installed_record == window->stroke_record)
+	{
+		RestoreRecordingBrush();
+	}
+
+	(void)fclose(window->stroke_record->fp);
+	MEM_FREE_FUNC(window->stroke_record);
+	window->stroke_record = NULL;
+}
+
+/*******************************************************
+* BeginRecordStroke֐                                *
+* L^ł΃uV̊֐L^p̂̂ɍւ *
+* (Xg[NIɌɖ߂)                         *
+*                                                  *
+* window	: `̈̏                           *
+* core	: ꂩgpuV                       *
+*******************************************************/
+void BeginRecordStroke(DRAW_WINDOW* window, BRUSH_CORE* core)
+{
+	STROKE_RECORD *record = window->stroke_record;
+
+	if(record == NULL)
+	{
+		return;
+	}
+
+	// {^𗣂ɏIXg[N̍ւcĂΖ߂
+	if(installed_record != NULL)
+	{
+		RestoreRecordingBrush();
+	}
+
+	record->core = core;
+	record->press_func = core->press_func;
+	record->motion_func = core->motion_func;
+	record->release_func = core->release_func;
+	core->press_func = StrokeRecordPress;
+	core->motion_func = StrokeRecordMotion;
+	core->release_func = StrokeRecordRelease;
+	installed_record = record;
+}
+
+/*********************************************
+* CompareStrokeLatency֐                   *
+* Ԃ̕ёւp̔r֐             *
+*                                        *
+* a	: r鏈1                      *
+* b	: r鏈2                      *
+* Ԃl                                     *
+*	a̕ZΕAΐAȂ0 *
+*********************************************/
+static int CompareStrokeLatency(const void* a, const void* b)
+{
+	gint64 latency_a = *(const gint64*)a;
+	gint64 latency_b = *(const gint64*)b;
+
+	if(latency_a < latency_b)
+	{
+		return -1;
+	}
+	else if(latency_a > latency_b)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+/*********************************************************
+* OpenStrokeRecordSection֐                            *
+* L^t@CJĎw肵L^̐擪s܂œǂݐi߂ *
+* (L^͒ǋL̂1̃t@Cɕ)          *
+*                                                    *
+* file_path	: L^t@C̃pX                     *
+* section	: Ԗڂ̋L^(0)                      *
+* width		: L^̃LoX̕i[AhX   *
+* height	: L^̃LoX̍i[AhX *
+* Ԃl                                                 *
+*	L^̍ŏ̓͂̈ʒuɂt@C(sNULL)   *
+*********************************************************/
+static FILE* OpenStrokeRecordSection(const char* file_path, int section, int* width, int* height)
+{
+	FILE *fp;
+	char line[1024];
+	int count = 0;
+
+	if(section < 0 || (fp = fopen(file_path, "r")) == NULL)
+	{
+		return NULL;
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL)
+	{
+		if(strncmp(line, STROKE_RECORD_HEADER, sizeof(STROKE_RECORD_HEADER)-1) != 0)
+		{
+			continue;
+		}
+
+		if(count == section)
+		{
+			if(sscanf(line, STROKE_RECORD_HEADER " %d %d", width, height) != 2
+				|| *width <= 0 || *height <= 0)
+			{
+				break;
+			}
+			return fp;
+		}
+		count++;
+	}
+
+	(void)fclose(fp);
+	return NULL;
+}
+
+/*****************************************************
+* ReplayStrokeRecord֐                             *
+* L^͂uVɓnďԂv *
+*                                                *
+* window		: `̈̏                     *
+* core		: ͂uV                   *
+* file_path	: L^t@C̃pX                 *
+* section	: ĐL^Ԗڂ(0)          *
+* result		: vʂi[\̂̃AhX *
+* Ԃl                                             *
+*	I:0	s:̒l                          *
+*****************************************************/
+int ReplayStrokeRecord(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	const char* file_path,
+	int section,
+	STROKE_REPLAY_RESULT* result
+)
+{
+	// L^t@C
+	FILE *fp;
+	char line[1024];
+	// 1͖̓̏
+	gint64 *latencies = NULL;
+	gint64 *new_latencies;
+	int buffer_size = 0;
+	gint64 total_time = 0;
+	gint64 start;
+	// uVɓn}EX̏
+	GdkEventButton event = {0};
+	GdkModifierType state;
+	// L^͂̓e
+	char type;
+	gdouble x, y, pressure;
+	unsigned int button, time;
+	char *p;
+	// L^̃LoX̃TCY
+	int width, height;
+	// `FbNTvZp
+	uint32 checksum;
+	int i;
+
+	if((fp = OpenStrokeRecordSection(file_path, section, &width, &height)) == NULL)
+	{
+		return -1;
+	}
+
+	(void)memset(result, 0, sizeof(*result));
+	core->num_dabs = 0;
+	window->state = 0;
+
+	while(fgets(line, sizeof(line), fp) != NULL)
+	{
+		// ɒǋLꂽL^̐擪sŏI
+		if(strncmp(line, STROKE_RECORD_HEADER, sizeof(STROKE_RECORD_HEADER)-1) == 0)
+		{
+			break;
+		}
+		type = line[0];
+		if(type != 'P' && type != 'M' && type != 'R')
+		{
+			continue;
+		}
+
+		// L^͓̎ǂݔ΂
+		p = &line[1];
+		(void)g_ascii_strtoll(p, &p, 10);
+		x = g_ascii_strtod(p, &p);
+		y = g_ascii_strtod(p, &p);
+		pressure = g_ascii_strtod(p, &p);
+		state = (GdkModifierType)g_ascii_strtoull(p, &p, 10);
+		button = (unsigned int)g_ascii_strtoull(p, &p, 10);
+		time = (unsigned int)g_ascii_strtoull(p, &p, 10);
+
+		if(result->num_events >= buffer_size)
+		{
+			buffer_size += 4096;
+			new_latencies = (gint64*)MEM_REALLOC_FUNC(latencies, sizeof(*latencies) * buffer_size);
+			if(new_latencies == NULL)
+			{
+				MEM_FREE_FUNC(latencies);
+				(void)fclose(fp);
+				return -1;
+			}
+			latencies = new_latencies;
+		}
+
+		// input.cƓŃ{^̏ԂXVĂuVɓn
+		start = g_get_monotonic_time();
+		switch(type)
+		{
+		case 'P':
+			event.type = GDK_BUTTON_PRESS;
+			event.state = state;
+			event.button = button;
+			event.time = time;
+			if(button == 1)
+			{
+				window->state = state | GDK_BUTTON1_MASK;
+			}
+			// ÕXg[NŋL^ƃC[̃^CcȂ
+			ResetWorkLayerTiles(window);
+			core->press_func(window, x, y, pressure, core, (void*)&event);
+			break;
+		case 'M':
+			window->state = state;
+			window->motion_time = time;
+			core->motion_func(window, x, y, pressure, core, (void*)&state);
+			break;
+		case 'R':
+			event.type = GDK_BUTTON_RELEASE;
+			event.state = state;
+			event.button = button;
+			event.time = time;
+			window->state &= ~(GDK_BUTTON1_MASK);
+			core->release_func(window, x, y, pressure, core, (void*)&event);
+			break;
+		}
+		latencies[result->num_events] = g_get_monotonic_time() - start;
+		total_time += latencies[result->num_events];
+		result->num_events++;
+	}
+	(void)fclose(fp);
+
+	// ʂ̃sNZf[^̃`FbNT(FNV-1a)
+	checksum = 2166136261u;
+	for(i=0; i<window->active_layer->stride*window->active_layer->height; i++)
+	{
+		checksum = (checksum ^ window->active_layer->pixels[i]) * 16777619u;
+	}
+	result->checksum = checksum;
+
+	result->num_dabs = core->num_dabs;
+	result->total_time = total_time * 0.000001;
+	if(total_time > 0)
+	{
+		result->events_per_second = result->num_events / result->total_time;
+		result->dabs_per_second = result->num_dabs / result->total_time;
+	}
+
+	if(result->num_events > 0)
+	{
+		qsort(latencies, result->num_events, sizeof(*latencies), CompareStrokeLatency);
+		result->latency[0] = latencies[(result->num_events - 1) * 50 / 100] * 0.001;
+		result->latency[1] = latencies[(result->num_events - 1) * 90 / 100] * 0.001;
+		result->latency[2] = latencies[(result->num_events - 1) * 99 / 100] * 0.001;
+		result->latency[3] = latencies[result->num_events - 1] * 0.001;
+	}
+	MEM_FREE_FUNC(latencies);
+
+	return 0;
+}
+
+/**********************************************************
+* StrokeReplayMain֐                                    *
+* EBhE\ɋL^͂Đ            *
+* vʂWo͂ɏo                            *
+* (R}hC : L^t@C [uV [L^̔ԍ]]) *
+*                                                     *
+* app	: AvP[VǗ\̂̃AhX      *
+* argc	: R}hC̐                          *
+* argv	: R}hC                              *
+* Ԃl                                                  *
+*	I:0	s:1                                    *
+**********************************************************/
+int StrokeReplayMain(APPLICATION* app, int argc, char** argv)
+{
+	// ĐɎgLoX
+	DRAW_WINDOW *canvas;
+	// ͂uV
+	BRUSH_CORE *core = app->tool_window.active_brush[app->input];
+	// v
+	STROKE_REPLAY_RESULT result;
+	// L^̃LoX̃TCYǂݍޗp
+	FILE *fp;
+	int width, height;
+	// ĐL^̔ԍ
+	int section = 0;
+	// R}hCŎw肳ꂽuV̖O
+	gchar *brush_name;
+	// forp̃JE^
+	int x, y;
+
+	if(argc < 2)
+	{
+		(void)fprintf(stderr, "Usage : %s record_file [brush_name|- [section]]\n", argv[0]);
+		return 1;
+	}
+
+	// ǋLꂽL^͐擪0, 1, 2...̔ԍŎw肷
+	if(argc > 3)
+	{
+		section = atoi(argv[3]);
+	}
+
+	if((fp = OpenStrokeRecordSection(argv[1], section, &width, &height)) == NULL)
+	{
+		(void)fprintf(stderr, "%s has no stroke record %d\n", argv[1], section);
+		return 1;
+	}
+	(void)fclose(fp);
+
+	// uVw肳ĂΖOŒT(u-vȂI𒆂̃uV)
+	if(argc > 2 && strcmp(argv[2], "-") != 0)
+	{
+		brush_name = g_locale_to_utf8(argv[2], -1, NULL, NULL, NULL);
+		core = NULL;
+		for(y=0; y<BRUSH_TABLE_HEIGHT && core == NULL; y++)
+		{
+			for(x=0; x<BRUSH_TABLE_WIDTH; x++)
+			{
+				if(app->tool_window.brushes[y][x].name != NULL && brush_name != NULL
+					&& strcmp(app->tool_window.brushes[y][x].name, brush_name) == 0)
+				{
+					core = &app->tool_window.brushes[y][x];
+					break;
+				}
+			}
+		}
+		g_free(brush_name);
+
+		if(core == NULL)
+		{
+			(void)fprintf(stderr, "Brush %s is not found\n", argv[2]);
+			return 1;
+		}
+	}
+
+	// uVvr[Ɠ\ȂLoX쐬
+	canvas = CreateTempDrawWindow(width, height, 4, NULL, NULL, 0, app);
+	canvas->layer = canvas->active_layer = CreateLayer(0, 0, canvas->width, canvas->height,
+		4, TYPE_NORMAL_LAYER, NULL, NULL, "Replay", canvas);
+	// ʍXV̗v󂯎邾̃EBWFbg(\͂Ȃ)
+	canvas->window = gtk_drawing_area_new();
+
+	if(ReplayStrokeRecord(canvas, core, argv[1], section, &result) != 0)
+	{
+		(void)fprintf(stderr, "Failed to replay %s\n", argv[1]);
+		return 1;
+	}
+	ReleaseHistory(&canvas->history);
+
+	(void)printf("%s (record %d) : %d events, %u dabs, %f sec\n",
+		core->name, section, result.num_events, result.num_dabs, result.total_time);
+	(void)printf("%f events/sec, %f dabs/sec\n", result.events_per_second, result.dabs_per_second);
+	(void)printf("latency (ms) 50%%:%f 90%%:%f 99%%:%f max:%f\n",
+		result.latency[0], result.latency[1], result.latency[2], result.latency[3]);
+	(void)printf("checksum : %08x\n", result.checksum);
+
+	return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
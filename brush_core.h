@@ -1,6 +1,7 @@
 #ifndef _INCLUDED_BRUSH_CORE_H_
 #define _INCLUDED_BRUSH_CORE_H_
 
+#include <stdio.h>
 #include <gtk/gtk.h>
 #include "layer.h"
 #include "draw_window.h"
@@ -15,6 +16,27 @@ extern "C" {
 #define MIN_BRUSH_STEP (FLOAT_T)(BRUSH_STEP * MINIMUM_PRESSURE)
 #define BRUSH_UPDATE_MARGIN 7
 
+// ~`uV̉摜̃LbVɕێő吔
+#define BRUSH_DAB_CACHE_SIZE 64
+// ~`uV̉摜̃LbVɎgőoCg
+#define BRUSH_DAB_CACHE_MAX_BYTES (16 * 1024 * 1024)
+// LbV~`uV̔a̍(1sNZ̒i)
+#define BRUSH_DAB_RADIUS_STEPS 4
+// ܂Ƃ߂ĕ`悷~`uV̍ő吔
+#define BRUSH_STAMP_BATCH_SIZE 256
+// 摜uṼLbVɕێ]ς݉摜̍ő吔
+#define BRUSH_IMAGE_CACHE_SIZE 64
+// 摜uṼLbVɎgőoCg
+#define BRUSH_IMAGE_CACHE_MAX_BYTES (32 * 1024 * 1024)
+// 摜uV̉]p̕
+#define BRUSH_IMAGE_ANGLE_STEPS 256
+// 摜uV̏k摜̍ői
+#define BRUSH_IMAGE_MAX_LEVELS 12
+// xɐUz̍ő吔
+#define BRUSH_SCATTER_MAX_DABS 256
+// uV̓͂̋L^t@C̐擪s
+#define STROKE_RECORD_HEADER "KABURAGI_STROKE_RECORD 1"
+
 typedef enum _eBRUSH_SHAPE
 {
 	BRUSH_SHAPE_CIRCLE,
@@ -53,6 +75,69 @@ typedef void (*brush_core_func)(DRAW_WINDOW* window, gdouble x, gdouble y,
 
 typedef void (*brush_update_func)(DRAW_WINDOW* window, gdouble x, gdouble y, void* data);
 
+/**************************************
+* BRUSH_DAB\                     *
+* LbV~`uV̉摜1 *
+**************************************/
+typedef struct _BRUSH_DAB
+{
+	cairo_surface_t *surface;	// Ft~`摜
+	uint8 *pixels;				// surfacẽsNZf[^
+	int radius_key;				// ʎqa
+	int hardness_key;			// ʎq֊s̍d
+	int blur_key;				// ʎq{P
+	int data_size;				// sNZf[^̃oCg
+	unsigned int last_used;		// ŌɎgp(LRUp)
+} BRUSH_DAB;
+
+/***************************************************
+* BRUSH_DAB_CACHE\                            *
+* MŃTCY̕ς~`uV̉摜̃LbV *
+***************************************************/
+typedef struct _BRUSH_DAB_CACHE
+{
+	BRUSH_DAB dabs[BRUSH_DAB_CACHE_SIZE];
+	int num_dabs;
+	int total_size;
+	unsigned int counter;
+	// ݂̉~`uV̐ݒ
+	FLOAT_T r, outline_hardness, blur, alpha;
+	uint8 color[3];
+} BRUSH_DAB_CACHE;
+
+/******************************************
+* BRUSH_IMAGE\                       *
+* LbV]ς݂̃uV摜1 *
+******************************************/
+typedef struct _BRUSH_IMAGE
+{
+	cairo_surface_t *surface;	// ]ς݂̉摜
+	cairo_pattern_t *pattern;	// `p̃p^[
+	uint8 *pixels;				// surfacẽsNZf[^
+	int level;					// ɂk摜̒i
+	int angle_key;				// ʎq]p
+	int data_size;				// sNZf[^̃oCg
+	unsigned int last_used;		// ŌɎgp(LRUp)
+} BRUSH_IMAGE;
+
+/*************************************************
+* BRUSH_IMAGE_CACHE\                        *
+* 摜uV̏k摜Ɖ]ς݉摜̃LbV *
+*************************************************/
+typedef struct _BRUSH_IMAGE_CACHE
+{
+	// LbV쐬̉摜
+	cairo_surface_t *source;
+	// 1/2k摜(0iڂ͌̉摜)
+	cairo_surface_t *levels[BRUSH_IMAGE_MAX_LEVELS];
+	uint8 *level_pixels[BRUSH_IMAGE_MAX_LEVELS];
+	int num_levels;
+	BRUSH_IMAGE images[BRUSH_IMAGE_CACHE_SIZE];
+	int num_images;
+	int total_size;
+	unsigned int counter;
+} BRUSH_IMAGE_CACHE;
+
 typedef struct _BRUSH_CORE
 {
 	struct _APPLICATION *app;
@@ -67,6 +152,12 @@ typedef struct _BRUSH_CORE
 	cairo_t *temp_cairo;
 	uint8 **brush_pattern_buff, **temp_pattern_buff;
 	int stride;
+	// MŃTCY̕ς~`uV̉摜̃LbV
+	BRUSH_DAB_CACHE *dab_cache;
+	// 摜uV̏kE]ς݉摜̃LbV
+	BRUSH_IMAGE_CACHE *image_cache;
+	// `悵uV̐(\vp)
+	unsigned int num_dabs;
 
 	gchar *name;
 	char *image_file_path;
@@ -106,6 +197,87 @@ typedef struct _BRUSH_UPDATE_AREA
 	int initialized;
 } BRUSH_UPDATE_AREA;
 
+/****************************************
+* BRUSH_STAMP\                     *
+* ܂Ƃ߂ĕ`悷~`uV1̏ *
+****************************************/
+typedef struct _BRUSH_STAMP
+{
+	FLOAT_T x, y;				// `͈͂̍̍W
+	FLOAT_T zoom;				// gEk
+	FLOAT_T alpha;				// sx
+	int start_x, start_y;		// `͈͂̍̍W()
+	int width, height;			// `͈͂̕A
+	int anti_alias;				// A`GCAXsۂ
+} BRUSH_STAMP;
+
+/******************************************************
+* BRUSH_STAMP_BATCH\                             *
+* 1̃}EẌړŕ`悷~`uV܂Ƃ߂ *
+******************************************************/
+typedef struct _BRUSH_STAMP_BATCH
+{
+	BRUSH_STAMP stamps[BRUSH_STAMP_BATCH_SIZE];
+	int num_stamps;
+	// \񂵂uVŜ͈̔
+	int min_x, min_y, max_x, max_y;
+	// A`GCAXsuV邩ۂ
+	int anti_alias;
+	// 摜uV̏ꍇ͕`ɎgkE]ς݂̉摜(~`uVNULL)
+	BRUSH_IMAGE *image;
+} BRUSH_STAMP_BATCH;
+
+/*******************************************************
+* BRUSH_SCATTER\                                  *
+* Xg[NɌ܂ŎUz𐶐邽߂̏ *
+*******************************************************/
+typedef struct _BRUSH_SCATTER
+{
+	uint32 seed;				// Xg[N̗̎
+	uint32 num_generated;		// Xg[NɐUz̐
+} BRUSH_SCATTER;
+
+/**************************
+* BRUSH_SCATTER_DAB\ *
+* Uz1̏ *
+**************************/
+typedef struct _BRUSH_SCATTER_DAB
+{
+	FLOAT_T x, y;				// S̍W
+	FLOAT_T zoom;				// g嗦
+	FLOAT_T flow;				// Zx
+} BRUSH_SCATTER_DAB;
+
+/*****************************************************
+* STROKE_RECORD\                                *
+* uVɓnꂽ͂t@C֋L^邽߂̏ *
+*****************************************************/
+typedef struct _STROKE_RECORD
+{
+	FILE *fp;				// L^̃t@C
+	gint64 start_time;		// L^Jn(}CNb)
+	int num_events;			// L^͂̐
+	// L^p̊֐ɍւĂuVƍւO̊֐
+	BRUSH_CORE *core;
+	brush_core_func press_func, motion_func, release_func;
+} STROKE_RECORD;
+
+/*************************************
+* STROKE_REPLAY_RESULT\         *
+* L^͂Đۂ̌v *
+*************************************/
+typedef struct _STROKE_REPLAY_RESULT
+{
+	int num_events;				// Đ͂̐
+	unsigned int num_dabs;		// `悵uV̐
+	FLOAT_T total_time;			// uV̏ɂ(b)
+	FLOAT_T events_per_second;	// 1bɏ͂̐
+	FLOAT_T dabs_per_second;	// 1bɕ`悵uV̐
+	// 1̓͂̏(~bA50%A90%A99%_ƍől)
+	FLOAT_T latency[4];
+	uint32 checksum;			// Đ̃ANeBuC[̃`FbNT
+} STROKE_REPLAY_RESULT;
+
 EXTERN void ChangeBrush(
 	BRUSH_CORE* core,
 	void* brush_data,
@@ -170,6 +342,61 @@ EXTERN void BrushCoreSetGrayCirclePattern(
 	FLOAT_T alpha
 );
 
+/**************************************************************
+* BrushCoreSetCircleDabSource֐                             *
+* MŕωTCỶ~`uV\[Xɐݒ肷          *
+*                                                         *
+* core		: uV̊{                                *
+* cairo_p	: \[Xݒ肷Cairo                       *
+* zoom		: uV̉摜̊gk(̔a/`悷锼a) *
+**************************************************************/
+EXTERN void BrushCoreSetCircleDabSource(
+	BRUSH_CORE* core,
+	cairo_t* cairo_p,
+	FLOAT_T zoom
+);
+
+/*****************************************
+* ReleaseBrushDabCache֐               *
+* ~`uV̉摜̃LbVJ *
+*                                    *
+* core	: uV̊{               *
+*****************************************/
+EXTERN void ReleaseBrushDabCache(BRUSH_CORE* core);
+
+/***********************************
+* ReleaseBrushImageCache֐       *
+* 摜uṼLbVJ *
+*                              *
+* core	: uV̊{         *
+***********************************/
+EXTERN void ReleaseBrushImageCache(BRUSH_CORE* core);
+
+/************************************************************
+* SetStampImageSource֐                                   *
+* X^vnc[̉摜LbV]ς݂̉摜  *
+* \[Xɐݒ肷(̊gkE]̑Ɏg)      *
+*                                                       *
+* core		: uV̊{                              *
+* source	: X^v̉摜                                *
+* cairo_p	: \[Xݒ肷Cairo                     *
+* zoom		: `1sNŽ摜̃sNZ     *
+* angle		: 摜̊px                                    *
+* trans_x	: ]Ỏ摜̍uXW                 *
+* trans_y	: ]Ỏ摜̍uYW                 *
+* Ԃl                                                    *
+*	ݒłTRUEAłȂFALSE                     *
+************************************************************/
+EXTERN int SetStampImageSource(
+	BRUSH_CORE* core,
+	cairo_surface_t* source,
+	cairo_t* cairo_p,
+	FLOAT_T zoom,
+	FLOAT_T angle,
+	FLOAT_T trans_x,
+	FLOAT_T trans_y
+);
+
 EXTERN void BrushCoreUndoRedo(DRAW_WINDOW* window, void* p);
 
 /*****************************************************
@@ -226,6 +453,199 @@ EXTERN void DrawCircleBrushWorkLayer(
 	gdouble alpha
 );
 
+/*******************************************************
+* BeginWorkLayerTiles֐                              *
+* ƃC[̕`͈͂̃^CPʂł̋L^Jn *
+* (uṼ{^̃R[obN֐ŌĂ)   *
+*                                                  *
+* window	: LoX̏                         *
+*******************************************************/
+EXTERN void BeginWorkLayerTiles(DRAW_WINDOW* window);
+
+/***********************************************
+* AddWorkLayerTiles֐                        *
+* ƃC[ɕ`悵͈͂̃^CL^ *
+*                                          *
+* window	: LoX̏                 *
+* x		: `͈͂̍XW                *
+* y		: `͈͂̍YW                *
+* width	: `͈͂̕                         *
+* height	: `͈͂̍                   *
+***********************************************/
+EXTERN void AddWorkLayerTiles(
+	DRAW_WINDOW* window,
+	int x,
+	int y,
+	int width,
+	int height
+);
+
+/***************************************************************
+* CommitWorkLayerTiles֐                                     *
+* ƃC[̕`悵^Ĉ݂C[ɍď *
+* (L^̏I͑ČĂяoClearWorkLayerōs)             *
+*                                                          *
+* window	: LoX̏                                 *
+* target	: ̃C[                                 *
+* Ԃl                                                       *
+*	I:0	s:̒l(^CL^ĂȂ)            *
+***************************************************************/
+EXTERN int CommitWorkLayerTiles(DRAW_WINDOW* window, LAYER* target);
+
+/*****************************************************
+* ClearWorkLayer֐                                 *
+* ƃC[                             *
+* (^CL^ĂΕ`悵^Ĉݏ) *
+*                                                *
+* window	: LoX̏                       *
+*****************************************************/
+EXTERN void ClearWorkLayer(DRAW_WINDOW* window);
+
+/*********************************************************
+* ResetWorkLayerTiles֐                                *
+* ÕXg[Ñ^C̋L^cĂ             *
+* L^^CċL^I                 *
+* ({^ăuVɓnOɌĂяo)               *
+*                                                    *
+* window	: LoX̏                           *
+*********************************************************/
+EXTERN void ResetWorkLayerTiles(DRAW_WINDOW* window);
+
+/*****************************************
+* InitializeBrushStampBatch֐          *
+* ~`uV܂Ƃ߂ĕ`悷鏀 *
+*                                    *
+* batch	: ܂Ƃ߂ĕ`悷uV̏   *
+*****************************************/
+EXTERN void InitializeBrushStampBatch(BRUSH_STAMP_BATCH* batch);
+
+/**************************************************
+* AddCircleBrushStamp֐                         *
+* ~`uV1܂Ƃ߂ĕ`悷\ɒǉ *
+* (\񂪈tȂ`悵Ăǉ)            *
+*                                             *
+* window		: LoX̏                *
+* core		: uV̊{                    *
+* batch		: ܂Ƃ߂ĕ`悷uV̏        *
+* x			: `͈͂̍XW               *
+* y			: `͈͂̍YW               *
+* start_x		: `͈͂̍XW()     *
+* start_y		: `͈͂̍YW()     *
+* width		: `͈͂̕                        *
+* height		: `͈͂̍                  *
+* zoom		: gEk                        *
+* alpha		: sx                            *
+* anti_alias	: A`GCAXsۂ    *
+**************************************************/
+EXTERN void AddCircleBrushStamp(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch,
+	gdouble x,
+	gdouble y,
+	int start_x,
+	int start_y,
+	int width,
+	int height,
+	gdouble zoom,
+	gdouble alpha,
+	int anti_alias
+);
+
+/*****************************************************
+* FlushCircleBrushStamps֐                         *
+* \񂵂~`uVƃC[ɂ܂Ƃ߂ĕ`悷 *
+*                                                *
+* window	: LoX̏                       *
+* core	: uV̊{                           *
+* batch	: ܂Ƃ߂ĕ`悷uV̏               *
+*****************************************************/
+EXTERN void FlushCircleBrushStamps(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch
+);
+
+/*****************************************************
+* AddImageBrushStamp֐                             *
+* 摜uV1܂Ƃ߂ĕ`悷\ɒǉ    *
+* (kE]ς݂̉摜gȂ΂ɕ`悷) *
+*                                                *
+* window			: LoX̏               *
+* core			: uV̊{                   *
+* batch			: ܂Ƃ߂ĕ`悷uV̏       *
+* x				: `͈͂̒SXW                *
+* y				: `͈͂̒SYW                *
+* start_x			: `͈͂̍XW          *
+* start_y			: `͈͂̍YW          *
+* width			: `͈͂̕                       *
+* height			: `͈͂̍                 *
+* scale			: `悷g嗦                     *
+* size			: 摜̒ӂ̒                   *
+* angle			: 摜̊px                         *
+* image_width		: 摜̕                       *
+* image_height	: 摜̍                         *
+* alpha			: Zx                               *
+* anti_alias		: A`GCAXsۂ   *
+*****************************************************/
+EXTERN void AddImageBrushStamp(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	BRUSH_STAMP_BATCH* batch,
+	gdouble x,
+	gdouble y,
+	int start_x,
+	int start_y,
+	int width,
+	int height,
+	gdouble scale,
+	gdouble size,
+	gdouble angle,
+	gdouble image_width,
+	gdouble image_height,
+	gdouble alpha,
+	int anti_alias
+);
+
+/*********************************************
+* InitializeBrushScatter֐                 *
+* Xg[N̊JnɎUz̗̎߂ *
+*                                        *
+* scatter	: Uz̏                     *
+* time	: Xg[NJn           *
+* x		: Xg[NJnXW          *
+* y		: Xg[NJnYW          *
+*********************************************/
+EXTERN void InitializeBrushScatter(BRUSH_SCATTER* scatter, guint32 time, FLOAT_T x, FLOAT_T y);
+
+/*************************************************************
+* GenerateBrushScatterDabs֐                               *
+* Xg[N̗̎킩Uz̈ʒuATCYAZx𐶐 *
+*                                                        *
+* scatter		: Uz̏                                 *
+* x			: Uz̒SXW                                *
+* y			: Uz̒SYW                                *
+* range		: Uz͈                                   *
+* size		: UzTCY                                     *
+* random_size	: UzTCỸ_                     *
+* random_flow	: UzZx̃_                       *
+* alpha		: Uz̊̔Zx                               *
+* num_dabs	: 鐔                                     *
+* dabs		: ʂi[z                         *
+*************************************************************/
+EXTERN void GenerateBrushScatterDabs(
+	BRUSH_SCATTER* scatter,
+	FLOAT_T x,
+	FLOAT_T y,
+	FLOAT_T range,
+	FLOAT_T size,
+	FLOAT_T random_size,
+	FLOAT_T random_flow,
+	FLOAT_T alpha,
+	int num_dabs,
+	BRUSH_SCATTER_DAB* dabs
+);
+
 /*************************************************
 * DrawImageBrush֐                             *
 * 摜uV}XNC[ɕ`悷           *
@@ -585,6 +1005,70 @@ EXTERN void BlendWaterBrush(
 	uint8 extend
 );
 
+/***************************************************
+* StartStrokeRecord֐                            *
+* uVɓn͂̃t@Cւ̋L^Jn *
+* (Ƀt@CΖɒǋL)             *
+*                                              *
+* window		: `̈̏                   *
+* file_path	: L^̃t@C̃pX               *
+* Ԃl                                           *
+*	I:0	s:̒l                        *
+***************************************************/
+EXTERN int StartStrokeRecord(DRAW_WINDOW* window, const char* file_path);
+
+/***************************************
+* StopStrokeRecord֐                 *
+* uVɓn͂̋L^I *
+*                                  *
+* window	: `̈̏           *
+***************************************/
+EXTERN void StopStrokeRecord(DRAW_WINDOW* window);
+
+/*******************************************************
+* BeginRecordStroke֐                                *
+* L^ł΃uV̊֐L^p̂̂ɍւ *
+* (Xg[NIɌɖ߂)                         *
+*                                                  *
+* window	: `̈̏                           *
+* core	: ꂩgpuV                       *
+*******************************************************/
+EXTERN void BeginRecordStroke(DRAW_WINDOW* window, BRUSH_CORE* core);
+
+/*****************************************************
+* ReplayStrokeRecord֐                             *
+* L^͂uVɓnďԂv *
+*                                                *
+* window		: `̈̏                     *
+* core		: ͂uV                   *
+* file_path	: L^t@C̃pX                 *
+* section	: ĐL^Ԗڂ(0)          *
+* result		: vʂi[\̂̃AhX *
+* Ԃl                                             *
+*	I:0	s:̒l                          *
+*****************************************************/
+EXTERN int ReplayStrokeRecord(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	const char* file_path,
+	int section,
+	STROKE_REPLAY_RESULT* result
+);
+
+/**********************************************************
+* StrokeReplayMain֐                                    *
+* EBhE\ɋL^͂Đ            *
+* vʂWo͂ɏo                            *
+* (R}hC : L^t@C [uV [L^̔ԍ]]) *
+*                                                     *
+* app	: AvP[VǗ\̂̃AhX      *
+* argc	: R}hC̐                          *
+* argv	: R}hC                              *
+* Ԃl                                                  *
+*	I:0	s:1                                    *
+**********************************************************/
+EXTERN int StrokeReplayMain(struct _APPLICATION* app, int argc, char** argv);
+
 #ifdef __cplusplus
 }
 #endif
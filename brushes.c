@@ -58,7 +58,7 @@ static void DefaultReleaseCallBack(
 
 		window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->active_layer);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -79,7 +79,7 @@ static void DefaultEditSelectionReleaseCallBack(
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 		window->selection->layer_mode = SELECTION_BLEND_NORMAL;
@@ -132,6 +132,8 @@ static void PencilPressCallBack(
 
 		// ƃC[̍@ݒ
 		window->work_layer->layer_mode = pen->blend_mode;
+		// `悵^Ĉ݂Eł悤ɋL^
+		BeginWorkLayerTiles(window);
 
 		// ŒM̃`FbN
 		if(pressure < pen->minimum_pressure)
@@ -195,6 +197,7 @@ static void PencilPressCallBack(
 		// ݂̍W̍őEŏlLĂ
 		core->min_x = min_x, core->min_y = min_y;
 		core->max_x = max_x, core->max_y = max_y;
+		AddWorkLayerTiles(window, start_x - 1, start_y - 1, (int)window->update.width + 3, height + 3);
 
 		// ƃC[̕`e̍@ʏɂĂ
 		cairo_set_operator(window->work_layer->cairo_p, CAIRO_OPERATOR_OVER);
@@ -206,16 +209,12 @@ static void PencilPressCallBack(
 			{
 				if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(update, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, update, zoom);
 					cairo_paint_with_alpha(update, alpha);
 				}
 				else
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0,0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -228,9 +227,7 @@ static void PencilPressCallBack(
 			{
 				if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0, 0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -244,9 +241,7 @@ static void PencilPressCallBack(
 						window->temp_layer->surface_p, start_x, start_y, r*2+1, r*2+1);
 					cairo_t *update_temp = cairo_create(temp_surface);
 
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0, 0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -292,16 +287,12 @@ static void PencilPressCallBack(
 			{
 				if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(update_temp, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, update_temp, zoom);
 					cairo_paint_with_alpha(update_temp, alpha);
 				}
 				else
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0, 0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -319,9 +310,7 @@ static void PencilPressCallBack(
 			{
 				if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0, 0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -342,9 +331,7 @@ static void PencilPressCallBack(
 				}
 				else
 				{
-					cairo_matrix_init_scale(&matrix, zoom, zoom);
-					cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-					cairo_set_source(core->temp_cairo, core->brush_pattern);
+					BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 					cairo_paint_with_alpha(core->temp_cairo, alpha);
 					cairo_matrix_init_translate(&matrix, 0, 0);
 					cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -557,6 +544,9 @@ static void PencilMotionCallBack(
 				goto skip_draw;
 			}
 
+			// ƃC[ɕ`悷^CL^(A`GCAX͈̔͂܂)
+			AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 			update_surface = cairo_surface_create_for_rectangle(
 				window->mask_temp->surface_p, draw_x - r, draw_y - r,
 					r*2+2, r*2+2);
@@ -579,16 +569,12 @@ static void PencilMotionCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(update, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, update, zoom);
 						cairo_paint_with_alpha(update, alpha);
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -601,9 +587,7 @@ static void PencilMotionCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -617,9 +601,7 @@ static void PencilMotionCallBack(
 							window->temp_layer->surface_p, start_x, start_y, r*2+1, r*2+1);
 						cairo_t *update_temp = cairo_create(temp_surface);
 
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -657,16 +639,12 @@ static void PencilMotionCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(update, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, update, zoom);
 						cairo_paint_with_alpha(update, alpha);
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -692,9 +670,7 @@ static void PencilMotionCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -717,9 +693,7 @@ static void PencilMotionCallBack(
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -831,17 +805,22 @@ static void PencilReleaseCallBack(
 	{
 		AddBrushHistory(core, window->active_layer);
 
-		window->update.surface_p = cairo_surface_create_for_rectangle(
-			window->active_layer->surface_p, window->update.x, window->update.y,
-				window->update.width, window->update.height);
-		window->update.cairo_p = cairo_create(window->update.surface_p);
+		// `悵^Ĉ݂łȂΕ`͈͑Ŝ
+		if(CommitWorkLayerTiles(window, window->active_layer) < 0)
+		{
+			window->update.surface_p = cairo_surface_create_for_rectangle(
+				window->active_layer->surface_p, window->update.x, window->update.y,
+					window->update.width, window->update.height);
+			window->update.cairo_p = cairo_create(window->update.surface_p);
+			window->update.target = window->active_layer;
 
-		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
+			window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+			cairo_surface_destroy(window->update.surface_p);
+			cairo_destroy(window->update.cairo_p);
+		}
 
-		cairo_surface_destroy(window->update.surface_p);
-		cairo_destroy(window->update.cairo_p);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -1207,6 +1186,8 @@ static void HardPenButtonPressCallBack(
 
 		// ƃC[̍@ݒ
 		window->work_layer->layer_mode = pen->blend_mode;
+		// `悵^Ĉ݂Eł悤ɋL^
+		BeginWorkLayerTiles(window);
 
 		// ŒM̃`FbN
 		if(pressure < pen->minimum_pressure)
@@ -1279,6 +1260,7 @@ static void HardPenButtonPressCallBack(
 		// ݂̍W̍őEŏlLĂ
 		core->min_x = min_x, core->min_y = min_y;
 		core->max_x = max_x, core->max_y = max_y;
+		AddWorkLayerTiles(window, start_x, start_y, width, height);
 
 		// ƃC[̕`e̍@ʏɂĂ
 		cairo_set_operator(window->work_layer->cairo_p, CAIRO_OPERATOR_OVER);
@@ -1682,6 +1664,9 @@ static void HardPenMotionCallBack(
 				goto skip_draw;
 			}
 
+			// ƃC[ɕ`悷^CL^(A`GCAX͈̔͂܂)
+			AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 			window->flags |= DRAW_WINDOW_UPDATE_PART;
 
 			// `GA0
@@ -1936,17 +1921,22 @@ static void HardPenButtonReleaseCallBack(
 	{
 		AddBrushHistory(core, window->active_layer);
 
-		window->update.surface_p = cairo_surface_create_for_rectangle(
-			window->active_layer->surface_p, window->update.x, window->update.y,
-				window->update.width, window->update.height);
-		window->update.cairo_p = cairo_create(window->update.surface_p);
+		// `悵^Ĉ݂łȂΕ`͈͑Ŝ
+		if(CommitWorkLayerTiles(window, window->active_layer) < 0)
+		{
+			window->update.surface_p = cairo_surface_create_for_rectangle(
+				window->active_layer->surface_p, window->update.x, window->update.y,
+					window->update.width, window->update.height);
+			window->update.cairo_p = cairo_create(window->update.surface_p);
+			window->update.target = window->active_layer;
 
-		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
+			window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+			cairo_surface_destroy(window->update.surface_p);
+			cairo_destroy(window->update.cairo_p);
+		}
 
-		cairo_surface_destroy(window->update.surface_p);
-		cairo_destroy(window->update.cairo_p);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -2267,6 +2257,8 @@ static void AirBrushPressCallBack(
 		int i;	// forp̃JE^
 
 		window->work_layer->layer_mode = brush->blend_mode;
+		// `悵^Ĉ݂Eł悤ɋL^
+		BeginWorkLayerTiles(window);
 
 		if((brush->flags & BRUSH_FLAG_SIZE) == 0)
 		{
@@ -2344,6 +2336,7 @@ static void AirBrushPressCallBack(
 			{
 				return;
 			}
+			AddWorkLayerTiles(window, start_x, start_y, width, height);
 
 			for(i=0; i<height; i++)
 			{
@@ -2360,16 +2353,12 @@ static void AirBrushPressCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(update, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, update, zoom);
 						cairo_paint_with_alpha(update, alpha);
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0,0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2382,9 +2371,7 @@ static void AirBrushPressCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2398,9 +2385,7 @@ static void AirBrushPressCallBack(
 							window->temp_layer->surface_p, start_x, start_y, r*2+1, r*2+1);
 						cairo_t *update_temp = cairo_create(temp_surface);
 
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2438,16 +2423,12 @@ static void AirBrushPressCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(update, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, update, zoom);
 						cairo_paint_with_alpha(update, alpha);
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2473,9 +2454,7 @@ static void AirBrushPressCallBack(
 				{
 					if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2498,9 +2477,7 @@ static void AirBrushPressCallBack(
 					}
 					else
 					{
-						cairo_matrix_init_scale(&matrix, zoom, zoom);
-						cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-						cairo_set_source(core->temp_cairo, core->brush_pattern);
+						BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 						cairo_paint_with_alpha(core->temp_cairo, alpha);
 						cairo_matrix_init_translate(&matrix, 0, 0);
 						cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2804,6 +2781,9 @@ static void AirBrushMotionCallBack(
 								goto skip_draw;
 							}
 
+							// ƃC[ɕ`悷^CL^(A`GCAX͈̔͂܂)
+							AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 							update_surface = cairo_surface_create_for_rectangle(
 								window->mask_temp->surface_p, draw_x - r, draw_y - r,
 									r*2+1, r*2+1);
@@ -2826,16 +2806,12 @@ static void AirBrushMotionCallBack(
 								{
 									if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(update, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, update, zoom);
 										cairo_paint_with_alpha(update, alpha);
 									}
 									else
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2848,9 +2824,7 @@ static void AirBrushMotionCallBack(
 								{
 									if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2864,9 +2838,7 @@ static void AirBrushMotionCallBack(
 											window->temp_layer->surface_p, start_x, start_y, r*2+1, r*2+1);
 										cairo_t *update_temp = cairo_create(temp_surface);
 
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2904,16 +2876,12 @@ static void AirBrushMotionCallBack(
 								{
 									if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(update, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, update, zoom);
 										cairo_paint_with_alpha(update, alpha);
 									}
 									else
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2939,9 +2907,7 @@ static void AirBrushMotionCallBack(
 								{
 									if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -2964,9 +2930,7 @@ static void AirBrushMotionCallBack(
 									}
 									else
 									{
-										cairo_matrix_init_scale(&matrix, zoom, zoom);
-										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-										cairo_set_source(core->temp_cairo, core->brush_pattern);
+										BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 										cairo_paint_with_alpha(core->temp_cairo, alpha);
 										cairo_matrix_init_translate(&matrix, 0, 0);
 										cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3269,6 +3233,9 @@ static void AirBrushReleaseCallBack(
 						goto skip_draw;
 					}
 
+					// ƃC[ɕ`悷^CL^(A`GCAX͈̔͂܂)
+					AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 					update_surface = cairo_surface_create_for_rectangle(
 						window->mask_temp->surface_p, draw_x - r, draw_y - r,
 							r*2+1, r*2+1);
@@ -3308,16 +3275,12 @@ static void AirBrushReleaseCallBack(
 						{
 							if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(update, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, update, zoom);
 								cairo_paint_with_alpha(update, alpha);
 							}
 							else
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3330,9 +3293,7 @@ static void AirBrushReleaseCallBack(
 						{
 							if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3346,9 +3307,7 @@ static void AirBrushReleaseCallBack(
 									window->temp_layer->surface_p, start_x, start_y, r*2+1, r*2+1);
 								cairo_t *update_temp = cairo_create(temp_surface);
 
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3386,16 +3345,12 @@ static void AirBrushReleaseCallBack(
 						{
 							if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(update, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, update, zoom);
 								cairo_paint_with_alpha(update, alpha);
 							}
 							else
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3421,9 +3376,7 @@ static void AirBrushReleaseCallBack(
 						{
 							if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3446,9 +3399,7 @@ static void AirBrushReleaseCallBack(
 							}
 							else
 							{
-								cairo_matrix_init_scale(&matrix, zoom, zoom);
-								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-								cairo_set_source(core->temp_cairo, core->brush_pattern);
+								BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 								cairo_paint_with_alpha(core->temp_cairo, alpha);
 								cairo_matrix_init_translate(&matrix, 0, 0);
 								cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3549,15 +3500,20 @@ skip_draw:
 
 		AddBrushHistory(core, window->active_layer);
 
-		window->update.surface_p = cairo_surface_create_for_rectangle(
-			window->active_layer->surface_p, window->update.x, window->update.y,
-				window->update.width, window->update.height);
-		window->update.cairo_p = cairo_create(window->update.surface_p);
-		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
-		cairo_surface_destroy(window->update.surface_p);
-		cairo_destroy(window->update.cairo_p);
+		// `悵^Ĉ݂łȂΕ`͈͑Ŝ
+		if(CommitWorkLayerTiles(window, window->active_layer) < 0)
+		{
+			window->update.surface_p = cairo_surface_create_for_rectangle(
+				window->active_layer->surface_p, window->update.x, window->update.y,
+					window->update.width, window->update.height);
+			window->update.cairo_p = cairo_create(window->update.surface_p);
+			window->update.target = window->active_layer;
+			window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
+			cairo_surface_destroy(window->update.surface_p);
+			cairo_destroy(window->update.cairo_p);
+		}
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 		window->flags |= DRAW_WINDOW_UPDATE_PART;
@@ -3756,6 +3712,9 @@ static void AirBrushEditSelectionReleaseCallBack(
 						goto skip_draw;
 					}
 
+					// ƃC[ɕ`悷^CL^(A`GCAX͈̔͂܂)
+					AddWorkLayerTiles(window, start_x - 1, start_y - 1, width + 3, height + 3);
+
 					for(i=0; i<height; i++)
 					{
 						(void)memset(&window->mask_temp->pixels[(i+start_y)*window->mask_temp->stride+start_x*4],
@@ -3777,9 +3736,7 @@ static void AirBrushEditSelectionReleaseCallBack(
 						}
 						else
 						{
-							cairo_matrix_init_scale(&matrix, zoom, zoom);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-							cairo_set_source(core->temp_cairo, core->brush_pattern);
+							BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 							cairo_paint_with_alpha(core->temp_cairo, alpha);
 							cairo_matrix_init_translate(&matrix, - draw_x + r, - draw_y + r);
 							cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3792,9 +3749,7 @@ static void AirBrushEditSelectionReleaseCallBack(
 					{
 						if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 						{
-							cairo_matrix_init_scale(&matrix, zoom, zoom);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-							cairo_set_source(core->temp_cairo, core->brush_pattern);
+							BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 							cairo_paint_with_alpha(core->temp_cairo, alpha);
 							cairo_matrix_init_translate(&matrix, - draw_x + r, - draw_y + r);
 							cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3804,9 +3759,7 @@ static void AirBrushEditSelectionReleaseCallBack(
 						}
 						else
 						{
-							cairo_matrix_init_scale(&matrix, zoom, zoom);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
-							cairo_set_source(core->temp_cairo, core->brush_pattern);
+							BrushCoreSetCircleDabSource(core, core->temp_cairo, zoom);
 							cairo_paint_with_alpha(core->temp_cairo, alpha);
 							cairo_matrix_init_translate(&matrix, - draw_x + r, - draw_y + r);
 							cairo_pattern_set_matrix(core->temp_pattern, &matrix);
@@ -3893,7 +3846,7 @@ skip_draw:
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}	// }EX̍{^Ȃ
@@ -6011,11 +5964,12 @@ skip_draw:
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_surface_destroy(window->update.surface_p);
 		cairo_destroy(window->update.cairo_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 		window->flags |= DRAW_WINDOW_UPDATE_PART;
@@ -6351,7 +6305,7 @@ skip_draw:
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}	// }EX̍{^Ȃ
@@ -8875,11 +8829,12 @@ static void WaterColorBrushReleaseCallBack(
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_surface_destroy(window->update.surface_p);
 		cairo_destroy(window->update.cairo_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}	// NbNȂ
@@ -9242,7 +9197,7 @@ static void WaterColorBrushEditSelectionReleaseCallBack(
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->selection->layer_mode = SELECTION_BLEND_NORMAL;
 	}	// NbNȂ
@@ -9633,6 +9588,8 @@ static void InitializeStampCore(STAMP_CORE* core, int mode, APPLICATION* app)
 	if((app->flags & APPLICATION_INITIALIZED) != 0 && core->app != NULL)
 	{
 		// uVp^[T[tF[XXV
+			// (AhXɍ蒼ĂÂ摜gȂ悤LbV̂Ă)
+		ReleaseBrushImageCache(core->brush_core);
 		if(core->brush_core->brush_surface != NULL)
 		{
 			cairo_surface_destroy(core->brush_core->brush_surface);
@@ -10585,6 +10542,8 @@ static void StampToolButtonPressCallBack(
 			stamp->core.flow : stamp->core.flow * pressure;
 
 		// ÕX^vT[tF[X폜ĐVɍ쐬
+			// (kE]ς݂̉摜̃LbV蒼)
+		ReleaseBrushImageCache(core);
 		if(stamp->core.brush_surface != NULL)
 		{
 			cairo_surface_destroy(stamp->core.brush_surface);
@@ -10626,17 +10585,23 @@ static void StampToolButtonPressCallBack(
 		trans_x = x - (half_width * cos_x + half_height * sin_y);
 		trans_y = y + (half_width * sin_y - half_height * cos_x);
 		// gkA]pZbg
+			// (kE]ς݂̉摜gȂ΂̏ŊgkE])
 		cairo_set_operator(window->work_layer->cairo_p, CAIRO_OPERATOR_OVER);
-		brush = cairo_pattern_create_for_surface(stamp->core.brush_surface);
-		cairo_pattern_set_extend(brush, CAIRO_EXTEND_NONE);
-		cairo_matrix_init_scale(&matrix, zoom, zoom);
-		cairo_matrix_rotate(&matrix, stamp->core.rotate);
-		cairo_matrix_translate(&matrix,  - trans_x, - trans_y);
+		brush = NULL;
+		if(SetStampImageSource(core, stamp->core.brush_surface, window->work_layer->cairo_p,
+			zoom, stamp->core.rotate, trans_x, trans_y) == FALSE)
+		{
+			brush = cairo_pattern_create_for_surface(stamp->core.brush_surface);
+			cairo_pattern_set_extend(brush, CAIRO_EXTEND_NONE);
+			cairo_matrix_init_scale(&matrix, zoom, zoom);
+			cairo_matrix_rotate(&matrix, stamp->core.rotate);
+			cairo_matrix_translate(&matrix,  - trans_x, - trans_y);
 
-		// ړp̍suVɃZbg
-		cairo_pattern_set_matrix(brush, &matrix);
-		// 쐬uVƃC[ɃZbg
-		cairo_set_source(window->work_layer->cairo_p, brush);
+			// ړp̍suVɃZbg
+			cairo_pattern_set_matrix(brush, &matrix);
+			// 쐬uVƃC[ɃZbg
+			cairo_set_source(window->work_layer->cairo_p, brush);
+		}
 
 		// I͈̗͂Lœhׂ@ύX
 		if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
@@ -10650,7 +10615,10 @@ static void StampToolButtonPressCallBack(
 		}
 
 		// uV폜
-		cairo_pattern_destroy(brush);
+		if(brush != NULL)
+		{
+			cairo_pattern_destroy(brush);
+		}
 
 		// ]pXV
 		stamp->core.rotate += stamp->core.rotate_speed;
@@ -10837,16 +10805,22 @@ static void StampToolMotionCallBack(
 				trans_x = x - (half_width * stamp_cos_x + half_height * stamp_sin_y);
 				trans_y = y + (half_width * stamp_sin_y - half_height * stamp_cos_x);
 				// gkA]pZbg
+					// (kE]ς݂̉摜gȂ΂̏ŊgkE])
 				cairo_set_operator(window->temp_layer->cairo_p, CAIRO_OPERATOR_OVER);
-				brush = cairo_pattern_create_for_surface(stamp->core.brush_surface);
-				cairo_pattern_set_extend(brush, CAIRO_EXTEND_NONE);
-				cairo_matrix_init_scale(&matrix, zoom, zoom);
-				cairo_matrix_rotate(&matrix, stamp->core.rotate);
-				cairo_matrix_translate(&matrix,  - trans_x, - trans_y);
+				brush = NULL;
+				if(SetStampImageSource(core, stamp->core.brush_surface, window->temp_layer->cairo_p,
+					zoom, stamp->core.rotate, trans_x, trans_y) == FALSE)
+				{
+					brush = cairo_pattern_create_for_surface(stamp->core.brush_surface);
+					cairo_pattern_set_extend(brush, CAIRO_EXTEND_NONE);
+					cairo_matrix_init_scale(&matrix, zoom, zoom);
+					cairo_matrix_rotate(&matrix, stamp->core.rotate);
+					cairo_matrix_translate(&matrix,  - trans_x, - trans_y);
 
-				// ړp̍suVɃZbg
-				cairo_pattern_set_matrix(brush, &matrix);
-				cairo_set_source(window->temp_layer->cairo_p, brush);
+					// ړp̍suVɃZbg
+					cairo_pattern_set_matrix(brush, &matrix);
+					cairo_set_source(window->temp_layer->cairo_p, brush);
+				}
 
 				// I͈̗͂Lŏ؂ւ
 				if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) == 0)
@@ -10882,7 +10856,10 @@ static void StampToolMotionCallBack(
 					}
 				}
 
-				cairo_pattern_destroy(brush);
+				if(brush != NULL)
+				{
+					cairo_pattern_destroy(brush);
+				}
 
 skip_draw:
 				dx -= stamp->core.d;
@@ -10913,7 +10890,7 @@ static void StampToolReleaseCallBack(
 
 		window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->active_layer);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -10937,7 +10914,7 @@ static void StampToolEditSelectionReleaseCallBack(
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 		window->selection->layer_mode = SELECTION_BLEND_NORMAL;
@@ -11397,8 +11374,13 @@ static void ImageBrushMotionCallBack(
 							{
 								if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 								{
-									cairo_set_source(update, core->brush_pattern);
-									cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+									// kE]ς݂̉摜gȂ΂̏ŊgkE]
+									if(SetStampImageSource(core, core->brush_surface, update,
+										zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+									{
+										cairo_set_source(update, core->brush_pattern);
+										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+									}
 									cairo_paint_with_alpha(update, alpha);
 								}
 								else
@@ -11850,8 +11832,13 @@ static void ImageBrushReleaseCallBack(
 					{
 						if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 						{
-							cairo_set_source(update, core->brush_pattern);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							// kE]ς݂̉摜gȂ΂̏ŊgkE]
+							if(SetStampImageSource(core, core->brush_surface, update,
+								zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+							{
+								cairo_set_source(update, core->brush_pattern);
+								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							}
 							cairo_paint_with_alpha(update, alpha);
 						}
 						else
@@ -12013,11 +12000,12 @@ skip_draw:
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_destroy(window->update.cairo_p);
 		cairo_surface_destroy(window->update.surface_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -12290,8 +12278,13 @@ static void ImageBrushEditSelectionRelease(
 					{
 						if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 						{
-							cairo_set_source(window->mask_temp->cairo_p, core->brush_pattern);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							// kE]ς݂̉摜gȂ΂̏ŊgkE]
+							if(SetStampImageSource(core, core->brush_surface, window->mask_temp->cairo_p,
+								zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+							{
+								cairo_set_source(window->mask_temp->cairo_p, core->brush_pattern);
+								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							}
 							cairo_paint_with_alpha(window->mask_temp->cairo_p, alpha);
 						}
 						else
@@ -12425,7 +12418,7 @@ skip_draw:
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -13220,8 +13213,13 @@ static void BlendImageBrushMotionCallBack(
 							{
 								if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 								{
-									cairo_set_source(update, core->brush_pattern);
-									cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+									// kE]ς݂̉摜gȂ΂̏ŊgkE]
+									if(SetStampImageSource(core, core->brush_surface, update,
+										zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+									{
+										cairo_set_source(update, core->brush_pattern);
+										cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+									}
 									cairo_paint_with_alpha(update, alpha);
 								}
 								else
@@ -13717,8 +13715,13 @@ static void BlendImageBrushButtonReleaseCallBack(
 					{
 						if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 						{
-							cairo_set_source(update, core->brush_pattern);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							// kE]ς݂̉摜gȂ΂̏ŊgkE]
+							if(SetStampImageSource(core, core->brush_surface, update,
+								zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+							{
+								cairo_set_source(update, core->brush_pattern);
+								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							}
 							cairo_paint_with_alpha(update, alpha);
 						}
 						else
@@ -13921,11 +13924,12 @@ skip_draw:
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_destroy(window->update.cairo_p);
 		cairo_surface_destroy(window->update.surface_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -14198,8 +14202,13 @@ static void BlendImageBrushEditSelectionRelease(
 					{
 						if((window->active_layer->flags & LAYER_LOCK_OPACITY) == 0)
 						{
-							cairo_set_source(window->mask_temp->cairo_p, core->brush_pattern);
-							cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							// kE]ς݂̉摜gȂ΂̏ŊgkE]
+							if(SetStampImageSource(core, core->brush_surface, window->mask_temp->cairo_p,
+								zoom, brush->core.rotate, trans_x, trans_y) == FALSE)
+							{
+								cairo_set_source(window->mask_temp->cairo_p, core->brush_pattern);
+								cairo_pattern_set_matrix(core->brush_pattern, &matrix);
+							}
 							cairo_paint_with_alpha(window->mask_temp->cairo_p, alpha);
 						}
 						else
@@ -14333,7 +14342,7 @@ skip_draw:
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -17442,11 +17451,12 @@ skip_draw:
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_destroy(window->update.cairo_p);
 		cairo_surface_destroy(window->update.surface_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -18987,7 +18997,7 @@ static void BucketPressCallBack(
 
 		window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->active_layer);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		if(bucket->target == BUCKET_TARGET_CANVAS)
 		{
@@ -19110,7 +19120,7 @@ static void BucketEditSelectionPressCallBack(
 
 		g_blend_selection_funcs[SELECTION_BLEND_NORMAL](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -19495,7 +19505,7 @@ static void PatternFillPressCallBack(
 
 		window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->active_layer);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		if(fill->target == PATTERN_FILL_TARGET_CANVAS)
 		{
@@ -19641,7 +19651,7 @@ static void PatternFillEditSelectionPressCallBack(
 
 		g_blend_selection_funcs[SELECTION_BLEND_NORMAL](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -20529,7 +20539,7 @@ static void GradationReleaseCallBack(
 
 		window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->active_layer);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -20789,7 +20799,7 @@ static void GradationEditSelectionReleaseCallBack(
 
 		g_blend_selection_funcs[SELECTION_BLEND_NORMAL](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 	}
@@ -23783,11 +23793,12 @@ static void SmudgeReleaseCallBack(
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 		cairo_destroy(window->update.cairo_p);
 		cairo_surface_destroy(window->update.surface_p);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 		window->flags |= DRAW_WINDOW_UPDATE_PART;
@@ -23813,7 +23824,7 @@ static void SmudgeEditSelectionReleaseCallBack(
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->selection->layer_mode = SELECTION_BLEND_NORMAL;
 
@@ -25093,6 +25104,9 @@ static void CustomBrushButtonPressCallBack(
 			// ȂƎUžʂ
 		(void)memset(window->mask_temp->pixels, 0, window->pixel_buf_size);
 
+		// Uzp̗̎Xg[NɌ߂
+		InitializeBrushScatter(&brush->scatter, ((GdkEventButton*)state)->time, x, y);
+
 		// uVƂĈꍇ
 		if(brush->brush_mode == CUSTOM_BRUSH_MODE_BLEND)
 		{
@@ -25123,6 +25137,8 @@ static void CustomBrushButtonPressCallBack(
 		else	// ʏuVƂĈꍇ
 		{
 			window->work_layer->layer_mode = brush->blend_mode;
+			// `悵^Ĉ݂Eł悤ɋL^
+			BeginWorkLayerTiles(window);
 		}
 
 		zoom = ((brush->flags & CUSTOM_BRUSH_FLAG_PRESSURE_SIZE) == 0) ? 1 : pressure;
@@ -25287,21 +25303,26 @@ static void CustomBrushButtonPressCallBack(
 				FLOAT_T flow;
 				FLOAT_T scatter_zoom;
 				FLOAT_T draw_x,	draw_y;
-				FLOAT_T direction;
+				BRUSH_SCATTER_DAB scatter_dabs[BRUSH_SCATTER_MAX_DABS];
 				FLOAT_T update_r;
 				FLOAT_T update_x, update_y;
 				int i;
 
 				for(i=0; i<brush->num_scatter; i++)
 				{
-					direction = (rand() % 2 == 0) ? 1 : -1;
-					draw_x = ((FLOAT_T)rand() / RAND_MAX) * range * direction + x;
-					direction = (rand() % 2 == 0) ? 1 : -1;
-					draw_y = ((FLOAT_T)rand() / RAND_MAX) * range * direction + y;
-					scatter_zoom = 1 - (((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_size);
+					// Uz̈ʒuATCYAZx̓Xg[N̗̎킩܂Ƃ߂Đ
+					if(i % BRUSH_SCATTER_MAX_DABS == 0)
+					{
+						GenerateBrushScatterDabs(&brush->scatter, x, y, range, 1,
+							brush->scatter_random_size, brush->scatter_random_flow, alpha,
+								MINIMUM(brush->num_scatter - i, BRUSH_SCATTER_MAX_DABS), scatter_dabs);
+					}
+					draw_x = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].x;
+					draw_y = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].y;
+					scatter_zoom = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].zoom;
 					scatter_r = r * scatter_zoom;
 					size = scatter_zoom * r;
-					flow = (1 - (((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_flow)) * alpha;
+					flow = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].flow;
 
 					UpdateBrushScatterDrawArea(window, &area, core, draw_x, draw_y, size, &brush->update);
 
@@ -25443,11 +25464,15 @@ static void CustomBrushMotionCallBack(
 				// QƃsNZ
 				uint8 *draw_pixel;
 				uint8 *mask_pixel = window->mask->pixels;
+				// ܂Ƃ߂ĕ`悷~`uV
+				BRUSH_STAMP_BATCH stamp_batch;
 				// z̃CfbNXp
 				int ref_point = brush->draw_finished % BRUSH_POINT_BUFFER_SIZE;
 				int before_point;
 				int i;	// forp̃JE^
 
+				InitializeBrushStampBatch(&stamp_batch);
+
 				while(brush->sum_distance > brush->draw_start
 					&& brush->draw_finished < brush->ref_point-1
 					&& brush->remain_distance <= 0)
@@ -25597,16 +25622,15 @@ static void CustomBrushMotionCallBack(
 							{
 								if(brush->brush_shape == CUSTOM_BRUSH_SHAPE_CIRCLE)
 								{
-									DrawCircleBrushWorkLayer(window, core, draw_x - r, draw_y - r, width, height,
-										&draw_pixel, zoom, alpha);
+									AddCircleBrushStamp(window, core, &stamp_batch, draw_x - r, draw_y - r, area.start_x, area.start_y,
+										width, height, zoom, alpha, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 								}
 								else
 								{
-									DrawImageBrushWorkLayer(window, core, draw_x, draw_y, width, height,
-										zoom, r, brush->angle, brush->image_width, brush->image_height, &draw_pixel, alpha);
+									AddImageBrushStamp(window, core, &stamp_batch, draw_x, draw_y, area.start_x, area.start_y,
+										(int)width, (int)height, zoom, r, brush->angle, brush->image_width, brush->image_height,
+											alpha, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 								}
-								AdaptNormalBrush(window, draw_pixel, (int)width, (int)height,
-									area.start_x, area.start_y, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 							}
 							else
 							{
@@ -25668,18 +25692,23 @@ static void CustomBrushMotionCallBack(
 								FLOAT_T flow;
 								FLOAT_T scatter_zoom;
 								FLOAT_T scatter_x,	scatter_y;
-								FLOAT_T direction;
+								BRUSH_SCATTER_DAB scatter_dabs[BRUSH_SCATTER_MAX_DABS];
 
 								for(i=0; i<brush->num_scatter; i++)
 								{
-									direction = (rand() % 2 == 0) ? 1 : -1;
-									scatter_x = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_x;
-									direction = (rand() % 2 == 0) ? 1 : -1;
-									scatter_y = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_y;
-									scatter_zoom = (1 - (((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_size)) * brush->scatter_size;
+									// Uz̈ʒuATCYAZx̓Xg[N̗̎킩܂Ƃ߂Đ
+									if(i % BRUSH_SCATTER_MAX_DABS == 0)
+									{
+										GenerateBrushScatterDabs(&brush->scatter, draw_x, draw_y, range, brush->scatter_size,
+											brush->scatter_random_size, brush->scatter_random_flow, alpha,
+												MINIMUM(brush->num_scatter - i, BRUSH_SCATTER_MAX_DABS), scatter_dabs);
+									}
+									scatter_x = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].x;
+									scatter_y = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].y;
+									scatter_zoom = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].zoom;
 									scatter_r = scatter_zoom * r;
 									size = scatter_zoom * r;
-									flow = (1 - ((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_flow) * alpha;
+									flow = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].flow;
 
 									UpdateBrushScatterDrawArea(window, &area, core, scatter_x, scatter_y, size, &brush->update);
 
@@ -25688,16 +25717,16 @@ static void CustomBrushMotionCallBack(
 									{
 										if(brush->brush_shape == CUSTOM_BRUSH_SHAPE_CIRCLE)
 										{
-											DrawCircleBrushWorkLayer(window, core, scatter_x - scatter_r, scatter_y - scatter_r, area.width,
-												area.height, &draw_pixel, scatter_zoom, flow);
+											AddCircleBrushStamp(window, core, &stamp_batch, scatter_x - scatter_r, scatter_y - scatter_r,
+												area.start_x, area.start_y, (int)area.width, (int)area.height, scatter_zoom, flow,
+													brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 										}
 										else
 										{
-											DrawImageBrushWorkLayer(window, core, scatter_x, scatter_y, area.width, area.height, scatter_zoom,
-												scatter_r, brush->start_angle, brush->image_width, brush->image_height, &draw_pixel, flow);
+											AddImageBrushStamp(window, core, &stamp_batch, scatter_x, scatter_y, area.start_x, area.start_y,
+												(int)area.width, (int)area.height, scatter_zoom, scatter_r, brush->start_angle,
+													brush->image_width, brush->image_height, flow, brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 										}
-										AdaptNormalBrush(window, draw_pixel, (int)area.width, (int)area.height,
-											area.start_x, area.start_y, brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 									}
 									else
 									{
@@ -25762,6 +25791,9 @@ skip_draw:
 								draw_x += diff_x, draw_y += diff_y;
 							}
 						} while(1);
+
+						// \񂵂~`uV܂Ƃ߂ĕ`
+						FlushCircleBrushStamps(window, core, &stamp_batch);
 					}
 
 					brush->finish_length += d;
@@ -25824,11 +25856,15 @@ static void CustomBrushButtonReleaseCallBack(
 		// QƃsNZ
 		uint8 *draw_pixel;
 		uint8 *mask_pixel = window->mask->pixels;
+		// ܂Ƃ߂ĕ`悷~`uV
+		BRUSH_STAMP_BATCH stamp_batch;
 		// z̃CfbNXp
 		int ref_point;
 		int before_point;
 		int i;	// forp̃JE^
 
+		InitializeBrushStampBatch(&stamp_batch);
+
 		ref_point = brush->ref_point % BRUSH_POINT_BUFFER_SIZE;
 		brush->points[ref_point][1] = x, brush->points[ref_point][2] = y;
 		brush->ref_point++;
@@ -25995,16 +26031,15 @@ static void CustomBrushButtonReleaseCallBack(
 					{
 						if(brush->brush_shape == CUSTOM_BRUSH_SHAPE_CIRCLE)
 						{
-							DrawCircleBrushWorkLayer(window, core, draw_x - r, draw_y - r, width, height,
-								&draw_pixel, zoom, alpha);
+							AddCircleBrushStamp(window, core, &stamp_batch, draw_x - r, draw_y - r, area.start_x, area.start_y,
+								width, height, zoom, alpha, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 						}
 						else
 						{
-							DrawImageBrushWorkLayer(window, core, draw_x, draw_y, width, height,
-								zoom, r, brush->angle, brush->image_width, brush->image_height, &draw_pixel, alpha);
+							AddImageBrushStamp(window, core, &stamp_batch, draw_x, draw_y, area.start_x, area.start_y,
+								(int)width, (int)height, zoom, r, brush->angle, brush->image_width, brush->image_height,
+									alpha, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 						}
-						AdaptNormalBrush(window, draw_pixel, (int)width, (int)height,
-							area.start_x, area.start_y, brush->flags & CUSTOM_BRUSH_FLAG_ANTI_ALIAS);
 					}
 					else
 					{
@@ -26066,18 +26101,23 @@ static void CustomBrushButtonReleaseCallBack(
 						FLOAT_T flow;
 						FLOAT_T scatter_zoom;
 						FLOAT_T scatter_x,	scatter_y;
-						FLOAT_T direction;
+						BRUSH_SCATTER_DAB scatter_dabs[BRUSH_SCATTER_MAX_DABS];
 
 						for(i=0; i<brush->num_scatter; i++)
 						{
-							direction = (rand() % 2 == 0) ? 1 : -1;
-							scatter_x = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_x;
-							direction = (rand() % 2 == 0) ? 1 : -1;
-							scatter_y = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_y;
-							scatter_zoom = (1 - (((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_size)) * brush->scatter_size;
+							// Uz̈ʒuATCYAZx̓Xg[N̗̎킩܂Ƃ߂Đ
+							if(i % BRUSH_SCATTER_MAX_DABS == 0)
+							{
+								GenerateBrushScatterDabs(&brush->scatter, draw_x, draw_y, range, brush->scatter_size,
+									brush->scatter_random_size, brush->scatter_random_flow, alpha,
+										MINIMUM(brush->num_scatter - i, BRUSH_SCATTER_MAX_DABS), scatter_dabs);
+							}
+							scatter_x = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].x;
+							scatter_y = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].y;
+							scatter_zoom = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].zoom;
 							scatter_r = scatter_zoom * r;
 							size = scatter_zoom * r;
-							flow = (1 - ((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_flow) * alpha;
+							flow = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].flow;
 
 							UpdateBrushScatterDrawArea(window, &area, core, scatter_x, scatter_y, size, &brush->update);
 
@@ -26086,16 +26126,16 @@ static void CustomBrushButtonReleaseCallBack(
 							{
 								if(brush->brush_shape == CUSTOM_BRUSH_SHAPE_CIRCLE)
 								{
-									DrawCircleBrushWorkLayer(window, core, scatter_x - scatter_r, scatter_y - scatter_r, area.width,
-										area.height, &draw_pixel, scatter_zoom, flow);
+									AddCircleBrushStamp(window, core, &stamp_batch, scatter_x - scatter_r, scatter_y - scatter_r,
+										area.start_x, area.start_y, (int)area.width, (int)area.height, scatter_zoom, flow,
+											brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 								}
 								else
 								{
-									DrawImageBrushWorkLayer(window, core, scatter_x, scatter_y, area.width, area.height, scatter_zoom,
-										scatter_r, brush->start_angle, brush->image_width, brush->image_height, &draw_pixel, flow);
+									AddImageBrushStamp(window, core, &stamp_batch, scatter_x, scatter_y, area.start_x, area.start_y,
+										(int)area.width, (int)area.height, scatter_zoom, scatter_r, brush->start_angle,
+											brush->image_width, brush->image_height, flow, brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 								}
-								AdaptNormalBrush(window, draw_pixel, (int)area.width, (int)area.height,
-									area.start_x, area.start_y, brush->flags & (1 << CUSTOM_BRUSH_FLAG_ANTI_ALIAS));
 							}
 							else
 							{
@@ -26157,6 +26197,9 @@ skip_draw:
 						draw_x += diff_x, draw_y += diff_y;
 					}
 				} while(1);
+
+				// \񂵂~`uV܂Ƃ߂ĕ`
+				FlushCircleBrushStamps(window, core, &stamp_batch);
 			}
 
 			brush->finish_length += d;
@@ -26171,15 +26214,20 @@ skip_draw:
 		window->update.y = brush->update.min_y;
 		window->update.width = brush->update.max_x - brush->update.min_x;
 		window->update.height = brush->update.max_y - brush->update.min_y;
-		window->update.surface_p = cairo_surface_create_for_rectangle(
-			window->active_layer->surface_p, window->update.x, window->update.y,
-				window->update.width, window->update.height);
-		window->update.cairo_p = cairo_create(window->update.surface_p);
-		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
-		cairo_destroy(window->update.cairo_p);
-		cairo_surface_destroy(window->update.surface_p);
+		// `悵^Ĉ݂łȂ΃Xg[NŜ͈̔͂
+		if(CommitWorkLayerTiles(window, window->active_layer) < 0)
+		{
+			window->update.surface_p = cairo_surface_create_for_rectangle(
+				window->active_layer->surface_p, window->update.x, window->update.y,
+					window->update.width, window->update.height);
+			window->update.cairo_p = cairo_create(window->update.surface_p);
+			window->update.target = window->active_layer;
+			window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
+			cairo_destroy(window->update.cairo_p);
+			cairo_surface_destroy(window->update.surface_p);
+		}
 
-		(void)memset(window->work_layer->pixels, 0, window->pixel_buf_size);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -26468,18 +26516,23 @@ static void CustomBrushEditSelectionRelease(
 						FLOAT_T flow;
 						FLOAT_T scatter_zoom;
 						FLOAT_T scatter_x,	scatter_y;
-						FLOAT_T direction;
+						BRUSH_SCATTER_DAB scatter_dabs[BRUSH_SCATTER_MAX_DABS];
 
 						for(i=0; i<brush->num_scatter; i++)
 						{
-							direction = (rand() % 2 == 0) ? 1 : -1;
-							scatter_x = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_x;
-							direction = (rand() % 2 == 0) ? 1 : -1;
-							scatter_y = ((FLOAT_T)rand() / RAND_MAX) * range * direction + draw_y;
-							scatter_zoom = (1 - (((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_size)) * brush->scatter_size;
+							// Uz̈ʒuATCYAZx̓Xg[N̗̎킩܂Ƃ߂Đ
+							if(i % BRUSH_SCATTER_MAX_DABS == 0)
+							{
+								GenerateBrushScatterDabs(&brush->scatter, draw_x, draw_y, range, brush->scatter_size,
+									brush->scatter_random_size, brush->scatter_random_flow, alpha,
+										MINIMUM(brush->num_scatter - i, BRUSH_SCATTER_MAX_DABS), scatter_dabs);
+							}
+							scatter_x = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].x;
+							scatter_y = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].y;
+							scatter_zoom = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].zoom;
 							scatter_r = scatter_zoom * r;
 							size = scatter_zoom * r;
-							flow = (1 - ((FLOAT_T)rand() / RAND_MAX) * brush->scatter_random_flow) * alpha;
+							flow = scatter_dabs[i % BRUSH_SCATTER_MAX_DABS].flow;
 
 							UpdateBrushScatterDrawArea(window, &area, core, scatter_x, scatter_y, size, &brush->update);
 
@@ -26571,7 +26624,7 @@ skip_draw:
 
 		g_blend_selection_funcs[window->selection->layer_mode](window->work_layer, window->selection);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		window->work_layer->layer_mode = LAYER_BLEND_NORMAL;
 
@@ -27505,6 +27558,8 @@ static void InitializeCustomBrush(CUSTOM_BRUSH* brush)
 		{
 			cairo_pattern_destroy(brush->core->brush_pattern);
 		}
+		// Â摜kE]ς݂̉摜̂Ă
+		ReleaseBrushImageCache(brush->core);
 		brush->core->brush_surface = CreateCustomBrushSurface(
 			brush, app->tool_window.color_chooser->rgb, app->tool_window.color_chooser->back_rgb, FALSE);
 		brush->core->brush_pattern = cairo_pattern_create_for_surface(
@@ -29458,10 +29513,11 @@ static void ScriptBrushButtonReleaseCallBack(
 			window->active_layer->surface_p, window->update.x, window->update.y,
 				window->update.width, window->update.height);
 		window->update.cairo_p = cairo_create(window->update.surface_p);
+		window->update.target = window->active_layer;
 
 		window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->update);
 
-		(void)memset(window->work_layer->pixels, 0, window->work_layer->stride*window->work_layer->height);
+		ClearWorkLayer(window);
 
 		cairo_surface_destroy(window->update.surface_p);
 		cairo_destroy(window->update.cairo_p);
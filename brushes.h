@@ -606,6 +606,7 @@ typedef struct _CUSTOM_BRUSH
 	FLOAT_T scatter_random_size;		// UzTCỸ_
 	FLOAT_T scatter_range;				// Uz͈
 	FLOAT_T scatter_random_flow;		// UzZx̃_
+	BRUSH_SCATTER scatter;				// Xg[N̎Uzp̗
 	uint8 *cursor_pixel;				// J[\psNZf[^
 	cairo_surface_t *cursor_surface;	// J[\pT[tF[X
 	GtkWidget *vbox;					// ݒpEBWFbg
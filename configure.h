@@ -16,6 +16,9 @@
 
 #define USE_TBB 1
 
+// C[cairoł͂ȂlCeBu̍g
+#define USE_NATIVE_LAYER_BLEND 1
+
 #define FRAME_RATE 60
 #define AUTO_SAVE_INTERVAL 60
 
@@ -1,5 +1,6 @@
 #include "configure.h"
 #include <string.h>
+#include <math.h>
 #include <gtk/gtk.h>
 #include <GL/glew.h>
 #if GTK_MAJOR_VERSION >= 3
@@ -8,20 +9,1467 @@
 #include <gtk/gtkgl.h>
 
 #include "application.h"
+#include "memory.h"
 #include "display.h"
 #include "draw_window.h"
 #include "transform.h"
+#include "layer_blend_native.h"
+#if defined(USE_TBB) && USE_TBB != 0
+# include "MikuMikuGtk+/tbb.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _eUPDATE_MODE
+{
+	NO_UPDATE,
+	UPDATE_ALL,
+	UPDATE_PART,
+	UPDATE_VIEWPORT
+} eUPDATE_MODE;
+
+// \͈݂͂̂̍ɐ؂ւLoXƕ\͈̖͂ʐϔ
+#define VIEWPORT_MIX_AREA_RATE 4
+
+/*************************************
+* InitializeUpdateTiles֐          *
+* ʍXVp̃^C *
+*                                *
+* tiles	: ^C       *
+* width	: LoX̕             *
+* height	: LoX̍       *
+*************************************/
+void InitializeUpdateTiles(
+	UPDATE_TILES* tiles,
+	int width,
+	int height
+)
+{
+	MEM_FREE_FUNC(tiles->dirty);
+
+	tiles->num_x = (width + UPDATE_TILE_SIZE - 1) / UPDATE_TILE_SIZE;
+	tiles->num_y = (height + UPDATE_TILE_SIZE - 1) / UPDATE_TILE_SIZE;
+	tiles->dirty = (uint8*)MEM_ALLOC_FUNC(tiles->num_x * tiles->num_y);
+	(void)memset(tiles->dirty, 0, tiles->num_x * tiles->num_y);
+	tiles->num_dirty = 0;
+}
+
+/***********************************
+* ReleaseUpdateTiles֐           *
+* ʍXVp̃^CJ *
+*                              *
+* tiles	: J^C       *
+***********************************/
+void ReleaseUpdateTiles(UPDATE_TILES* tiles)
+{
+	MEM_FREE_FUNC(tiles->dirty);
+	tiles->dirty = NULL;
+	tiles->num_x = tiles->num_y = 0;
+	tiles->num_dirty = 0;
+}
+
+/*********************************************
+* AddUpdateTiles֐                         *
+* w͈͂Ɋ|^CɍXVtO𗧂Ă *
+*                                        *
+* tiles	: ^C                         *
+* x		: XV͈͂̍XW              *
+* y		: XV͈͂̍YW              *
+* width	: XV͈͂̕                       *
+* height	: XV͈͂̍                 *
+*********************************************/
+void AddUpdateTiles(
+	UPDATE_TILES* tiles,
+	int x,
+	int y,
+	int width,
+	int height
+)
+{
+	// ^CPʂ͈̔
+	int start_x, start_y, end_x, end_y;
+	// forp̃JE^
+	int i, j;
+
+	if(tiles->dirty == NULL || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	start_x = (x < 0) ? 0 : x / UPDATE_TILE_SIZE;
+	start_y = (y < 0) ? 0 : y / UPDATE_TILE_SIZE;
+	end_x = (x + width - 1) / UPDATE_TILE_SIZE;
+	end_y = (y + height - 1) / UPDATE_TILE_SIZE;
+	if(end_x >= tiles->num_x)
+	{
+		end_x = tiles->num_x - 1;
+	}
+	if(end_y >= tiles->num_y)
+	{
+		end_y = tiles->num_y - 1;
+	}
+	if(start_x > end_x || start_y > end_y)
+	{
+		return;
+	}
+
+	for(i=start_y; i<=end_y; i++)
+	{
+		for(j=start_x; j<=end_x; j++)
+		{
+			if(tiles->dirty[i*tiles->num_x+j] == 0)
+			{
+				tiles->dirty[i*tiles->num_x+j] = 1;
+				tiles->num_dirty++;
+			}
+		}
+	}
+
+	// XVtO̗Ă͈͂XV
+	if(tiles->num_dirty == (end_x - start_x + 1) * (end_y - start_y + 1))
+	{
+		tiles->min_x = start_x, tiles->min_y = start_y;
+		tiles->max_x = end_x, tiles->max_y = end_y;
+	}
+	else
+	{
+		tiles->min_x = MINIMUM(tiles->min_x, start_x);
+		tiles->min_y = MINIMUM(tiles->min_y, start_y);
+		tiles->max_x = MAXIMUM(tiles->max_x, end_x);
+		tiles->max_y = MAXIMUM(tiles->max_y, end_y);
+	}
+}
+
+/*******************************************************
+* NextUpdateTilesRectangle֐                         *
+* XVtO̗Ă^C`ɂ܂Ƃ߂Ďo *
+* (o^C̃tO͍~낷)                   *
+*                                                  *
+* tiles	: ^C                                   *
+* width	: LoX̕                               *
+* height	: LoX̍                         *
+* rect		: o`i[AhX         *
+* Ԃl                                               *
+*	o:TRUE XV^C:FALSE           *
+*******************************************************/
+gboolean NextUpdateTilesRectangle(
+	UPDATE_TILES* tiles,
+	int width,
+	int height,
+	UPDATE_RECTANGLE* rect
+)
+{
+	// `͈̔(^CP)
+	int start_x, end_x, start_y, end_y;
+	// forp̃JE^
+	int i, j;
+
+	if(tiles->num_dirty <= 0)
+	{
+		return FALSE;
+	}
+
+	// ԏ̍s̍ŏ̘AXV^CT
+	for(start_y=tiles->min_y; start_y<=tiles->max_y; start_y++)
+	{
+		for(start_x=tiles->min_x; start_x<=tiles->max_x; start_x++)
+		{
+			if(tiles->dirty[start_y*tiles->num_x+start_x] != 0)
+			{
+				goto found;
+			}
+		}
+	}
+
+	// ͈͓ɍXV^C(JE^̕s)
+	tiles->num_dirty = 0;
+	return FALSE;
+
+found:
+	tiles->min_y = start_y;
+	end_x = start_x;
+	while(end_x < tiles->max_x && tiles->dirty[start_y*tiles->num_x+end_x+1] != 0)
+	{
+		end_x++;
+	}
+
+	// ̍XV^C艺ɐL΂
+	end_y = start_y;
+	while(end_y < tiles->max_y)
+	{
+		for(j=start_x; j<=end_x; j++)
+		{
+			if(tiles->dirty[(end_y+1)*tiles->num_x+j] == 0)
+			{
+				break;
+			}
+		}
+		if(j <= end_x)
+		{
+			break;
+		}
+		end_y++;
+	}
+
+	// o^C̃tO~낷
+	for(i=start_y; i<=end_y; i++)
+	{
+		(void)memset(&tiles->dirty[i*tiles->num_x+start_x], 0, end_x - start_x + 1);
+	}
+	tiles->num_dirty -= (end_x - start_x + 1) * (end_y - start_y + 1);
+
+	// sNZPʂ̋`ɕϊ
+	rect->x = start_x * UPDATE_TILE_SIZE;
+	rect->y = start_y * UPDATE_TILE_SIZE;
+	rect->width = MINIMUM((end_x + 1) * UPDATE_TILE_SIZE, width) - rect->x;
+	rect->height = MINIMUM((end_y + 1) * UPDATE_TILE_SIZE, height) - rect->y;
+
+	return TRUE;
+}
+
+/*******************************************
+* CopyUpdateRectangle֐                  *
+* XV͈͂̃sNZf[^݂̂Rs[ *
+*                                      *
+* dst		: Rs[̃sNZf[^     *
+* src		: Rs[̃sNZf[^     *
+* stride	: 1s̃oCg              *
+* update	: Rs[͈               *
+*******************************************/
+static void CopyUpdateRectangle(
+	uint8* dst,
+	const uint8* src,
+	int stride,
+	const UPDATE_RECTANGLE* update
+)
+{
+	// Rs[Jnʒu
+	int start = (int)update->y * stride + (int)update->x * 4;
+	// 1s̃Rs[oCg
+	int copy_bytes = (int)update->width * 4;
+	// forp̃JE^
+	int y;
+
+	for(y=0; y<(int)update->height; y++, start += stride)
+	{
+		(void)memcpy(&dst[start], &src[start], copy_bytes);
+	}
+}
+
+/*****************************************************
+* GetMixedPyramidLevel֐                           *
+* ݂̊gkŕ\Ɏgk摜̒i߂ *
+*                                                *
+* window	: `̈̏                         *
+* Ԃl                                             *
+*	k摜̒i(0Ȃ獇ʂ̂܂܎g)      *
+*****************************************************/
+static int GetMixedPyramidLevel(DRAW_WINDOW* window)
+{
+	int level = 0;
+
+	// k摜炳Ɋg債Ȃōςޒi܂Ŏg
+	while(level < MAX_MIXED_PYRAMID_LEVEL && window->zoom * (2 << level) <= 100)
+	{
+		level++;
+	}
+
+	return level;
+}
+
+/*****************************************************
+* PrepareMixedPyramid֐                            *
+* k\p̉摜̃obt@pӂ               *
+*                                                *
+* window		: `̈̏                     *
+* num_levels	: KvȒi                         *
+* Ԃl                                             *
+*	obt@蒼:TRUE	̂܂܎g:FALSE *
+*****************************************************/
+static gboolean PrepareMixedPyramid(DRAW_WINDOW* window, int num_levels)
+{
+	gboolean ret = FALSE;
+	int width = window->width, height = window->height;
+	int i;
+
+	for(i=0; i<num_levels; i++)
+	{
+		width = (width + 1) / 2;
+		height = (height + 1) / 2;
+
+		// LoXTCY̕ύX㓙̓TCYȂ̂ō蒼
+		if(window->mixed_pyramid[i] != NULL
+			&& (window->mixed_pyramid[i]->width != width || window->mixed_pyramid[i]->height != height))
+		{
+			DeleteLayer(&window->mixed_pyramid[i]);
+		}
+
+		if(window->mixed_pyramid[i] == NULL)
+		{
+			window->mixed_pyramid[i] = CreateLayer(0, 0, width, height, 4,
+				TYPE_NORMAL_LAYER, NULL, NULL, NULL, window);
+			ret = TRUE;
+		}
+	}
+
+	return ret;
+}
+
+/*************************************************
+* DownSampleLayer֐                            *
+* 1/2̑傫ɏk摜쐬            *
+*                                            *
+* src		: k̃C[                   *
+* dst		: k̃C[                   *
+* start_x	: k̍XV͈͂̍[             *
+* start_y	: k̍XV͈͂̏[             *
+* end_x	: k̍XV͈͂̉E[(͈͂Ɋ܂܂Ȃ) *
+* end_y	: k̍XV͈͂̉[(͈͂Ɋ܂܂Ȃ) *
+*************************************************/
+static void DownSampleLayer(
+	LAYER* src,
+	LAYER* dst,
+	int start_x,
+	int start_y,
+	int end_x,
+	int end_y
+)
+{
+	int x, y, i;
+
+	for(y=start_y; y<end_y; y++)
+	{
+		// TCY̒[͓sAg
+		uint8 *src0 = &src->pixels[(y*2)*src->stride];
+		uint8 *src1 = &src->pixels[MINIMUM(y*2+1, src->height-1)*src->stride];
+		uint8 *dst_pixel = &dst->pixels[y*dst->stride + start_x*4];
+
+		for(x=start_x; x<end_x; x++, dst_pixel += 4)
+		{
+			int left = x * 2 * 4;
+			int right = MINIMUM(x*2+1, src->width-1) * 4;
+
+			for(i=0; i<4; i++)
+			{
+				dst_pixel[i] = (uint8)((src0[left+i] + src0[right+i]
+					+ src1[left+i] + src1[right+i] + 2) >> 2);
+			}
+		}
+	}
+}
+
+/***************************************************
+* UpdateMixedPyramid֐                           *
+* ʂ̍XV͈͂k\p̉摜XV *
+*                                              *
+* window		: `̈̏                   *
+* num_levels	: XVi                     *
+* x			: XV͈͂̍XW                *
+* y			: XV͈͂̍YW                *
+* width		: XV͈͂̕                         *
+* height		: XV͈͂̍                   *
+***************************************************/
+static void UpdateMixedPyramid(
+	DRAW_WINDOW* window,
+	int num_levels,
+	int x,
+	int y,
+	int width,
+	int height
+)
+{
+	LAYER *src = window->mixed_layer;
+	int start_x = x, start_y = y;
+	int end_x = x + width, end_y = y + height;
+	int i;
+
+	for(i=0; i<num_levels; i++)
+	{
+		LAYER *dst = window->mixed_pyramid[i];
+
+		// 1i̍XV͈͂Ɋ|sNZ߂
+		start_x = MAXIMUM(start_x / 2, 0);
+		start_y = MAXIMUM(start_y / 2, 0);
+		end_x = MINIMUM((end_x + 1) / 2, dst->width);
+		end_y = MINIMUM((end_y + 1) / 2, dst->height);
+		if(end_x <= start_x || end_y <= start_y)
+		{
+			return;
+		}
+
+		DownSampleLayer(src, dst, start_x, start_y, end_x, end_y);
+		src = dst;
+	}
+}
+
+/**********************************************************
+* CreateScaledMixedPattern֐                            *
+* \p̊gksp^[쐬                *
+*                                                     *
+* window		: `̈̏                          *
+* num_levels	: gpk摜̒i                  *
+* Ԃl                                                  *
+*	쐬p^[(gpcairo_pattern_destroyŊJ) *
+**********************************************************/
+static cairo_pattern_t* CreateScaledMixedPattern(DRAW_WINDOW* window, int num_levels)
+{
+	cairo_pattern_t *pattern;
+	cairo_matrix_t matrix;
+	gdouble rev_zoom;
+
+	if(num_levels == 0)
+	{
+		return cairo_pattern_reference(window->mixed_pattern);
+	}
+
+	// k摜̑傫ɍ킹Ċgk𒲐
+	rev_zoom = window->rev_zoom / (1 << num_levels);
+	pattern = cairo_pattern_create_for_surface(window->mixed_pyramid[num_levels-1]->surface_p);
+	cairo_pattern_set_filter(pattern, CAIRO_FILTER_FAST);
+	cairo_matrix_init_scale(&matrix, rev_zoom, rev_zoom);
+	cairo_pattern_set_matrix(pattern, &matrix);
+
+	return pattern;
+}
+
+/*****************************
+* ReleaseMixedPyramid֐    *
+* k\p̉摜J *
+*                        *
+* window	: `̈̏ *
+*****************************/
+void ReleaseMixedPyramid(DRAW_WINDOW* window)
+{
+	int i;
+
+	for(i=0; i<MAX_MIXED_PYRAMID_LEVEL; i++)
+	{
+		if(window->mixed_pyramid[i] != NULL)
+		{
+			DeleteLayer(&window->mixed_pyramid[i]);
+		}
+	}
+}
+
+/***********************************************************************
+* GetAboveActiveState֐                                              *
+* ANeBuC[̃C[̏Ԃ\lvZ           *
+*                                                                  *
+* window	: `̈̏                                           *
+* Ԃl                                                               *
+*	C[IDAXVԍA[hAsxAtOvZl *
+***********************************************************************/
+static unsigned int GetAboveActiveState(DRAW_WINDOW* window)
+{
+	static const unsigned int initial_fnv = 2166136261u;
+	static const unsigned int fnv_multiple = 16777619u;
+
+	LAYER *layer = window->active_layer;
+	unsigned int state = initial_fnv;
+
+	// ANeBuC[̕ύXo邽߃ANeBuC[n߂
+	while(layer != NULL)
+	{
+		state = (state ^ (unsigned int)layer->id) * fnv_multiple;
+		// C[Zbg͎qC[̒lŔ肷
+		if(layer != window->active_layer && layer->layer_type != TYPE_LAYER_SET)
+		{
+			state = (state ^ layer->content_generation) * fnv_multiple;
+		}
+		state = (state ^ (unsigned int)layer->layer_mode) * fnv_multiple;
+		state = (state ^ (unsigned int)layer->alpha) * fnv_multiple;
+		state = (state ^ layer->flags) * fnv_multiple;
+
+		layer = layer->next;
+	}
+
+	return state;
+}
+
+/*********************************************************
+* UpdateAboveActiveCache֐                             *
+* ANeBuC[̃C[ċL   *
+* ʏ퍇ȊÕC[΋LȂ               *
+* ̃C[ɕύX΋Lʂ̂܂܎g *
+*                                                    *
+* window	: `̈̏                             *
+*********************************************************/
+static void UpdateAboveActiveCache(DRAW_WINDOW* window)
+{
+	// 郌C[
+	LAYER *layer;
+	// ̃C[̏
+	unsigned int state = GetAboveActiveState(window);
+
+	if((window->flags & DRAW_WINDOW_ABOVE_ACTIVE_CACHED) != 0
+		&& window->above_active_state == state)
+	{
+		return;
+	}
+
+	window->flags &= ~(DRAW_WINDOW_ABOVE_ACTIVE_CACHED);
+
+	// C[Zbg̍ƒ͋LȂ
+	if(window->active_layer_set != NULL || window->active_layer->layer_set != NULL)
+	{
+		return;
+	}
+
+	// ʏ퍇݂̂ōł邩mF
+		// (ւ̂͒ʏ퍇̂)
+	for(layer = window->active_layer->next; layer != NULL; layer = layer->next)
+	{
+		// C[Zbg̃C[̓C[ZbgƂč
+		if(layer->layer_set != NULL || (layer->flags & LAYER_FLAG_INVISIBLE) != 0)
+		{
+			continue;
+		}
+
+		if((layer->layer_mode != LAYER_BLEND_NORMAL && layer->layer_mode != LAYER_BLEND_OVER)
+			|| (layer->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
+		{
+			return;
+		}
+	}
+
+	(void)memset(window->above_active->pixels, 0, window->pixel_buf_size);
+	for(layer = window->active_layer->next; layer != NULL; layer = layer->next)
+	{
+		if(layer->layer_set == NULL && (layer->flags & LAYER_FLAG_INVISIBLE) == 0)
+		{
+			window->layer_blend_functions[LAYER_BLEND_NORMAL](layer, window->above_active);
+		}
+	}
+
+	window->above_active_state = state;
+	window->flags |= DRAW_WINDOW_ABOVE_ACTIVE_CACHED;
+}
+
+/*********************************************************
+* MixLayersUpdateRectangle֐                           *
+* XV͈͓̂݃ANeBuC[       *
+*                                                    *
+* window	: `̈̏(updateɍXV͈͂ݒς) *
+* mix_all	: ԉ̃C[獇ۂ       *
+*********************************************************/
+static void MixLayersUpdateRectangle(DRAW_WINDOW* window, gboolean mix_all)
+{
+	// 郌C[
+	LAYER *layer, *blend_layer;
+	// [h
+	int blend_mode;
+	// \̊gk
+	FLOAT_T zoom = window->zoom_rate;
+	// k\p̉摜̒iƃp^[
+	int num_levels;
+	cairo_pattern_t *scaled_pattern;
+	// forp̃JE^
+	int y;
+
+	// NbsOp̃}XNf[^͍XV͈͖Ɉx蒼
+	window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_UPDATED);
+
+	if(mix_all != FALSE)
+	{	// ԉ̃C[獇̂ŔwĩsNZf[^Rs[
+		CopyUpdateRectangle(window->mixed_layer->pixels, window->back_ground,
+			window->mixed_layer->stride, &window->update);
+		layer = window->layer;
+	}
+	else if(window->active_layer == window->layer)
+	{	// ANeBuC[ԉȂΔwĩsNZf[^Rs[
+		CopyUpdateRectangle(window->mixed_layer->pixels, window->back_ground,
+			window->mixed_layer->stride, &window->update);
+		layer = window->active_layer;
+	}
+	else
+	{	// łȂ΃ANeBuC[艺̍ς݂̃f[^Rs[
+		CopyUpdateRectangle(window->mixed_layer->pixels, window->under_active->pixels,
+			window->mixed_layer->stride, &window->update);
+		layer = window->active_layer;
+	}
+
+	window->update.surface_p = cairo_surface_create_for_rectangle(
+		window->mixed_layer->surface_p, window->update.x, window->update.y,
+			window->update.width, window->update.height);
+	window->update.cairo_p = cairo_create(window->update.surface_p);
+	window->update.target = window->mixed_layer;
+	window->temp_update = window->update;
+	window->temp_update.surface_p = cairo_surface_create_for_rectangle(
+		window->temp_layer->surface_p, window->update.x, window->update.y,
+			window->update.width, window->update.height);
+	window->temp_update.cairo_p = cairo_create(window->temp_update.surface_p);
+	window->temp_update.target = window->temp_layer;
+
+	// ԏ̃C[ɒH蒅܂Ń[v
+	while(layer != NULL)
+	{
+		// C[Zbg̃C[ł
+		if(layer->layer_set != NULL)
+		{	// ԉ獇Ȃ
+			if(mix_all != FALSE)
+			{	// C[ZbgXV(ύXȂ΋Lʂg)
+				MixLayerSet(layer, &layer, window);
+			}
+			else if(layer->layer_set == window->active_layer_set)
+			{
+				MixLayerSetActiveOver(layer, &layer, window);
+			}	// else if(layer->layer_set == window->active_layer_set)
+			else
+			{
+				layer = layer->layer_set;
+			}
+		}	// if(layer->layer_set != NULL)
+
+		// C[ƍ@xL
+		blend_layer = layer;
+		blend_mode = layer->layer_mode;
+
+		// \C[ɂȂĂȂƂmF
+		if((blend_layer->flags & LAYER_FLAG_INVISIBLE) == 0)
+		{	// A郌C[ANeBuC[Ȃ
+			if(layer == window->active_layer)
+			{
+				if(layer->layer_type == TYPE_NORMAL_LAYER)
+				{	// ʏ탌C[
+						// ƃC[ƃANeBuC[xĂ牺̃C[ƍ
+					CopyUpdateRectangle(window->temp_layer->pixels, layer->pixels,
+						layer->stride, &window->update);
+					window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->temp_update);
+					//g_layer_blend_funcs[window->work_layer->layer_mode](window->work_layer, window->temp_layer);
+					blend_layer = window->temp_layer;
+					blend_layer->alpha = layer->alpha;
+					blend_layer->flags = layer->flags;
+					blend_layer->prev = layer->prev;
+				}
+				else if(layer->layer_type == TYPE_VECTOR_LAYER)
+				{	// xNgC[
+						// C[̃X^CYsȂĂƃC[Ɖ̃C[
+					RasterizeVectorLayer(window, layer, layer->layer_data.vector_layer_p);
+					if(window->work_layer->layer_mode != LAYER_BLEND_NORMAL)
+					{
+						window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, layer);
+					}
+				}
+				else if(layer->layer_type == TYPE_TEXT_LAYER)
+				{	// eLXgC[
+						// eLXg̓eX^CYĂ牺̃C[ƍ
+					RenderTextLayer(window, layer, layer->layer_data.text_layer_p);
+				}
+
+				// TlCXV
+				gtk_widget_queue_draw(layer->widget->thumbnail);
+			}
+
+			// Ώۂƕ@m肵̂ōs
+			window->part_layer_blend_functions[blend_mode](blend_layer, &window->update);
+			// f[^ɖ߂
+			window->temp_layer->alpha = 100;
+			window->temp_layer->flags = 0;
+			window->temp_layer->prev = NULL;
+			cairo_set_operator(window->temp_layer->cairo_p, CAIRO_OPERATOR_OVER);
+		}	// \C[ɂȂĂȂƂmF
+		// if((blend_layer->flags & LAYER_FLAG_INVISIBLE) == 0)
+
+		// ANeBuC[̍ʂLĂ
+			// Lʂd˂ďI
+		if(layer == window->active_layer
+			&& (window->flags & DRAW_WINDOW_ABOVE_ACTIVE_CACHED) != 0)
+		{
+			window->part_layer_blend_functions[LAYER_BLEND_NORMAL](window->above_active, &window->update);
+			break;
+		}
+
+		// ̃C[
+		layer = layer->next;
+
+		// ɍ郌C[ANeBuC[Ȃ
+		if(layer == window->active_layer)
+		{	// XV͈͂̃ANeBuC[艺̃C[̍f[^XV
+			CopyUpdateRectangle(window->under_active->pixels, window->mixed_layer->pixels,
+				window->mixed_layer->stride, &window->update);
+		}
+	}	// ԏ̃C[ɒH蒅܂Ń[v
+			// while(layer != NULL)
+
+	if(window->app->display_filter.filter_func != NULL)
+	{
+		int start_x = (int)window->update.x;
+		int start_y = (int)window->update.y;
+		int width = (int)window->update.width;
+		int height = (int)window->update.height;
+		int stride = width * 4;
+		for(y=0; y<height; y++)
+		{
+			(void)memcpy(&window->temp_layer->pixels[y*stride],
+				&window->mixed_layer->pixels[(start_y+y)*window->mixed_layer->stride + start_x*4], stride);
+		}
+		window->app->display_filter.filter_func(window->temp_layer->pixels,
+			window->temp_layer->pixels, width*height, window->app->display_filter.filter_data);
+		for(y=0; y<height; y++)
+		{
+			(void)memcpy(&window->mixed_layer->pixels[(start_y+y)*window->mixed_layer->stride + start_x*4],
+				&window->temp_layer->pixels[y*stride], stride);
+		}
+	}
+
+	// k\͏k摜̍XV͈͂蒼Ăgk
+	num_levels = GetMixedPyramidLevel(window);
+	if(PrepareMixedPyramid(window, num_levels) != FALSE)
+	{
+		UpdateMixedPyramid(window, num_levels, 0, 0, window->width, window->height);
+	}
+	else
+	{
+		UpdateMixedPyramid(window, num_levels, (int)window->update.x, (int)window->update.y,
+			(int)ceil(window->update.x + window->update.width) - (int)window->update.x,
+			(int)ceil(window->update.y + window->update.height) - (int)window->update.y);
+	}
+	scaled_pattern = CreateScaledMixedPattern(window, num_levels);
+
+	cairo_save(window->scaled_mixed->cairo_p);
+	cairo_rectangle(window->scaled_mixed->cairo_p, (int)(window->update.x * zoom), (int)(window->update.y * zoom),
+		(int)(window->update.width * zoom), (int)(window->update.height * zoom));
+	cairo_clip(window->scaled_mixed->cairo_p);
+	cairo_set_operator(window->scaled_mixed->cairo_p, CAIRO_OPERATOR_OVER);
+	cairo_set_source(window->scaled_mixed->cairo_p, scaled_pattern);
+	cairo_paint(window->scaled_mixed->cairo_p);
+	cairo_restore(window->scaled_mixed->cairo_p);
+	cairo_pattern_destroy(scaled_pattern);
+	//ScaleNearest(window);
+
+	cairo_surface_destroy(window->update.surface_p);
+	cairo_destroy(window->update.cairo_p);
+	cairo_surface_destroy(window->temp_update.surface_p);
+	cairo_destroy(window->temp_update.cairo_p);
+}
+
+/*******************************************
+* GetDisplayViewport֐                   *
+* \ĂLoX͈̔͂擾 *
+*                                      *
+* window	: `̈̏               *
+* viewport	: \͈͂i[AhX   *
+* Ԃl                                   *
+*	擾ł:TRUE	擾łȂ:FALSE     *
+*******************************************/
+static gboolean GetDisplayViewport(DRAW_WINDOW* window, GdkRectangle* viewport)
+{
+	// ]̕\͈͂͂ދ`(\pf[^̍W)
+	int min_x, min_y, max_x, max_y;
+	// ]p
+	int temp;
+	// forp̃JE^
+	int i;
+
+	min_x = max_x = window->update_clip_area[0][0];
+	min_y = max_y = window->update_clip_area[0][1];
+	for(i=1; i<4; i++)
+	{
+		min_x = MINIMUM(min_x, window->update_clip_area[i][0]);
+		min_y = MINIMUM(min_y, window->update_clip_area[i][1]);
+		max_x = MAXIMUM(max_x, window->update_clip_area[i][0]);
+		max_y = MAXIMUM(max_y, window->update_clip_area[i][1]);
+	}
+
+	// E]\͕\pf[^̍W]Ă
+	if((window->flags & DRAW_WINDOW_DISPLAY_HORIZON_REVERSE) != 0)
+	{
+		temp = min_x;
+		min_x = window->disp_layer->width - max_x;
+		max_x = window->disp_layer->width - temp;
+	}
+
+	// LoX̍Wɕϊ([͍L߂Ɏ)
+	min_x = (int)(min_x * window->rev_zoom) - 1;
+	min_y = (int)(min_y * window->rev_zoom) - 1;
+	max_x = (int)(max_x * window->rev_zoom) + 2;
+	max_y = (int)(max_y * window->rev_zoom) + 2;
+	if(min_x < 0)
+	{
+		min_x = 0;
+	}
+	if(min_y < 0)
+	{
+		min_y = 0;
+	}
+	if(max_x > window->width)
+	{
+		max_x = window->width;
+	}
+	if(max_y > window->height)
+	{
+		max_y = window->height;
+	}
+	if(min_x >= max_x || min_y >= max_y)
+	{
+		return FALSE;
+	}
+
+	viewport->x = min_x;
+	viewport->y = min_y;
+	viewport->width = max_x - min_x;
+	viewport->height = max_y - min_y;
+
+	return TRUE;
+}
+
+/*********************************************
+* CanMixViewportOnly֐                     *
+* \͈݂͂̂̍łԂ𔻒肷 *
+*                                        *
+* window	: `̈̏                 *
+* Ԃl                                     *
+*	ł:TRUE	łȂ:FALSE       *
+*********************************************/
+static gboolean CanMixViewportOnly(DRAW_WINDOW* window)
+{
+	if(window->stale_tiles.dirty == NULL)
+	{
+		return FALSE;
+	}
+
+	// C[Zbg̍ƒƃX^CYKvȃC[̕ҏW
+		// `̍dȂ̂őŜ
+	if(window->active_layer_set != NULL || window->active_layer->layer_set != NULL
+		|| window->active_layer->layer_type != TYPE_NORMAL_LAYER)
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*****************************************************
+* IsViewportMixEnabled֐                           *
+* Ŝ̍XV\͈݂͂̂̍ɂ邩𔻒肷   *
+* (g\ŕ\͈͂LoX\) *
+*                                                *
+* window	: `̈̏                         *
+* Ԃl                                             *
+*	\͈͂̂ݍ:TRUE	Ŝ:FALSE *
+*****************************************************/
+static gboolean IsViewportMixEnabled(DRAW_WINDOW* window)
+{
+	// \͈
+	GdkRectangle viewport;
+
+	if(CanMixViewportOnly(window) == FALSE
+		|| GetDisplayViewport(window, &viewport) == FALSE)
+	{
+		return FALSE;
+	}
+
+	return viewport.width * viewport.height * VIEWPORT_MIX_AREA_RATE
+		<= window->width * window->height;
+}
+
+/*****************************************************
+* TakeStaleTiles֐                                 *
+* w͈͂Ɋ|񂵂ɂ^C̃tO~낷 *
+*                                                *
+* tiles	: 񂵂ɂ^C̏                   *
+* rect		: ͈                                   *
+* Ԃl                                             *
+*	񂵂ɂ^C:TRUE	:FALSE   *
+*****************************************************/
+static gboolean TakeStaleTiles(UPDATE_TILES* tiles, const UPDATE_RECTANGLE* rect)
+{
+	// ^CPʂ͈̔
+	int start_x, start_y, end_x, end_y;
+	// 񂵂ɂ^Cۂ
+	gboolean found = FALSE;
+	// forp̃JE^
+	int i, j;
+
+	if(tiles->num_dirty <= 0)
+	{
+		return FALSE;
+	}
+
+	start_x = (int)rect->x / UPDATE_TILE_SIZE;
+	start_y = (int)rect->y / UPDATE_TILE_SIZE;
+	end_x = MINIMUM(((int)(rect->x + rect->width) - 1) / UPDATE_TILE_SIZE, tiles->num_x - 1);
+	end_y = MINIMUM(((int)(rect->y + rect->height) - 1) / UPDATE_TILE_SIZE, tiles->num_y - 1);
+
+	for(i=start_y; i<=end_y; i++)
+	{
+		for(j=start_x; j<=end_x; j++)
+		{
+			if(tiles->dirty[i*tiles->num_x+j] != 0)
+			{
+				tiles->dirty[i*tiles->num_x+j] = 0;
+				tiles->num_dirty--;
+				found = TRUE;
+			}
+		}
+	}
+
+	return found;
+}
+
+/*******************************************
+* MixStaleTilesInArea֐                  *
+* w͈͓̌񂵂ɂ^C *
+*                                      *
+* window	: `̈̏               *
+* area		: ͈                 *
+*******************************************/
+static void MixStaleTilesInArea(DRAW_WINDOW* window, const GdkRectangle* area)
+{
+	// 񂵂ɂ^C
+	UPDATE_TILES *tiles = &window->stale_tiles;
+	// Ăяo̍XV͈
+	UPDATE_RECTANGLE update = window->update;
+	UPDATE_RECTANGLE temp_update = window->temp_update;
+	// ^CPʂ͈̔
+	int start_x, start_y, end_x, end_y;
+	// ܂Ƃ߂č`̉E[Ɖ[(^CP)
+	int right, bottom;
+	// forp̃JE^
+	int i, j, k;
+
+	if(tiles->num_dirty <= 0 || area->width <= 0 || area->height <= 0)
+	{
+		return;
+	}
+
+	start_x = area->x / UPDATE_TILE_SIZE;
+	start_y = area->y / UPDATE_TILE_SIZE;
+	end_x = MINIMUM((area->x + area->width - 1) / UPDATE_TILE_SIZE, tiles->num_x - 1);
+	end_y = MINIMUM((area->y + area->height - 1) / UPDATE_TILE_SIZE, tiles->num_y - 1);
+
+	for(i=start_y; i<=end_y; i++)
+	{
+		j = start_x;
+		while(j <= end_x)
+		{
+			if(tiles->dirty[i*tiles->num_x+j] == 0)
+			{
+				j++;
+				continue;
+			}
+
+			// ɘA^CT
+			right = j;
+			while(right < end_x && tiles->dirty[i*tiles->num_x+right+1] != 0)
+			{
+				right++;
+			}
+
+			// ̃^C艺ɐL΂
+			bottom = i;
+			while(bottom < end_y)
+			{
+				for(k=j; k<=right; k++)
+				{
+					if(tiles->dirty[(bottom+1)*tiles->num_x+k] == 0)
+					{
+						break;
+					}
+				}
+				if(k <= right)
+				{
+					break;
+				}
+				bottom++;
+			}
+
+			// tO~낵Ĉԉ̃C[獇
+			for(k=i; k<=bottom; k++)
+			{
+				(void)memset(&tiles->dirty[k*tiles->num_x+j], 0, right - j + 1);
+			}
+			tiles->num_dirty -= (right - j + 1) * (bottom - i + 1);
+
+			window->update.x = j * UPDATE_TILE_SIZE;
+			window->update.y = i * UPDATE_TILE_SIZE;
+			window->update.width = MINIMUM((right + 1) * UPDATE_TILE_SIZE, window->width) - window->update.x;
+			window->update.height = MINIMUM((bottom + 1) * UPDATE_TILE_SIZE, window->height) - window->update.y;
+			MixLayersUpdateRectangle(window, TRUE);
+
+			j = right + 1;
+		}
+	}
+
+	window->update = update;
+	window->temp_update = temp_update;
+}
+
+/*******************************************************
+* MixStaleTilesIdle֐                                *
+* 񂵂ɂ^CACh     *
+*                                                  *
+* window	: `̈̏                           *
+* Ԃl                                               *
+*	^CcĂ:TRUE	Sč:FALSE *
+*******************************************************/
+static gboolean MixStaleTilesIdle(DRAW_WINDOW* window)
+{
+	// 񂵂ɂ^C
+	UPDATE_TILES *tiles = &window->stale_tiles;
+	// ͈
+	GdkRectangle area;
+	// forp̃JE^
+	int i, j;
+
+	// 񂵂ɂ^Ĉԏ̍sT
+	for(i=tiles->min_y; i<=tiles->max_y && tiles->num_dirty > 0; i++)
+	{
+		for(j=0; j<tiles->num_x; j++)
+		{
+			if(tiles->dirty[i*tiles->num_x+j] != 0)
+			{
+				break;
+			}
+		}
+
+		if(j < tiles->num_x)
+		{	// 1̌Ăяoł1ŝݍ
+			tiles->min_y = i;
+			area.x = 0;
+			area.y = i * UPDATE_TILE_SIZE;
+			area.width = window->width;
+			area.height = UPDATE_TILE_SIZE;
+			CheckLayerContentBounds(window);
+			MixStaleTilesInArea(window, &area);
+			break;
+		}
+	}
+
+	if(i > tiles->max_y)
+	{	// ͈͓Ƀ^C(JE^̕s)
+		tiles->num_dirty = 0;
+	}
+
+	if(tiles->num_dirty > 0)
+	{
+		return TRUE;
+	}
+
+	// SčÎŃirQ[Vуvr[̓eXV
+	window->stale_idle_id = 0;
+	if(window->app->navigation_window.draw_area != NULL)
+	{
+		gtk_widget_queue_draw(window->app->navigation_window.draw_area);
+	}
+	if(window->app->preview_window.window != NULL)
+	{
+		gtk_widget_queue_draw(window->app->preview_window.image);
+	}
+
+	return FALSE;
+}
+
+/*********************************************
+* ResetStaleTiles֐                        *
+* 񂵂ɂ^C̏ *
+*                                        *
+* window	: `̈̏                 *
+*********************************************/
+void ResetStaleTiles(DRAW_WINDOW* window)
+{
+	if(window->stale_idle_id != 0)
+	{
+		(void)g_source_remove(window->stale_idle_id);
+		window->stale_idle_id = 0;
+	}
+
+	InitializeUpdateTiles(&window->stale_tiles, window->width, window->height);
+}
+
+/*******************************************
+* ReleaseStaleTiles֐                    *
+* 񂵂ɂ^C̏J *
+*                                      *
+* window	: `̈̏               *
+*******************************************/
+void ReleaseStaleTiles(DRAW_WINDOW* window)
+{
+	if(window->stale_idle_id != 0)
+	{
+		(void)g_source_remove(window->stale_idle_id);
+		window->stale_idle_id = 0;
+	}
+
+	ReleaseUpdateTiles(&window->stale_tiles);
+}
+
+/***********************************************
+* FlushStaleTiles֐                          *
+* 񂵂ɂ^CSč       *
+* (LoX̍ʂQƂOɌĂяo) *
+*                                          *
+* window	: `̈̏                   *
+***********************************************/
+void FlushStaleTiles(DRAW_WINDOW* window)
+{
+	// ͈
+	GdkRectangle area = {0, 0, window->width, window->height};
+
+	if(window->stale_tiles.num_dirty <= 0)
+	{
+		return;
+	}
+
+	CheckLayerContentBounds(window);
+	MixStaleTilesInArea(window, &area);
+
+	if(window->stale_idle_id != 0)
+	{
+		(void)g_source_remove(window->stale_idle_id);
+		window->stale_idle_id = 0;
+	}
+}
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+
+// яɕčۂ1̑т̍
+#define MIX_LAYER_BAND_HEIGHT 64
+
+/*************************************************
+* MIX_LAYER_BANDS\                          *
+* LoXяɕč邽߂̃f[^ *
+*************************************************/
+typedef struct _MIX_LAYER_BANDS
+{
+	LAYER *target;					// 
+	LAYER *under_active;			// ANeBuC[艺̍ʂ̕ۑ
+	LAYER **layers;					// 郌C[
+	NATIVE_BLEND_FUNC *functions;	// C[̍̊֐
+	int *opacities;					// C[̕sx(0`255)
+	GdkRectangle *bounds;			// C[͈̍
+	int num_layers;					// 郌C[̐
+	int under_active_index;			// under_activeXV^C~O(-1ȂXVȂ)
+	int num_bands;					// т̐
+} MIX_LAYER_BANDS;
+
+/***********************************************
+* CanMixLayerInBands֐                       *
+* яɕčł郌C[𔻒肷 *
+*                                          *
+* window	: `̈̏                   *
+* layer		: 肷郌C[                 *
+* Ԃl                                       *
+*	ł:TRUE	łȂ:FALSE         *
+***********************************************/
+static gboolean CanMixLayerInBands(DRAW_WINDOW* window, LAYER* layer)
+{
+	if((layer->flags & LAYER_FLAG_INVISIBLE) != 0)
+	{
+		return TRUE;
+	}
+
+	// ̃C[ł̃}XLO͔͈͊ÕsNZQƂ̂ŕs
+	if((layer->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
+	{
+		return FALSE;
+	}
+
+	if(layer->x != 0 || layer->y != 0
+		|| layer->width != window->width || layer->height != window->height)
+	{
+		return FALSE;
+	}
+
+	return GetNativeBlendFunction(layer->layer_mode) != NULL;
+}
+
+/*****************************************************
+* SetMixLayerBandsBounds֐                         *
+* 郌C[̕sȕ܂ޔ͈͂ݒ肷 *
+*                                                *
+* bands		: яɕč邽߂̃f[^     *
+* layer		: 郌C[                       *
+* blend_mode	: [h                         *
+* Ԃl                                             *
+*	Kvȕ:TRUE	Sē:FALSE       *
+*****************************************************/
+static gboolean SetMixLayerBandsBounds(MIX_LAYER_BANDS* bands, LAYER* layer, int blend_mode)
+{
+	GdkRectangle *bounds = &bands->bounds[bands->num_layers];
+
+	// \[X͓̍ȕ
+	if(blend_mode == LAYER_BLEND_SOURCE || GetLayerContentBounds(layer,
+		&bounds->x, &bounds->y, &bounds->width, &bounds->height) == FALSE)
+	{
+		bounds->x = bounds->y = 0;
+		bounds->width = bands->target->width;
+		bounds->height = bands->target->height;
+	}
 
-#ifdef __cplusplus
-extern "C" {
+	return bounds->width > 0 && bounds->height > 0;
+}
+
+/*************************************************
+* MixLayerBand֐                               *
+* 1̑т͈̔͂őSẴC[        *
+*                                            *
+* bands		: яɕč邽߂̃f[^ *
+* index		: т̃CfbNX                   *
+* user_data	: gpȂ                         *
+*************************************************/
+static void MixLayerBand(MIX_LAYER_BANDS* bands, int index, void* user_data)
+{
+	LAYER *target = bands->target;
+	int start_y = index * MIX_LAYER_BAND_HEIGHT;
+	int height = MINIMUM(MIX_LAYER_BAND_HEIGHT, target->height - start_y);
+	int blend_y, blend_height;
+	int i;
+
+	for(i=0; i<bands->num_layers; i++)
+	{
+		GdkRectangle *bounds = &bands->bounds[i];
+
+		if(i == bands->under_active_index)
+		{
+			(void)memcpy(&bands->under_active->pixels[start_y*target->stride],
+				&target->pixels[start_y*target->stride], target->stride * height);
+		}
+
+		// т̒ŃC[̕sȕɊ|͈͂̂ݍ
+		blend_y = MAXIMUM(start_y, bounds->y);
+		blend_height = MINIMUM(start_y + height, bounds->y + bounds->height) - blend_y;
+		if(blend_height <= 0)
+		{
+			continue;
+		}
+
+		NativeBlendPixels(&target->pixels[blend_y*target->stride + bounds->x*4], target->stride,
+			&bands->layers[i]->pixels[blend_y*bands->layers[i]->stride + bounds->x*4],
+			bands->layers[i]->stride, bounds->width, blend_height,
+			bands->opacities[i], bands->functions[i]);
+	}
+
+	if(i == bands->under_active_index)
+	{
+		(void)memcpy(&bands->under_active->pixels[start_y*target->stride],
+			&target->pixels[start_y*target->stride], target->stride * height);
+	}
+}
+
+/*********************************************
+* ExecuteMixLayerBands֐                   *
+* яɕ̈ɍ         *
+*                                        *
+* bands	: яɕč邽߂̃f[^ *
+*********************************************/
+static void ExecuteMixLayerBands(MIX_LAYER_BANDS* bands)
+{
+#if defined(USE_TBB) && USE_TBB != 0
+	void *processor;
+#else
+	int i;
 #endif
 
-typedef enum _eUPDATE_MODE
+	bands->num_bands = (bands->target->height + MIX_LAYER_BAND_HEIGHT - 1) / MIX_LAYER_BAND_HEIGHT;
+
+#if defined(USE_TBB) && USE_TBB != 0
+	// SĂ̑тœf[^QƂ̂Ńf[^TCY0
+	processor = SimpleParallelProcessorNew(bands, 0, bands->num_bands,
+		(void (*)(void*, int, void*))MixLayerBand, NULL);
+	ExecuteSimpleParallelProcessor(processor);
+	DeleteSimpleParallelProcessor(processor);
+#else
+#pragma omp parallel for
+	for(i=0; i<bands->num_bands; i++)
+	{
+		MixLayerBand(bands, i, NULL);
+	}
+#endif
+}
+
+/*****************************************************
+* MixLayersInBands֐                               *
+* SXṼC[яɕĕɍs   *
+*                                                *
+* window	: `̈̏                         *
+* layer		: ŏɍ郌C[                 *
+* Ԃl                                             *
+*	:TRUE	łȂC[:FALSE *
+*****************************************************/
+static gboolean MixLayersInBands(DRAW_WINDOW* window, LAYER* layer)
 {
-	NO_UPDATE,
-	UPDATE_ALL,
-	UPDATE_PART
-} eUPDATE_MODE;
+	MIX_LAYER_BANDS bands;
+	LAYER *check, *blend_layer;
+	int blend_mode;
+
+	// C[Zbg̍ƒ̓C[Zbg̍r̍ʂQƂ̂ŕs
+	if(window->active_layer_set != NULL || window->active_layer->layer_set != NULL)
+	{
+		return FALSE;
+	}
+
+	// SẴC[яɍł邩ɊmF
+	for(check = layer; check != NULL; check = check->next)
+	{
+		if(check->layer_set != NULL)
+		{	// C[Zbg̃C[̓C[ZbgƂč
+			if(check->layer_set->layer_set != NULL)
+			{
+				return FALSE;
+			}
+		}
+		else if(CanMixLayerInBands(window, check) == FALSE)
+		{
+			return FALSE;
+		}
+	}
+
+	bands.target = window->mixed_layer;
+	bands.under_active = window->under_active;
+	bands.layers = (LAYER**)MEM_ALLOC_FUNC(sizeof(*bands.layers)*(window->num_layer+1));
+	bands.functions = (NATIVE_BLEND_FUNC*)MEM_ALLOC_FUNC(sizeof(*bands.functions)*(window->num_layer+1));
+	bands.opacities = (int*)MEM_ALLOC_FUNC(sizeof(*bands.opacities)*(window->num_layer+1));
+	bands.bounds = (GdkRectangle*)MEM_ALLOC_FUNC(sizeof(*bands.bounds)*(window->num_layer+1));
+	bands.num_layers = 0;
+	bands.under_active_index = -1;
+
+	// ̑OsȂ獇郌C[ׂ
+	while(layer != NULL)
+	{
+		// C[Zbg̃C[ł
+		if(layer->layer_set != NULL)
+		{	// SXVȂ
+			if((window->flags & DRAW_WINDOW_UPDATE_ACTIVE_UNDER) != 0)
+			{	// C[ZbgXV
+				MixLayerSet(layer, &layer, window);
+			}
+			else
+			{
+				layer = layer->layer_set;
+			}
+		}
+
+		// C[ƍ@xL
+		blend_layer = layer;
+		blend_mode = layer->layer_mode;
+
+		// \C[ɂȂĂȂƂmF
+		if((blend_layer->flags & LAYER_FLAG_INVISIBLE) == 0)
+		{	// A郌C[ANeBuC[Ȃ
+			if(layer == window->active_layer)
+			{
+				if(layer->layer_type == TYPE_NORMAL_LAYER)
+				{	// ʏ탌C[
+						// ƃC[ƃANeBuC[xĂ牺̃C[ƍ
+					(void)memcpy(window->temp_layer->pixels, layer->pixels, layer->stride*layer->height);
+					window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, window->temp_layer);
+					blend_layer = window->temp_layer;
+				}
+				else if(layer->layer_type == TYPE_VECTOR_LAYER)
+				{	// xNgC[
+						// C[̃X^CYsȂĂƃC[Ɖ̃C[
+					RasterizeVectorLayer(window, layer, layer->layer_data.vector_layer_p);
+					if(window->work_layer->layer_mode != LAYER_BLEND_NORMAL)
+					{
+						window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, layer);
+					}
+				}
+				else if(layer->layer_type == TYPE_TEXT_LAYER)
+				{	// eLXgC[
+						// eLXg̓eX^CYĂ牺̃C[ƍ
+					RenderTextLayer(window, layer, layer->layer_data.text_layer_p);
+				}
+
+				// TlCXV
+				if(layer->widget != NULL)
+				{
+					gtk_widget_queue_draw(layer->widget->thumbnail);
+				}
+			}
+
+			// SēȃC[͍Ȃ
+			if(SetMixLayerBandsBounds(&bands, blend_layer, blend_mode) != FALSE)
+			{
+				bands.layers[bands.num_layers] = blend_layer;
+				bands.functions[bands.num_layers] = GetNativeBlendFunction(blend_mode);
+				bands.opacities[bands.num_layers] = (layer->alpha * 255 + 50) / 100;
+				bands.num_layers++;
+			}
+		}
+
+		// ̃C[
+		layer = layer->next;
+
+		// ɍ郌C[ANeBuC[Ȃ
+		if(layer == window->active_layer)
+		{	// ANeBuC[艺̃C[̍f[^XV^C~OL
+			bands.under_active_index = bands.num_layers;
+		}
+	}
+
+	ExecuteMixLayerBands(&bands);
+
+	MEM_FREE_FUNC(bands.layers);
+	MEM_FREE_FUNC(bands.functions);
+	MEM_FREE_FUNC(bands.opacities);
+	MEM_FREE_FUNC(bands.bounds);
+
+	return TRUE;
+}
+
+/*****************************************************
+* MixLayerForSaveInBands֐                         *
+* ۑp̃C[яɕĕɍs     *
+*                                                *
+* window	: `̈̏                         *
+* target	: ̃C[                       *
+* Ԃl                                             *
+*	:TRUE	łȂC[:FALSE *
+*****************************************************/
+static gboolean MixLayerForSaveInBands(DRAW_WINDOW* window, LAYER* target)
+{
+	MIX_LAYER_BANDS bands;
+	LAYER *src;
+
+	bands.target = target;
+	bands.under_active = NULL;
+	bands.layers = (LAYER**)MEM_ALLOC_FUNC(sizeof(*bands.layers)*(window->num_layer+1));
+	bands.functions = (NATIVE_BLEND_FUNC*)MEM_ALLOC_FUNC(sizeof(*bands.functions)*(window->num_layer+1));
+	bands.opacities = (int*)MEM_ALLOC_FUNC(sizeof(*bands.opacities)*(window->num_layer+1));
+	bands.bounds = (GdkRectangle*)MEM_ALLOC_FUNC(sizeof(*bands.bounds)*(window->num_layer+1));
+	bands.num_layers = 0;
+	bands.under_active_index = -1;
+
+	// \łȂSẴC[ׂ
+	for(src = window->layer; src != NULL; src = src->next)
+	{
+		if((src->flags & LAYER_FLAG_INVISIBLE) == 0 && src->layer_type != TYPE_LAYER_SET)
+		{
+			if(!(src->layer_set != NULL && (src->layer_set->flags & LAYER_FLAG_INVISIBLE) != 0))
+			{
+				if(CanMixLayerInBands(window, src) == FALSE)
+				{
+					break;
+				}
+				if(SetMixLayerBandsBounds(&bands, src, src->layer_mode) != FALSE)
+				{
+					bands.layers[bands.num_layers] = src;
+					bands.functions[bands.num_layers] = GetNativeBlendFunction(src->layer_mode);
+					bands.opacities[bands.num_layers] = (src->alpha * 255 + 50) / 100;
+					bands.num_layers++;
+				}
+			}
+		}
+	}
+
+	// яɍłȂC[Ȃ΍s
+	if(src == NULL)
+	{
+		ExecuteMixLayerBands(&bands);
+	}
+
+	MEM_FREE_FUNC(bands.layers);
+	MEM_FREE_FUNC(bands.functions);
+	MEM_FREE_FUNC(bands.opacities);
+	MEM_FREE_FUNC(bands.bounds);
+
+	return src == NULL;
+}
+
+#endif	// #if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
 
 /*****************************************
 * DisplayDrawWindow֐                  *
@@ -53,6 +1501,11 @@ gboolean DisplayDrawWindow(
 	int update_active_under = 0;
 	// [h
 	int blend_mode;
+	// k\p̉摜̒iƃp^[
+	int num_levels;
+	cairo_pattern_t *scaled_pattern;
+	// \͈
+	GdkRectangle viewport;
 
 	// ʕ\pCairo
 	cairo_t *cairo_p;
@@ -65,8 +1518,16 @@ gboolean DisplayDrawWindow(
 		// `̈̍XVtȌԂŕ
 		if((window->flags & DRAW_WINDOW_UPDATE_PART) == 0)
 		{
-			if((window->flags & DRAW_WINDOW_UPDATE_ACTIVE_UNDER) != 0)
+			if((window->flags & (DRAW_WINDOW_UPDATE_ACTIVE_UNDER | DRAW_WINDOW_UPDATE_ACTIVE_OVER)) != 0
+				&& IsViewportMixEnabled(window) != FALSE)
+			{	// g\͕\͈͂̂ݍĔ͈͊O͌񂵂ɂ
+				update_mode = UPDATE_VIEWPORT;
+			}
+			else if((window->flags & DRAW_WINDOW_UPDATE_ACTIVE_UNDER) != 0
+				|| ((window->flags & DRAW_WINDOW_UPDATE_ACTIVE_OVER) != 0 && window->stale_tiles.num_dirty > 0))
 			{	// SC[
+					// (񂵂ɂ^C΃ANeBuC[艺)
+				window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 				(void)memcpy(window->mixed_layer->pixels, window->back_ground, window->pixel_buf_size);
 				// ŏ̃C[͈ԉ̃C[
 				layer = window->layer;
@@ -120,25 +1581,10 @@ gboolean DisplayDrawWindow(
 					end_y = (int)(window->update.height = window->height - window->update.y);
 				}
 
-				if(end_y >= 0)
-				{
-					if(window->active_layer == window->layer)
-					{	// ANeBuC[ԉȂΔwĩsNZf[^Rs[
-						for(y=0; y<end_y; y++)
-						{
-							(void)memcpy(&window->mixed_layer->pixels[(y+(int)window->update.y)*window->mixed_layer->stride+(int)window->update.x*4],
-								&window->back_ground[(y+(int)window->update.y)*window->mixed_layer->stride+(int)window->update.x*4], stride);
-						}
-					}
-					else
-					{	// łȂ΃ANeBuC[艺̍ς݂̃f[^Rs[
-						for(y=0; y<end_y; y++)
-						{
-							(void)memcpy(&window->mixed_layer->pixels[(y+(int)window->update.y)*window->mixed_layer->stride+(int)window->update.x*4],
-								&window->under_active->pixels[(y+(int)window->update.y)*window->mixed_layer->stride+(int)window->update.x*4], stride);
-						}
-					}
-					layer = window->active_layer;
+				if(end_y > 0)
+				{	// XV͈͂Ɋ|^CɍXVtO𗧂Ă
+					AddUpdateTiles(&window->update_tiles, (int)window->update.x, (int)window->update.y,
+						(int)window->update.width, end_y);
 				}
 			}
 			else
@@ -147,16 +1593,6 @@ gboolean DisplayDrawWindow(
 				goto execute_update;
 			}
 
-			window->update.surface_p = cairo_surface_create_for_rectangle(
-				window->mixed_layer->surface_p, window->update.x, window->update.y,
-					window->update.width, window->update.height);
-			window->update.cairo_p = cairo_create(window->update.surface_p);
-			window->temp_update = window->update;
-			window->temp_update.surface_p = cairo_surface_create_for_rectangle(
-				window->temp_layer->surface_p, window->update.x, window->update.y,
-					window->update.width, window->update.height);
-			window->temp_update.cairo_p = cairo_create(window->temp_update.surface_p);
-
 			update_mode = UPDATE_PART;
 		}
 	}
@@ -166,8 +1602,47 @@ gboolean DisplayDrawWindow(
 		update_mode = NO_UPDATE;
 	}
 
-	if(update_mode == UPDATE_ALL)
+	if(update_mode != NO_UPDATE)
+	{	// ҏWꂽ\̂郌C[̕s͈̔͂j
+		CheckLayerContentBounds(window);
+	}
+
+	if(update_mode == UPDATE_VIEWPORT)
+	{
+		// NbsOp̃}XNf[^͍蒼܂ŎgȂ
+		window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_CACHED);
+		// ANeBuC[̍ʂ͏̃C[ς̂ݔj
+		if(window->above_active_state != GetAboveActiveState(window))
+		{
+			window->flags &= ~(DRAW_WINDOW_ABOVE_ACTIVE_CACHED);
+		}
+		// SẴ^C񂵂ɂĕ\͈͂̃^C͉ō
+		AddUpdateTiles(&window->stale_tiles, 0, 0, window->width, window->height);
+		// \͈͊Õ^C̓AChɍ
+		if(window->stale_idle_id == 0)
+		{
+			window->stale_idle_id = g_idle_add((GSourceFunc)MixStaleTilesIdle, window);
+		}
+	}
+	else if(update_mode == UPDATE_ALL)
 	{
+		// NbsOp̃}XNf[^͑Ŝ蒼
+		window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_CACHED);
+		// Ŝ̂Ō񂵂ɂ^C͕sv
+		if(window->stale_tiles.num_dirty > 0)
+		{
+			ResetStaleTiles(window);
+		}
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+		// LoXяɕĕɍ
+			// łȂ1C[
+		if(MixLayersInBands(window, layer) != FALSE)
+		{
+			layer = NULL;
+		}
+#endif
+
 		// ԏ̃C[ɒH蒅܂Ń[v
 		while(layer != NULL)
 		{
@@ -250,84 +1725,9 @@ gboolean DisplayDrawWindow(
 			}
 		}	// ԏ̃C[ɒH蒅܂Ń[v
 				// while(layer != NULL)
-	}
-	else
-	{
-		// ԏ̃C[ɒH蒅܂Ń[v
-		while(layer != NULL)
-		{
-			// C[Zbg̃C[ł
-			if(layer->layer_set != NULL)
-			{	// SXVȂ
-				if(layer->layer_set == window->active_layer_set)
-				{
-					MixLayerSetActiveOver(layer, &layer, window);
-				}	// else if(layer->layer_set == window->active_layer_set)
-				else
-				{
-					layer = layer->layer_set;
-				}
-			}	// if(layer->layer_set != NULL)
-
-			// C[ƍ@xL
-			blend_layer = layer;
-			blend_mode = layer->layer_mode;
-
-			// \C[ɂȂĂȂƂmF
-			if((blend_layer->flags & LAYER_FLAG_INVISIBLE) == 0)
-			{	// A郌C[ANeBuC[Ȃ
-				if(layer == window->active_layer)
-				{
-					if(layer->layer_type == TYPE_NORMAL_LAYER)
-					{	// ʏ탌C[
-							// ƃC[ƃANeBuC[xĂ牺̃C[ƍ
-						(void)memcpy(window->temp_layer->pixels, layer->pixels, layer->stride*layer->height);
-						window->part_layer_blend_functions[window->work_layer->layer_mode](window->work_layer, &window->temp_update);
-						//g_layer_blend_funcs[window->work_layer->layer_mode](window->work_layer, window->temp_layer);
-						blend_layer = window->temp_layer;
-						blend_layer->alpha = layer->alpha;
-						blend_layer->flags = layer->flags;
-						blend_layer->prev = layer->prev;
-					}
-					else if(layer->layer_type == TYPE_VECTOR_LAYER)
-					{	// xNgC[
-							// C[̃X^CYsȂĂƃC[Ɖ̃C[
-						RasterizeVectorLayer(window, layer, layer->layer_data.vector_layer_p);
-						if(window->work_layer->layer_mode != LAYER_BLEND_NORMAL)
-						{
-							window->layer_blend_functions[window->work_layer->layer_mode](window->work_layer, layer);
-						}
-					}
-					else if(layer->layer_type == TYPE_TEXT_LAYER)
-					{	// eLXgC[
-							// eLXg̓eX^CYĂ牺̃C[ƍ
-						RenderTextLayer(window, layer, layer->layer_data.text_layer_p);
-					}
-
-					// TlCXV
-					gtk_widget_queue_draw(layer->widget->thumbnail);
-				}
 
-				// Ώۂƕ@m肵̂ōs
-				window->part_layer_blend_functions[blend_mode](blend_layer, &window->update);
-				// f[^ɖ߂
-				window->temp_layer->alpha = 100;
-				window->temp_layer->flags = 0;
-				window->temp_layer->prev = NULL;
-				cairo_set_operator(window->temp_layer->cairo_p, CAIRO_OPERATOR_OVER);
-			}	// \C[ɂȂĂȂƂmF
-			// if((blend_layer->flags & LAYER_FLAG_INVISIBLE) == 0)
-
-			// ̃C[
-			layer = layer->next;
-
-			// ɍ郌C[ANeBuC[Ȃ
-			if(layer == window->active_layer)
-			{	// ANeBuC[艺̃C[̍f[^XV
-				(void)memcpy(window->under_active->pixels, window->mixed_layer->pixels, window->pixel_buf_size);
-			}
-		}	// ԏ̃C[ɒH蒅܂Ń[v
-				// while(layer != NULL)
+		// XVpɃANeBuC[̍ʂL
+		UpdateAboveActiveCache(window);
 	}
 
 	if(update_mode == UPDATE_ALL)
@@ -338,54 +1738,52 @@ gboolean DisplayDrawWindow(
 				window->mixed_layer->pixels, window->width*window->height, window->app->display_filter.filter_data);
 		}
 
+		// k\͏k摜蒼
+		num_levels = GetMixedPyramidLevel(window);
+		(void)PrepareMixedPyramid(window, num_levels);
+		UpdateMixedPyramid(window, num_levels, 0, 0, window->width, window->height);
+		scaled_pattern = CreateScaledMixedPattern(window, num_levels);
+
 		// ݂̊gkŕ\p̃f[^ɍf[^]
 		cairo_set_operator(window->scaled_mixed->cairo_p, CAIRO_OPERATOR_SOURCE);
-		cairo_set_source(window->scaled_mixed->cairo_p, window->mixed_pattern);
+		cairo_set_source(window->scaled_mixed->cairo_p, scaled_pattern);
 		cairo_paint(window->scaled_mixed->cairo_p);
+		cairo_pattern_destroy(scaled_pattern);
 	}
 	else if(update_mode == UPDATE_PART)
 	{
-		FLOAT_T zoom = window->zoom_rate;
-
-		if(window->app->display_filter.filter_func != NULL)
+		// 񂵂ɂ^C`ɍłȂȂĂΐɑSč
+		if(window->stale_tiles.num_dirty > 0 && CanMixViewportOnly(window) == FALSE)
 		{
-			int start_x = (int)window->update.x;
-			int start_y = (int)window->update.y;
-			int width = (int)window->update.width;
-			int height = (int)window->update.height;
-			int stride = width * 4;
-			for(y=0; y<height; y++)
-			{
-				(void)memcpy(&window->temp_layer->pixels[y*stride],
-					&window->mixed_layer->pixels[(start_y+y)*window->mixed_layer->stride + start_x*4], stride);
-			}
-			window->app->display_filter.filter_func(window->temp_layer->pixels,
-				window->temp_layer->pixels, width*height, window->app->display_filter.filter_data);
-			for(y=0; y<height; y++)
-			{
-				(void)memcpy(&window->mixed_layer->pixels[(start_y+y)*window->mixed_layer->stride + start_x*4],
-					&window->temp_layer->pixels[y*stride], stride);
-			}
+			FlushStaleTiles(window);
 		}
 
-		cairo_save(window->scaled_mixed->cairo_p);
-		cairo_rectangle(window->scaled_mixed->cairo_p, (int)(window->update.x * zoom), (int)(window->update.y * zoom),
-			(int)(window->update.width * zoom), (int)(window->update.height * zoom));
-		cairo_clip(window->scaled_mixed->cairo_p);
-		cairo_set_operator(window->scaled_mixed->cairo_p, CAIRO_OPERATOR_OVER);
-		cairo_set_source(window->scaled_mixed->cairo_p, window->mixed_pattern);
-		cairo_paint(window->scaled_mixed->cairo_p);
-		cairo_restore(window->scaled_mixed->cairo_p);
-		//ScaleNearest(window);
-
-		cairo_surface_destroy(window->update.surface_p);
-		cairo_destroy(window->update.cairo_p);
-		cairo_surface_destroy(window->temp_update.surface_p);
-		cairo_destroy(window->temp_update.cairo_p);
+		// XVtO̗Ă^C`ɍ
+			// 񂵂ɂ^C܂ދ`͈ԉ̃C[獇
+		while(NextUpdateTilesRectangle(&window->update_tiles,
+			window->width, window->height, &window->update) != FALSE)
+		{
+			MixLayersUpdateRectangle(window,
+				TakeStaleTiles(&window->stale_tiles, &window->update));
+		}
 
 		window->flags &= ~(DRAW_WINDOW_UPDATE_PART);
 	}
 
+	// \͈͂Ɍ񂵂ɂ^C΍
+	if(window->stale_tiles.num_dirty > 0)
+	{
+		if(CanMixViewportOnly(window) == FALSE)
+		{
+			FlushStaleTiles(window);
+		}
+		else if(GetDisplayViewport(window, &viewport) != FALSE)
+		{
+			CheckLayerContentBounds(window);
+			MixStaleTilesInArea(window, &viewport);
+		}
+	}
+
 	(void)memcpy(window->disp_layer->pixels, window->scaled_mixed->pixels,
 		window->scaled_mixed->stride * window->scaled_mixed->height);
 
@@ -525,7 +1923,8 @@ execute_update:
 		| DRAW_WINDOW_UPDATE_ACTIVE_OVER | DRAW_WINDOW_UPDATE_AREA_INITIALIZED);
 
 	// irQ[Vуvr[̓eXV
-	if(update_mode != NO_UPDATE)
+		// (񂵂ɂ^CcĂΑSčIɍXV)
+	if(update_mode != NO_UPDATE && window->stale_tiles.num_dirty <= 0)
 	{
 		if(window->app->navigation_window.draw_area != NULL)
 		{
@@ -573,6 +1972,7 @@ gboolean DisplayBrushPreview(
 
 	// SC[
 	(void)memcpy(window->mixed_layer->pixels, window->back_ground, window->pixel_buf_size);
+	window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_CACHED);
 	// ŏ̃C[͈ԉ̃C[
 	layer = window->layer;
 
@@ -682,6 +2082,18 @@ LAYER* MixLayerForSave(DRAW_WINDOW* window)
 	);
 	LAYER* src = window->layer;
 
+	// NbsOp̃}XNf[^͍蒼
+	window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_CACHED);
+	CheckLayerContentBounds(window);
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+	// LoXяɕĕɍ
+	if(MixLayerForSaveInBands(window, ret) != FALSE)
+	{
+		return ret;
+	}
+#endif
+
 	// \łȂSẴC[
 	while(src != NULL)
 	{
@@ -718,6 +2130,18 @@ LAYER* MixLayerForSaveWithBackGround(DRAW_WINDOW* window)
 
 	(void)memcpy(ret->pixels, window->back_ground, window->pixel_buf_size);
 
+	// NbsOp̃}XNf[^͍蒼
+	window->flags &= ~(DRAW_WINDOW_MASK_SOURCE_CACHED);
+	CheckLayerContentBounds(window);
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+	// LoXяɕĕɍ
+	if(MixLayerForSaveInBands(window, ret) != FALSE)
+	{
+		return ret;
+	}
+#endif
+
 	// \łȂSẴC[
 	while(src != NULL)
 	{
@@ -48,6 +48,98 @@ EXTERN gboolean DisplayBrushPreview(
 *****************************/
 EXTERN void UpdateDrawWindow(struct _DRAW_WINDOW* window);
 
+/*************************************
+* InitializeUpdateTiles֐          *
+* ʍXVp̃^C *
+*                                *
+* tiles	: ^C       *
+* width	: LoX̕             *
+* height	: LoX̍       *
+*************************************/
+EXTERN void InitializeUpdateTiles(
+	struct _UPDATE_TILES* tiles,
+	int width,
+	int height
+);
+
+/***********************************
+* ReleaseUpdateTiles֐           *
+* ʍXVp̃^CJ *
+*                              *
+* tiles	: J^C       *
+***********************************/
+EXTERN void ReleaseUpdateTiles(struct _UPDATE_TILES* tiles);
+
+/*****************************
+* ReleaseMixedPyramid֐    *
+* k\p̉摜J *
+*                        *
+* window	: `̈̏ *
+*****************************/
+EXTERN void ReleaseMixedPyramid(struct _DRAW_WINDOW* window);
+
+/*********************************************
+* ResetStaleTiles֐                        *
+* 񂵂ɂ^C̏ *
+*                                        *
+* window	: `̈̏                 *
+*********************************************/
+EXTERN void ResetStaleTiles(struct _DRAW_WINDOW* window);
+
+/*******************************************
+* ReleaseStaleTiles֐                    *
+* 񂵂ɂ^C̏J *
+*                                      *
+* window	: `̈̏               *
+*******************************************/
+EXTERN void ReleaseStaleTiles(struct _DRAW_WINDOW* window);
+
+/***********************************************
+* FlushStaleTiles֐                          *
+* 񂵂ɂ^CSč       *
+* (LoX̍ʂQƂOɌĂяo) *
+*                                          *
+* window	: `̈̏                   *
+***********************************************/
+EXTERN void FlushStaleTiles(struct _DRAW_WINDOW* window);
+
+/*********************************************
+* AddUpdateTiles֐                         *
+* w͈͂Ɋ|^CɍXVtO𗧂Ă *
+*                                        *
+* tiles	: ^C                         *
+* x		: XV͈͂̍XW              *
+* y		: XV͈͂̍YW              *
+* width	: XV͈͂̕                       *
+* height	: XV͈͂̍                 *
+*********************************************/
+EXTERN void AddUpdateTiles(
+	struct _UPDATE_TILES* tiles,
+	int x,
+	int y,
+	int width,
+	int height
+);
+
+/*******************************************************
+* NextUpdateTilesRectangle֐                         *
+* XVtO̗Ă^C`ɂ܂Ƃ߂Ďo *
+* (o^C̃tO͍~낷)                   *
+*                                                  *
+* tiles	: ^C                                   *
+* width	: LoX̕                               *
+* height	: LoX̍                         *
+* rect		: o`i[AhX         *
+* Ԃl                                               *
+*	o:TRUE XV^C:FALSE           *
+*******************************************************/
+EXTERN gboolean NextUpdateTilesRectangle(
+	struct _UPDATE_TILES* tiles,
+	int width,
+	int height,
+	struct _UPDATE_RECTANGLE* rect
+);
+
 /*******************************************************
 * MixLayerForSave֐                                  *
 * ۑ邽߂ɔwisNZf[^ŃC[ *
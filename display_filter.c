@@ -166,19 +166,216 @@ void GrayScaleDisplayFilterYIQ(GtkWidget* menu, APPLICATION* app)
 	}
 }
 
+/***************************************
+* BuildIccDisplayLut֐               *
+* Fϊϊe[u쐬     *
+*                                  *
+* lut		: ϊe[u             *
+* transform	: Fϊ                   *
+* Ԃl                               *
+*	쐬ł:TRUE	쐬łȂ:FALSE *
+***************************************/
+static int BuildIccDisplayLut(ICC_DISPLAY_LUT* lut, cmsHTRANSFORM transform)
+{
+	// iq_̐F
+	uint8 *point;
+	// iq_̈ʒu
+	int position;
+	// forp̃JE^
+	int r, g, b;
+	int i;
+
+	ReleaseIccDisplayLut(lut);
+
+	lut->table = (uint8*)MEM_ALLOC_FUNC(
+		ICC_DISPLAY_LUT_GRID * ICC_DISPLAY_LUT_GRID * ICC_DISPLAY_LUT_GRID * 4);
+	if(lut->table == NULL)
+	{
+		return FALSE;
+	}
+
+	// iq_̐FׂĈxɐFϊ
+	point = lut->table;
+	for(r=0; r<ICC_DISPLAY_LUT_GRID; r++)
+	{
+		for(g=0; g<ICC_DISPLAY_LUT_GRID; g++)
+		{
+			for(b=0; b<ICC_DISPLAY_LUT_GRID; b++, point+=4)
+			{
+				point[0] = (uint8)((b * 255 + (ICC_DISPLAY_LUT_GRID - 1) / 2) / (ICC_DISPLAY_LUT_GRID - 1));
+				point[1] = (uint8)((g * 255 + (ICC_DISPLAY_LUT_GRID - 1) / 2) / (ICC_DISPLAY_LUT_GRID - 1));
+				point[2] = (uint8)((r * 255 + (ICC_DISPLAY_LUT_GRID - 1) / 2) / (ICC_DISPLAY_LUT_GRID - 1));
+				point[3] = 0xff;
+			}
+		}
+	}
+	cmsDoTransform(transform, lut->table, lut->table,
+		ICC_DISPLAY_LUT_GRID * ICC_DISPLAY_LUT_GRID * ICC_DISPLAY_LUT_GRID);
+
+	// fliq_Ɗiq_Ԃ̈ʒu߂\
+	for(i=0; i<256; i++)
+	{
+		position = (i * (ICC_DISPLAY_LUT_GRID - 1) * 256 + 127) / 255;
+		lut->index[i] = position >> 8;
+		lut->fraction[i] = position & 0xff;
+		if(lut->index[i] >= ICC_DISPLAY_LUT_GRID - 1)
+		{
+			lut->index[i] = ICC_DISPLAY_LUT_GRID - 2;
+			lut->fraction[i] = 256;
+		}
+	}
+
+	lut->transform = (void*)transform;
+
+	return TRUE;
+}
+
+/*****************************************
+* ApplyIccDisplayLut֐                 *
+* ϊe[ulʑ̕ԂĐFϊ *
+*                                    *
+* lut			: ϊe[u           *
+* source		: ϊÕf[^         *
+* destination	: ϊ̃f[^i[   *
+* num_pixel		: sNZ             *
+*****************************************/
+static void ApplyIccDisplayLut(
+	const ICC_DISPLAY_LUT* lut,
+	uint8* source,
+	uint8* destination,
+	int num_pixel
+)
+{
+	// ׂ̊iq_܂ł̃oCg
+	const int step_b = 4;
+	const int step_g = ICC_DISPLAY_LUT_GRID * 4;
+	const int step_r = ICC_DISPLAY_LUT_GRID * ICC_DISPLAY_LUT_GRID * 4;
+	int i;
+
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(lut, source, destination, num_pixel)
+#endif
+	for(i=0; i<num_pixel; i++)
+	{
+		const uint8 *src = &source[i*4];
+		uint8 *dst = &destination[i*4];
+		// iq_Ԃ̈ʒu
+		int fb = lut->fraction[src[0]];
+		int fg = lut->fraction[src[1]];
+		int fr = lut->fraction[src[2]];
+		// ԂɎglʑ̂̒_
+		const uint8 *c0 = &lut->table[lut->index[src[2]] * step_r
+			+ lut->index[src[1]] * step_g + lut->index[src[0]] * step_b];
+		const uint8 *c1, *c2;
+		const uint8 *c3 = c0 + step_r + step_g + step_b;
+		// _̏d
+		int w0, w1, w2, w3;
+		int j;
+
+		// iq_Ԃ̈ʒȗ召Ŏlʑ̂I
+		if(fr >= fg)
+		{
+			if(fg >= fb)
+			{
+				c1 = c0 + step_r,	c2 = c0 + step_r + step_g;
+				w0 = 256 - fr,	w1 = fr - fg,	w2 = fg - fb,	w3 = fb;
+			}
+			else if(fr >= fb)
+			{
+				c1 = c0 + step_r,	c2 = c0 + step_r + step_b;
+				w0 = 256 - fr,	w1 = fr - fb,	w2 = fb - fg,	w3 = fg;
+			}
+			else
+			{
+				c1 = c0 + step_b,	c2 = c0 + step_r + step_b;
+				w0 = 256 - fb,	w1 = fb - fr,	w2 = fr - fg,	w3 = fg;
+			}
+		}
+		else
+		{
+			if(fr >= fb)
+			{
+				c1 = c0 + step_g,	c2 = c0 + step_r + step_g;
+				w0 = 256 - fg,	w1 = fg - fr,	w2 = fr - fb,	w3 = fb;
+			}
+			else if(fg >= fb)
+			{
+				c1 = c0 + step_g,	c2 = c0 + step_g + step_b;
+				w0 = 256 - fg,	w1 = fg - fb,	w2 = fb - fr,	w3 = fr;
+			}
+			else
+			{
+				c1 = c0 + step_b,	c2 = c0 + step_g + step_b;
+				w0 = 256 - fb,	w1 = fb - fg,	w2 = fg - fr,	w3 = fr;
+			}
+		}
+
+		// At@lcmsDoTransformƓύXȂ
+		for(j=0; j<3; j++)
+		{
+			dst[j] = (uint8)((w0 * c0[j] + w1 * c1[j] + w2 * c2[j] + w3 * c3[j] + 128) >> 8);
+		}
+	}
+}
+
+/*********************************
+* ReleaseIccDisplayLut֐       *
+* ϊe[uJ         *
+* (Fϊ폜OɌĂяo) *
+*                            *
+* lut	: ϊe[u           *
+*********************************/
+void ReleaseIccDisplayLut(ICC_DISPLAY_LUT* lut)
+{
+	MEM_FREE_FUNC(lut->table);
+	lut->table = NULL;
+	lut->transform = NULL;
+}
+
+/*************************************************************
+* AdaptIccProfileDisplayFilter֐                           *
+* ICCvt@CŐFϊ                                *
+*                                                        *
+* source		: ϊÕf[^                             *
+* destination	: ϊ̃f[^i[                       *
+* num_pixel		: sNZ                                 *
+* filter_data	: AvP[VǗ\̂̃AhX *
+*************************************************************/
 void AdaptIccProfileDisplayFilter(uint8* source, uint8* destination, int num_pixel, void* filter_data)
 {
 	APPLICATION *app = (APPLICATION*)filter_data;
 	DRAW_WINDOW *window = app->draw_window[app->active_window];
+	// gpFϊƕϊe[u
+	cmsHTRANSFORM transform;
+	ICC_DISPLAY_LUT *lut;
 
 	if(window != NULL && window->icc_transform != NULL)
 	{
-		cmsDoTransform(window->icc_transform, source, destination, num_pixel);
+		transform = window->icc_transform;
+		lut = &window->icc_lut;
 	}
 	else
 	{
-		cmsDoTransform(app->icc_transform, source, destination, num_pixel);
+		transform = app->icc_transform;
+		lut = &app->icc_lut;
+	}
+
+	if(transform == NULL)
+	{
+		return;
 	}
+
+	// Fϊς̂ݕϊe[u蒼
+	if(lut->table == NULL || lut->transform != (void*)transform)
+	{
+		if(BuildIccDisplayLut(lut, transform) == FALSE)
+		{
+			cmsDoTransform(transform, source, destination, num_pixel);
+			return;
+		}
+	}
+
+	ApplyIccDisplayLut(lut, source, destination, num_pixel);
 }
 
 /*****************************************************
@@ -23,6 +23,21 @@ typedef struct _DISPLAY_FILTER
 	void *filter_data;
 } DISPLAY_FILTER;
 
+// ICCvt@CKp̕ϊe[u1ӂ̊iq_̐
+#define ICC_DISPLAY_LUT_GRID 33
+
+/**********************************************
+* ICC_DISPLAY_LUT\                       *
+* ICCvt@CKpϊe[u *
+**********************************************/
+typedef struct _ICC_DISPLAY_LUT
+{
+	void *transform;	// e[u쐬Fϊ
+	uint8 *table;		// iq_̕ϊ̐F(BGRA)
+	int index[256];		// flɑΉiq_
+	int fraction[256];	// iq_Ԃ̈ʒu(0`256)
+} ICC_DISPLAY_LUT;
+
 // ֐̃vg^Cv錾
 /*********************************************
 * RGB2GrayScaleFilter֐                    *
@@ -46,4 +61,13 @@ extern void RGB2GrayScaleFilter(uint8* source, uint8* destination, int num_pixel
 *********************************************/
 extern void RGBA2GrayScaleFilter(uint8* source, uint8* destination, int num_pixel, void* filter_data);
 
+/*********************************
+* ReleaseIccDisplayLut֐       *
+* ϊe[uJ         *
+* (Fϊ폜OɌĂяo) *
+*                            *
+* lut	: ϊe[u           *
+*********************************/
+extern void ReleaseIccDisplayLut(ICC_DISPLAY_LUT* lut);
+
 #endif	// #ifndef _INCLUDED_DISPLAY_FILTER_H_
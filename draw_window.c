@@ -7,6 +7,7 @@
 
 #include <string.h>
 #include <math.h>
+#include <zlib.h>
 #include "memory.h"
 #include "draw_window.h"
 #include "display.h"
@@ -613,6 +614,11 @@ DRAW_WINDOW* CreateDrawWindow(
 	ret->layer_blend_functions = app->layer_blend_functions;
 	ret->part_layer_blend_functions = app->part_layer_blend_functions;
 
+	// f[^̃gpʂ̏Zbg
+	SetHistoryMemoryLimit(&ret->history, (size_t)app->preference.history_memory_limit * 1024 * 1024);
+	// ꎞt@CɑޔɎc̐Zbg
+	SetHistorySpillSteps(&ret->history, app->preference.history_spill_steps);
+
 	// ۑ̃R[obN֐Zbg
 	if(app->preference.auto_save != 0)
 	{
@@ -710,12 +716,31 @@ DRAW_WINDOW* CreateDrawWindow(
 		NULL, NULL, NULL, ret);
 	(void)memcpy(ret->under_active->pixels, ret->back_ground, ret->pixel_buf_size);
 
+	// ANeBuC[摜̕ۑp
+	ret->above_active = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, ret);
+
+	// NbsÕ}XNpɃANeBuC[ƍƃC[摜̕ۑp
+	ret->mask_source = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, ret);
+
+	// XVp̃^C쐬
+	InitializeUpdateTiles(&ret->update_tiles, width, height);
+	InitializeUpdateTiles(&ret->work_tiles, width, height);
+	ResetStaleTiles(ret);
+
 	// `̈̐VK쐬쐬̃tO~낷
 	app->flags &= ~(APPLICATION_IN_MAKE_NEW_DRAW_AREA);
 
 	// eNX`ݒ
 	FillTextureLayer(ret->texture, &app->textures);
 
+	// ϐŎw肳Ă΃uV̓͂L^
+	if(g_getenv("KABURAGI_STROKE_RECORD") != NULL)
+	{
+		(void)StartStrokeRecord(ret, g_getenv("KABURAGI_STROKE_RECORD"));
+	}
+
 	return ret;
 }
 
@@ -873,6 +898,19 @@ DRAW_WINDOW* CreateTempDrawWindow(
 		NULL, NULL, NULL, ret);
 	(void)memcpy(ret->under_active->pixels, ret->back_ground, ret->pixel_buf_size);
 
+	// ANeBuC[摜̕ۑp
+	ret->above_active = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, ret);
+
+	// NbsÕ}XNpɃANeBuC[ƍƃC[摜̕ۑp
+	ret->mask_source = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, ret);
+
+	// XVp̃^C쐬
+	InitializeUpdateTiles(&ret->update_tiles, width, height);
+	InitializeUpdateTiles(&ret->work_tiles, width, height);
+	ResetStaleTiles(ret);
+
 	return ret;
 }
 
@@ -1097,8 +1135,10 @@ void DeleteDrawWindow(DRAW_WINDOW** window)
 {
 	// 폜郌C[Ǝɍ폜郌C[
 	LAYER* delete_layer, *next_delete;
+#ifdef OLD_SELECTION_AREA
 	// forp̃JE^
 	int i;
+#endif
 
 	// ԂŌĂ΂R[obN֐~
 	if((*window)->timer_id != 0)
@@ -1109,6 +1149,12 @@ void DeleteDrawWindow(DRAW_WINDOW** window)
 	{
 		(void)g_source_remove((*window)->auto_save_id);
 	}
+	if((*window)->stroke_queue.dispatch_id != 0)
+	{
+		(void)g_source_remove((*window)->stroke_queue.dispatch_id);
+	}
+	// uV̓͂̋L^I
+	StopStrokeRecord(*window);
 	if((*window)->timer != NULL)
 	{
 		g_timer_destroy((*window)->timer);
@@ -1142,11 +1188,22 @@ void DeleteDrawWindow(DRAW_WINDOW** window)
 	DeleteLayer(&(*window)->temp_layer);
 	DeleteLayer(&(*window)->selection);
 	DeleteLayer(&(*window)->under_active);
+	DeleteLayer(&(*window)->above_active);
+	DeleteLayer(&(*window)->mask_source);
 	DeleteLayer(&(*window)->mask);
 	DeleteLayer(&(*window)->mask_temp);
 	DeleteLayer(&(*window)->texture);
 	DeleteLayer(&(*window)->work_layer);
 
+	// XVp̃^CJ
+	ReleaseUpdateTiles(&(*window)->update_tiles);
+	ReleaseUpdateTiles(&(*window)->work_tiles);
+	ReleaseStaleTiles(*window);
+	// k\p̉摜J
+	ReleaseMixedPyramid(*window);
+	// ICCvt@CKp̕ϊe[uJ
+	ReleaseIccDisplayLut(&(*window)->icc_lut);
+
 #ifdef OLD_SELECTION_AREA
 	// I͈͂̏J
 	for(i=0; i<(*window)->selection_area.num_area; i++)
@@ -1163,9 +1220,12 @@ void DeleteDrawWindow(DRAW_WINDOW** window)
 #endif
 
 	// f[^̏J
-	for(i=0; i<HISTORY_BUFFER_SIZE; i++)
+	ReleaseHistory(&(*window)->history);
+
+	// C[IĎ\J
+	if((*window)->layer_table != NULL)
 	{
-		MEM_FREE_FUNC((*window)->history.history[i].data);
+		ght_finalize((*window)->layer_table);
 	}
 
 	MEM_FREE_FUNC(*window);
@@ -1209,6 +1269,8 @@ void SwapDrawWindowFromMemoryStream(DRAW_WINDOW* window, MEMORY_STREAM_PTR strea
 	DeleteLayer(&window->temp_layer);
 	DeleteLayer(&window->selection);
 	DeleteLayer(&window->under_active);
+	DeleteLayer(&window->above_active);
+	DeleteLayer(&window->mask_source);
 	DeleteLayer(&window->mask);
 	DeleteLayer(&window->mask_temp);
 	DeleteLayer(&window->work_layer);
@@ -1253,6 +1315,13 @@ void SwapDrawWindowFromMemoryStream(DRAW_WINDOW* window, MEMORY_STREAM_PTR strea
 	// ȌԂf[^𕜌
 	ReadOriginalFormatMemoryStream(window, stream);
 
+	// XVp̃^C蒼
+	InitializeUpdateTiles(&window->update_tiles, window->width, window->height);
+	InitializeUpdateTiles(&window->work_tiles, window->width, window->height);
+	ResetStaleTiles(window);
+	// ANeBuC[̍ʂ͍蒼܂ŎgȂ
+	window->flags &= ~(DRAW_WINDOW_ABOVE_ACTIVE_CACHED | DRAW_WINDOW_MASK_SOURCE_CACHED);
+
 	// \p̃obt@XV
 	DrawWindowChangeZoom(window, window->zoom);
 
@@ -1492,6 +1561,7 @@ void FlipDrawWindowHorizontally(DRAW_WINDOW* window)
 	}
 
 	// `eXV
+	ClearLayerContentBounds(window);
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 }
 
@@ -1536,6 +1606,7 @@ void FlipDrawWindowVertically(DRAW_WINDOW* window)
 	}
 
 	// `eXV
+	ClearLayerContentBounds(window);
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 }
 
@@ -1650,6 +1721,57 @@ void MergeAllLayer(DRAW_WINDOW* window)
 	DeleteLayer(&merge);
 }
 
+/***********************************************************
+* ResizeDrawWindowBuffers֐                              *
+* C[ȊO̕`̈̃obt@VTCYɍ킹 *
+*                                                      *
+* window		: TCYύX`̈                 *
+* new_width		: V                                 *
+* new_height	: V                               *
+***********************************************************/
+static void ResizeDrawWindowBuffers(DRAW_WINDOW* window, int32 new_width, int32 new_height)
+{
+	// wĩsNZf[^XV
+	window->back_ground = (uint8*)MEM_REALLOC_FUNC(
+		window->back_ground, new_width*new_height*window->channel);
+	(void)memset(window->back_ground, 0xff, new_width*new_height*window->channel);
+
+	// ƃC[AꎞۑC[̃TCYύX
+	DeleteLayer(&window->temp_layer);
+	window->temp_layer = CreateLayer(0, 0, new_width, new_height, 5,
+		TYPE_NORMAL_LAYER, NULL, NULL, NULL, window);
+	ResizeLayerBuffer(window->mask, new_width, new_height);
+	ResizeLayerBuffer(window->mask_temp, new_width, new_height);
+	ResizeLayerBuffer(window->work_layer, new_width, new_height);
+	ResizeLayerBuffer(window->mixed_layer, new_width, new_height);
+	ResizeLayerBuffer(window->under_active, new_width, new_height);
+	ResizeLayerBuffer(window->above_active, new_width, new_height);
+	ResizeLayerBuffer(window->mask_source, new_width, new_height);
+	ResizeLayerBuffer(window->selection, new_width, new_height);
+	ResizeLayerBuffer(window->texture, new_width, new_height);
+
+	// Vƍ`̈̏ɃZbg
+	window->width = new_width, window->height = new_height;
+	// sNZf[^̃oCgA1s̃oCgvZ
+	window->stride = new_width * window->channel;
+	window->pixel_buf_size = window->stride * new_height;
+	// XVp̃^C蒼
+	InitializeUpdateTiles(&window->update_tiles, new_width, new_height);
+	InitializeUpdateTiles(&window->work_tiles, new_width, new_height);
+	ResetStaleTiles(window);
+	// ANeBuC[̍ʂ͍蒼܂ŎgȂ
+	window->flags &= ~(DRAW_WINDOW_ABOVE_ACTIVE_CACHED | DRAW_WINDOW_MASK_SOURCE_CACHED);
+
+	// ʂɑ΂ĊgEkݒ肷邽߂̃p^[쐬
+	window->mixed_pattern = cairo_pattern_create_for_surface(window->mixed_layer->surface_p);
+	cairo_pattern_set_filter(window->mixed_pattern, CAIRO_FILTER_FAST);
+
+	// irQ[V̕\ݒ
+	ChangeNavigationDrawWindow(&window->app->navigation_window, window);
+	// eNX`p̃C[XV
+	FillTextureLayer(window->texture, &window->app->textures);
+}
+
 /**********************************************
 * CHANGE_DRAW_WINDOW_RESOLUTION_HISTORY\ *
 * 𑜓xύX̗f[^                      *
@@ -1716,6 +1838,247 @@ static void ChangeDrawWindowResolutionRedo(DRAW_WINDOW* window, void* p)
 		history_data.new_width, history_data.new_height);
 }
 
+/*******************************************
+* CHANGE_DRAW_WINDOW_PIXELS_HISTORY\  *
+* C[̃sNZf[^ŕۑ     *
+* 𑜓xELoXTCYύX̗f[^ *
+*******************************************/
+typedef struct _CHANGE_DRAW_WINDOW_PIXELS_HISTORY
+{
+	int32 new_width, new_height;		// ύX̃TCY
+	int32 before_width, before_height;	// ύXÕTCY
+	uint16 num_layer;					// ۑC[̐
+	// ȍ~̓C[LAYER_PIXELS_HISTORY_DATA
+} CHANGE_DRAW_WINDOW_PIXELS_HISTORY;
+
+typedef struct _LAYER_PIXELS_HISTORY_DATA
+{
+	uint32 layer_id;
+	int32 width, height, stride;
+	size_t compressed_size;		// k̃oCg(0Ȃ疳k)
+	uint16 name_length;
+	gchar *name;
+	uint8 *pixels;
+} LAYER_PIXELS_HISTORY_DATA;
+
+/***************************************************
+* ChangeDrawWindowPixelsUndo֐                   *
+* 𑜓xELoXTCY̕ύX                 *
+* ۑĂC[̃sNZf[^Ōɖ߂ *
+*                                              *
+* window	: `̈̏                       *
+* p			: f[^                           *
+***************************************************/
+static void ChangeDrawWindowPixelsUndo(DRAW_WINDOW* window, void* p)
+{
+	// f[^
+	CHANGE_DRAW_WINDOW_PIXELS_HISTORY history_data;
+	LAYER_PIXELS_HISTORY_DATA layer_data;
+	// f[^oCgPʂɃLXg
+	uint8 *byte_data = (uint8*)p;
+	// sNZf[^߂C[
+	LAYER *layer;
+	// ݂̃ANeBuC[̖O
+	char active_name[MAX_LAYER_NAME_LENGTH];
+	// C[1̃sNZf[^̃oCg
+	size_t pixels_size;
+	int i;
+
+	(void)memcpy(&history_data, byte_data, sizeof(history_data));
+	byte_data += sizeof(history_data);
+
+	(void)strcpy(active_name, window->active_layer->name);
+
+	// C[ȊÕobt@ύXÕTCYɖ߂
+	ResizeDrawWindowBuffers(window, history_data.before_width, history_data.before_height);
+	// I͈͍͂蒼Ȃ̂ŉ
+	(void)memset(window->selection->pixels, 0, window->width * window->height);
+	window->flags &= ~(DRAW_WINDOW_HAS_SELECTION_AREA);
+
+	// eC[̃sNZf[^߂
+		// (kĂȂ΂̂܂܃Rs[)
+	for(i=0; i<history_data.num_layer; i++)
+	{
+		(void)memcpy(&layer_data, byte_data, offsetof(LAYER_PIXELS_HISTORY_DATA, name));
+		byte_data += offsetof(LAYER_PIXELS_HISTORY_DATA, name);
+		layer_data.name = (gchar*)byte_data;
+		byte_data += layer_data.name_length;
+		pixels_size = (size_t)layer_data.stride * layer_data.height;
+
+		layer = SearchLayerByIDAndName(window, layer_data.layer_id, layer_data.name);
+		if(layer != NULL)
+		{
+			ResizeLayerBuffer(layer, layer_data.width, layer_data.height);
+			if(layer_data.compressed_size != 0)
+			{
+				(void)InflateData(byte_data, layer->pixels,
+					layer_data.compressed_size, pixels_size, NULL);
+			}
+			else
+			{
+				(void)memcpy(layer->pixels, byte_data, pixels_size);
+			}
+		}
+		byte_data += (layer_data.compressed_size != 0) ? layer_data.compressed_size : pixels_size;
+	}
+
+	// \p̃C[TCY
+	DrawWindowChangeZoom(window, window->zoom);
+
+	// ANeBuC[ɖ߂
+	ChangeActiveLayer(window, SearchLayer(window->layer, active_name));
+
+	// C[
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
+	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
+}
+
+/*******************************************************
+* AddChangeDrawWindowPixelsHistory֐                 *
+* 𑜓xELoXTCYύX̗                 *
+* C[̃sNZf[^ō쐬                 *
+* (sNZf[^ł͖߂ȂC[Ύs) *
+*                                                  *
+* window		: TCYύX`̈             *
+* new_width		: V                             *
+* new_height	: V                           *
+* name			: ̖O                           *
+* redo			: 蒼̊֐                       *
+* Ԃl                                               *
+*	I:0	s:̒l                            *
+*******************************************************/
+static int AddChangeDrawWindowPixelsHistory(
+	DRAW_WINDOW* window,
+	int32 new_width,
+	int32 new_height,
+	const gchar* name,
+	history_func redo
+)
+{
+	// f[^
+	CHANGE_DRAW_WINDOW_PIXELS_HISTORY history_data;
+	LAYER_PIXELS_HISTORY_DATA layer_data;
+	// ɓnobt@
+	uint8 *buffer;
+	uint8 *next_buffer;
+	// sNZf[^ۑ郌C[
+	LAYER *layer;
+	// f[^̃oCg
+	size_t data_size;
+	// ݈ʒu
+	size_t data_point;
+	// C[1̃sNZf[^̃oCg
+	size_t pixels_size;
+	// k̃oCĝɕKvȃobt@̃TCY
+	size_t buffer_size;
+	// C[ɈkȂTRUE
+	int compress_pixels;
+
+	// xNgeLXg̓sNZf[^ȊOς̂őŜۑ
+	data_size = sizeof(history_data);
+	history_data.num_layer = 0;
+	for(layer = window->layer; layer != NULL; layer = layer->next)
+	{
+		history_data.num_layer++;
+		if(layer->layer_type != TYPE_NORMAL_LAYER && layer->layer_type != TYPE_LAYER_SET)
+		{
+			return -1;
+		}
+		data_size += offsetof(LAYER_PIXELS_HISTORY_DATA, name)
+			+ strlen(layer->name) + 1 + (size_t)layer->stride * layer->height;
+	}
+
+	history_data.new_width = new_width;
+	history_data.new_height = new_height;
+	history_data.before_width = window->width;
+	history_data.before_height = window->height;
+
+	// ʏ̓sNZf[^kɂ̂܂܏o
+		// (Â͗𑤂ŕʃXbhňk)
+	// ̃gpʂ̏𒴂A܂͗𑤂ňkłȂ傫Ȃ
+		// o_ŃC[Ɉk
+	compress_pixels = (window->history.memory_limit != 0 && data_size > window->history.memory_limit)
+		|| data_size > HISTORY_COMPRESS_MAX_SIZE;
+	if(compress_pixels != FALSE)
+	{
+		data_size = sizeof(history_data);
+	}
+
+	// ɂ̓obt@Rs[ɓn̂łŒڏ
+	buffer = (uint8*)MEM_ALLOC_FUNC(data_size);
+	if(buffer == NULL)
+	{
+		return -1;
+	}
+	(void)memcpy(buffer, &history_data, sizeof(history_data));
+	data_point = sizeof(history_data);
+
+	for(layer = window->layer; layer != NULL; layer = layer->next)
+	{
+		pixels_size = (size_t)layer->stride * layer->height;
+		layer_data.layer_id = layer->id;
+		layer_data.width = layer->width;
+		layer_data.height = layer->height;
+		layer_data.stride = layer->stride;
+		layer_data.compressed_size = 0;
+		layer_data.name_length = (uint16)strlen(layer->name) + 1;
+
+		if(compress_pixels != FALSE)
+		{	// ̃C[̈kʂ镪obt@L
+			buffer_size = (pixels_size <= HISTORY_COMPRESS_MAX_SIZE)
+				? (size_t)compressBound((uLong)pixels_size) : pixels_size;
+			next_buffer = (uint8*)MEM_REALLOC_FUNC(buffer, data_point
+				+ offsetof(LAYER_PIXELS_HISTORY_DATA, name) + layer_data.name_length + buffer_size);
+			if(next_buffer == NULL)
+			{
+				MEM_FREE_FUNC(buffer);
+				return -1;
+			}
+			buffer = next_buffer;
+
+			// ȂȂΈkɏo
+			if(pixels_size > HISTORY_COMPRESS_MAX_SIZE
+				|| DeflateData(layer->pixels, &buffer[data_point + offsetof(LAYER_PIXELS_HISTORY_DATA, name)
+					+ layer_data.name_length], pixels_size, buffer_size,
+						&layer_data.compressed_size, Z_BEST_SPEED) != 0
+				|| layer_data.compressed_size >= pixels_size)
+			{
+				layer_data.compressed_size = 0;
+			}
+		}
+
+		(void)memcpy(&buffer[data_point], &layer_data, offsetof(LAYER_PIXELS_HISTORY_DATA, name));
+		data_point += offsetof(LAYER_PIXELS_HISTORY_DATA, name);
+		(void)memcpy(&buffer[data_point], layer->name, layer_data.name_length);
+		data_point += layer_data.name_length;
+		if(layer_data.compressed_size != 0)
+		{
+			data_point += layer_data.compressed_size;
+		}
+		else
+		{
+			(void)memcpy(&buffer[data_point], layer->pixels, pixels_size);
+			data_point += pixels_size;
+		}
+	}
+
+	// kꍇ͗]؂l߂
+	if(compress_pixels != FALSE)
+	{
+		next_buffer = (uint8*)MEM_REALLOC_FUNC(buffer, data_point);
+		if(next_buffer != NULL)
+		{
+			buffer = next_buffer;
+		}
+	}
+
+	AddHistoryBuffer(&window->history, name, buffer, data_point,
+		ChangeDrawWindowPixelsUndo, redo);
+
+	return 0;
+}
+
 /*************************************************
 * AddChangeDrawWindowResolutionHistory֐       *
 * 𑜓xύX̗f[^ǉ               *
@@ -1740,6 +2103,13 @@ void AddChangeDrawWindowResolutionHistory(
 	// Xg[̃TCY
 	size_t stream_size;
 
+	// \Ȃ烌C[̃sNZf[^ŗ쐬
+	if(AddChangeDrawWindowPixelsHistory(window, new_width, new_height,
+		window->app->labels->menu.change_resolution, ChangeDrawWindowResolutionRedo) == 0)
+	{
+		return;
+	}
+
 	// C[̐*sNZf[^ + 8kmۂĂ
 	stream_size = 8192 +
 		window->num_layer * window->width * window->height * window->channel;
@@ -1789,37 +2159,8 @@ void ChangeDrawWindowResolution(DRAW_WINDOW* window, int32 new_width, int32 new_
 	// ݂̃ANeBuC[̖OL
 	(void)strcpy(active_name, window->active_layer->name);
 
-	// wĩsNZf[^XV
-	window->back_ground = (uint8*)MEM_REALLOC_FUNC(
-		window->back_ground, new_width*new_height*window->channel);
-	(void)memset(window->back_ground, 0xff, new_width*new_height*window->channel);
-
-	// ƃC[AꎞۑC[̃TCYύX
-	DeleteLayer(&window->temp_layer);
-	window->temp_layer = CreateLayer(0, 0, new_width, new_height, 5,
-		TYPE_NORMAL_LAYER, NULL, NULL, NULL, window);
-	ResizeLayerBuffer(window->mask, new_width, new_height);
-	ResizeLayerBuffer(window->mask_temp, new_width, new_height);
-	ResizeLayerBuffer(window->work_layer, new_width, new_height);
-	ResizeLayerBuffer(window->mixed_layer, new_width, new_height);
-	ResizeLayerBuffer(window->under_active, new_width, new_height);
-	ResizeLayerBuffer(window->selection, new_width, new_height);
-	ResizeLayerBuffer(window->texture, new_width, new_height);
-
-	// Vƍ`̈̏ɃZbg
-	window->width = new_width, window->height = new_height;
-	// sNZf[^̃oCgA1s̃oCgvZ
-	window->stride = new_width * window->channel;
-	window->pixel_buf_size = window->stride * new_height;
-
-	// ʂɑ΂ĊgEkݒ肷邽߂̃p^[쐬
-	window->mixed_pattern = cairo_pattern_create_for_surface(window->mixed_layer->surface_p);
-	cairo_pattern_set_filter(window->mixed_pattern, CAIRO_FILTER_FAST);
-
-	// irQ[V̕\ݒ
-	ChangeNavigationDrawWindow(&window->app->navigation_window, window);
-	// eNX`p̃C[XV
-	FillTextureLayer(window->texture, &window->app->textures);
+	// C[ȊÕobt@̃TCYύX
+	ResizeDrawWindowBuffers(window, new_width, new_height);
 
 	// SẴC[TCY
 	while(layer != NULL)
@@ -1836,6 +2177,8 @@ _CrtCheckMemory();
 	ChangeActiveLayer(window, SearchLayer(window->layer, active_name));
 
 	// C[
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 }
 
@@ -1866,7 +2209,7 @@ static void ChangeDrawWindowSizeRedo(DRAW_WINDOW* window, void* p)
 		offsetof(CHANGE_DRAW_WINDOW_RESOLUTION_HISTORY, before_data_size));
 
 	// LoXTCY̕ύXs
-	ChangeDrawWindowResolution(window,
+	ChangeDrawWindowSize(window,
 		history_data.new_width, history_data.new_height);
 }
 
@@ -1894,6 +2237,13 @@ void AddChangeDrawWindowSizeHistory(
 	// Xg[̃TCY
 	size_t stream_size;
 
+	// \Ȃ烌C[̃sNZf[^ŗ쐬
+	if(AddChangeDrawWindowPixelsHistory(window, new_width, new_height,
+		window->app->labels->menu.change_canvas_size, ChangeDrawWindowSizeRedo) == 0)
+	{
+		return;
+	}
+
 	// C[̐*sNZf[^ + 8kmۂĂ
 	stream_size = 8192 +
 		window->num_layer * window->width * window->height * window->channel;
@@ -1940,36 +2290,8 @@ void ChangeDrawWindowSize(DRAW_WINDOW* window, int32 new_width, int32 new_height
 	// ݂̃ANeBuC[̖OL
 	(void)strcpy(active_name, window->active_layer->name);
 
-	// wĩsNZf[^XV
-	window->back_ground = (uint8*)MEM_REALLOC_FUNC(
-		window->back_ground, new_width*new_height*window->channel);
-	(void)memset(window->back_ground, 0xff, new_width*new_height*window->channel);
-
-	// ƃC[AꎞۑC[̃TCYύX
-	DeleteLayer(&window->temp_layer);
-	window->temp_layer = CreateLayer(0, 0, new_width, new_height, 5,
-		TYPE_NORMAL_LAYER, NULL, NULL, NULL, window);
-	ResizeLayerBuffer(window->mask, new_width, new_height);
-	ResizeLayerBuffer(window->mask_temp, new_width, new_height);
-	ResizeLayerBuffer(window->work_layer, new_width, new_height);
-	ResizeLayerBuffer(window->mixed_layer, new_width, new_height);
-	ResizeLayerBuffer(window->under_active, new_width, new_height);
-	ResizeLayerBuffer(window->selection, new_width, new_height);
-
-	// Vƍ`̈̏ɃZbg
-	window->width = new_width, window->height = new_height;
-	// sNZf[^̃oCgA1s̃oCgvZ
-	window->stride = new_width * window->channel;
-	window->pixel_buf_size = window->stride * new_height;
-
-	// ʂɑ΂ĊgEkݒ肷邽߂̃p^[쐬
-	window->mixed_pattern = cairo_pattern_create_for_surface(window->mixed_layer->surface_p);
-	cairo_pattern_set_filter(window->mixed_pattern, CAIRO_FILTER_FAST);
-
-	// irQ[V̕\ݒ
-	ChangeNavigationDrawWindow(&window->app->navigation_window, window);
-	// eNX`p̃C[XV
-	FillTextureLayer(window->texture, &window->app->textures);
+	// C[ȊÕobt@̃TCYύX
+	ResizeDrawWindowBuffers(window, new_width, new_height);
 
 	// SẴC[TCY
 	while(layer != NULL)
@@ -1986,6 +2308,8 @@ void ChangeDrawWindowSize(DRAW_WINDOW* window, int32 new_width, int32 new_height
 	ChangeActiveLayer(window, SearchLayer(window->layer, active_name));
 
 	// C[
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 }
 
@@ -10,6 +10,8 @@
 #include "selection_area.h"
 #include "memory_stream.h"
 #include "types.h"
+#include "display_filter.h"
+#include "ght_hash_table.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,7 +33,11 @@ typedef enum _eDRAW_WINDOW_FLAGS
 	DRAW_WINDOW_INITIALIZED = 0x800,
 	DRAW_WINDOW_DISCONNECT_3D = 0x1000,
 	DRAW_WINDOW_UPDATE_AREA_INITIALIZED = 0x2000,
-	DRAW_WINDOW_IN_RASTERIZING_VECTOR_SCRIPT = 0x4000
+	DRAW_WINDOW_IN_RASTERIZING_VECTOR_SCRIPT = 0x4000,
+	DRAW_WINDOW_ABOVE_ACTIVE_CACHED = 0x8000,
+	DRAW_WINDOW_MASK_SOURCE_CACHED = 0x10000,
+	DRAW_WINDOW_TRACK_WORK_TILES = 0x20000,
+	DRAW_WINDOW_MASK_SOURCE_UPDATED = 0x40000
 } eDRAW_WINDOW_FLAGS;
 
 typedef struct _UPDATE_RECTANGLE
@@ -40,8 +46,65 @@ typedef struct _UPDATE_RECTANGLE
 	FLOAT_T width, height;
 	cairo_t *cairo_p;
 	cairo_surface_t *surface_p;
+	LAYER *target;			// XV͈͂C[(NULLȂcairoō)
 } UPDATE_RECTANGLE;
 
+// ʍXVp^C̈ӂ̃sNZ
+#define UPDATE_TILE_SIZE 64
+
+// k\pɍʂ1/2k摜̍ői
+#define MAX_MIXED_PYRAMID_LEVEL 4
+
+/*************************************
+* UPDATE_TILES\                 *
+* ʍXV͈͂^CPʂŊǗ *
+*************************************/
+typedef struct _UPDATE_TILES
+{
+	// Ac̃^C̐
+	int num_x, num_y;
+	// ^C̍XVtO
+	uint8 *dirty;
+	// XVtO̗Ă^C͈̔(^CP)
+	int min_x, min_y, max_x, max_y;
+	// XVtO̗Ă^C̐
+	int num_dirty;
+} UPDATE_TILES;
+
+// Xg[N҂̓͂𗭂߂Ă
+#define STROKE_QUEUE_SIZE 1024
+
+/******************************
+* STROKE_SAMPLE\         *
+* uV̏҂̓1 *
+******************************/
+typedef struct _STROKE_SAMPLE
+{
+	// ͂uV
+	struct _BRUSH_CORE *core;
+	// LoX̍WƕM
+	gdouble x, y, pressure;
+	// ͎̃{^ACL[̏
+	GdkModifierType state;
+	// ͂ꂽ(~b)
+	guint32 time;
+} STROKE_SAMPLE;
+
+/*****************************************************
+* STROKE_QUEUE\                                 *
+* }EẌړCxg𗭂߂ĂAʍXV̑O   *
+* ܂Ƃ߂ăuVɏ邽߂̃L[             *
+* (ǂCXbhŏ̂ŃbN͕sv) *
+*****************************************************/
+typedef struct _STROKE_QUEUE
+{
+	STROKE_SAMPLE samples[STROKE_QUEUE_SIZE];
+	// ɏވʒuƎɓǂݏoʒu
+	int head, tail;
+	// ܂͂AChID
+	guint dispatch_id;
+} STROKE_QUEUE;
+
 typedef struct _CALLBACK_IDS
 {
 	unsigned int display;
@@ -96,6 +159,8 @@ typedef struct _DRAW_WINDOW
 	FLOAT_T last_x, last_y;
 	// ŌɃNbN܂̓hbOꂽ̕M
 	FLOAT_T last_pressure;
+	// Ōɏ}EXCxg̎(͗̎擾p)
+	guint32 last_motion_time;
 	// J[\W␳p
 	FLOAT_T add_cursor_x, add_cursor_y;
 	// ϖ@u␳ł̍Wϊp
@@ -104,6 +169,20 @@ typedef struct _DRAW_WINDOW
 	cairo_pattern_t *rotate;
 	// ʕXVp
 	UPDATE_RECTANGLE update, temp_update;
+	// XV̑ΏۂƂȂ^C
+	UPDATE_TILES update_tiles;
+	// \͈͊Oō񂵂ɂĂ^C
+	UPDATE_TILES stale_tiles;
+	// ƃC[ɕ`悵^C
+	UPDATE_TILES work_tiles;
+	// 񂵂ɂ^CAChID
+	guint stale_idle_id;
+	// uV̏҂̓
+	STROKE_QUEUE stroke_queue;
+	// uV̓͂̋L^(L^ĂȂNULL)
+	struct _STROKE_RECORD *stroke_record;
+	// uVɓnĂhbO͂̎(L^p)
+	guint32 motion_time;
 	// `̈XN[̍W
 	int scroll_x, scroll_y;
 	// ʍXṼNbsOp
@@ -121,14 +200,22 @@ typedef struct _DRAW_WINDOW
 	LAYER* layer;			// ԉ̃C[
 	// \pAGtFNgpAuVJ[\\p̈ꎞۑ
 	LAYER* disp_layer, *effect, *disp_temp, *scaled_mixed;
+	// k\pɍʂ1/2k摜
+	LAYER *mixed_pyramid[MAX_MIXED_PYRAMID_LEVEL];
 	// ANeBuȃC[&C[Zbgւ̃|C^
 		// yѕ\C[C[
 	LAYER* active_layer, *active_layer_set, *mixed_layer;
 	// ƗpAꎞۑpAÍ͈AANeBuC[艺̃C[
+		// yуANeBuC[̃C[̍
 	LAYER *work_layer, *temp_layer,
-		*selection, *under_active;
+		*selection, *under_active, *above_active;
+	// ANeBuC[̍ʂ쐬̃C[̏
+	unsigned int above_active_state;
 	// }XNƃ}XNKpÖꎞۑp
 	LAYER* mask, *mask_temp;
+	// NbsOp̃ANeBuC[ƍƃC[̍
+		// yт̍̃C[
+	LAYER *mask_source, *mask_source_layer;
 	// eNX`p
 	LAYER* texture;
 	// \pp^[
@@ -142,6 +229,13 @@ typedef struct _DRAW_WINDOW
 	void (**layer_blend_functions)(LAYER* src, LAYER* dst);
 	void (**part_layer_blend_functions)(LAYER* src, UPDATE_RECTANGLE* update);
 
+	// ID烌C[TnbVe[u
+	ght_hash_table_t *layer_table;
+	// ŌɊ蓖ĂC[ID
+	uint32 last_layer_id;
+	// ŌɊ蓖ĂsNZf[^̍XVԍ
+	unsigned int last_content_generation;
+
 	uint16 num_layer;		// C[̐
 	uint16 zoom;			// gEk
 	FLOAT_T zoom_rate;		// _^̊gEk
@@ -188,6 +282,8 @@ typedef struct _DRAW_WINDOW
 	cmsHPROFILE input_icc;
 	// ICCvt@CɂFϊp
 	cmsHTRANSFORM icc_transform;
+	// ICCvt@CKp̕ϊe[u
+	ICC_DISPLAY_LUT icc_lut;
 
 	// ǏLoX
 	struct _DRAW_WINDOW *focal_window;
@@ -730,6 +826,14 @@ EXTERN void MixLayerSet(LAYER* bottom, LAYER** next, DRAW_WINDOW* window);
 ***************************************************************/
 EXTERN void MixLayerSetActiveOver(LAYER* start, LAYER** next, DRAW_WINDOW* window);
 
+/*******************************************************
+* ClearLayerSetCache֐                               *
+* SẴC[Zbg̍ʂ̃LbVj *
+*                                                  *
+* window	: `̈Ǘ\̂̃AhX       *
+*******************************************************/
+EXTERN void ClearLayerSetCache(DRAW_WINDOW* window);
+
 EXTERN void RenderTextLayer(DRAW_WINDOW* window, struct _LAYER* target, TEXT_LAYER* layer);
 
 EXTERN void DisplayTextLayerRange(DRAW_WINDOW* window, TEXT_LAYER* layer);
@@ -59,6 +59,8 @@ static void FilterHistoryUndo(DRAW_WINDOW* window, void* p)
 	int32 width, height, stride;
 	// C[
 	char layer_name[4096];
+	// C[ID
+	uint32 layer_id;
 	// sNZf[^
 	uint8* pixels;
 	// forp̃JE^
@@ -91,8 +93,10 @@ static void FilterHistoryUndo(DRAW_WINDOW* window, void* p)
 		(void)MemRead(&layer_name_length, sizeof(layer_name_length), 1, &stream);
 		// C[ǂݍ
 		(void)MemRead(layer_name, 1, layer_name_length, &stream);
+		// C[IDǂݍ
+		(void)MemRead(&layer_id, sizeof(layer_id), 1, &stream);
 		// C[T
-		layer = SearchLayer(window->layer, layer_name);
+		layer = SearchLayerByIDAndName(window, layer_id, layer_name);
 		// PNG̃oCgǂݍ
 		(void)MemRead(&next_data_pos, sizeof(next_data_pos), 1, &stream);
 		next_data_pos += stream.data_point;
@@ -135,6 +139,8 @@ static void FilterHistoryRedo(DRAW_WINDOW* window, void* p)
 	size_t filter_data_pos;
 	// C[
 	char layer_name[4096];
+	// C[ID
+	uint32 layer_id;
 	// C[̒
 	uint16 layer_name_length;
 	// forp̃JE^
@@ -169,8 +175,10 @@ static void FilterHistoryRedo(DRAW_WINDOW* window, void* p)
 		(void)MemRead(&layer_name_length, sizeof(layer_name_length), 1, &stream);
 		// C[ǂݍ
 		(void)MemRead(layer_name, 1, layer_name_length, &stream);
+		// C[IDǂݍ
+		(void)MemRead(&layer_id, sizeof(layer_id), 1, &stream);
 		// C[T
-		layers[i] = SearchLayer(window->layer, layer_name);
+		layers[i] = SearchLayerByIDAndName(window, layer_id, layer_name);
 		// PNGf[^ǂݔ΂
 		(void)MemRead(&data_size, sizeof(data_size), 1, &stream);
 		(void)MemSeek(&stream, (long)data_size, SEEK_CUR);
@@ -185,6 +193,23 @@ static void FilterHistoryRedo(DRAW_WINDOW* window, void* p)
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 }
 
+/*************************************************
+* UpdateFilterLayersGeneration֐               *
+* tB^[ŕύX郌C[̍XVԍi߂ *
+*                                            *
+* layers	: tB^[Kp郌C[̔z *
+* num_layer	: tB^[Kp郌C[̐   *
+*************************************************/
+static void UpdateFilterLayersGeneration(LAYER** layers, uint16 num_layer)
+{
+	unsigned int i;
+
+	for(i=0; i<num_layer; i++)
+	{
+		UpdateLayerContentGeneration(layers[i]);
+	}
+}
+
 /*******************************************************************
 * AddFilterHistory֐                                             *
 * tB^[KpO̗쐬                                   *
@@ -222,6 +247,9 @@ void AddFilterHistory(
 	// forp̃JE^
 	unsigned int i;
 
+	// ̌tB^[ŃsNZf[^ύX
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	// 擪ɑoCgނ4oCg
 	(void)MemSeek(stream, sizeof(size_t), SEEK_SET);
 
@@ -247,6 +275,9 @@ void AddFilterHistory(
 		// Oo
 		(void)MemWrite(layers[i]->name, 1, name_length, stream);
 
+		// IDo
+		(void)MemWrite(&layers[i]->id, sizeof(layers[i]->id), 1, stream);
+
 		// PNGf[^̃oCgLXy[XJ
 		before_pos = stream->data_point;
 		(void)MemSeek(stream, sizeof(before_pos), SEEK_CUR);
@@ -581,6 +612,9 @@ void BlurFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, void* dat
 	// forp̃JE^
 	unsigned int i, j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	// eC[ɑ΂
 	for(i=0; i<num_layer; i++)
 	{	// ڂs
@@ -823,6 +857,9 @@ void MotionBlurFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, voi
 	unsigned int sum_color[4];
 	int i, j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer; i++)
 	{
 		switch(filter_data->type)
@@ -2459,7 +2496,7 @@ void ExecuteMotionBlurFilter(APPLICATION* app)
 		{
 			(void)memcpy(layers[i]->pixels, filter_data.before_pixels[i],
 				layers[i]->width * layers[i]->height * layers[i]->channel);
-		}
+		}		UpdateFilterLayersGeneration(layers, num_layers);
 	}
 
 	gtk_widget_destroy(dialog);
@@ -2586,6 +2623,9 @@ void GaussianBlurFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, v
 	// forp̃JE^
 	unsigned int i, j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	// tB^[f[^pXJ̎Op`𗘗pč쐬
 	kernel = (int**)MEM_ALLOC_FUNC(sizeof(*kernel)*blur->size);
 	for(i=0; i<blur->size; i++)
@@ -2893,6 +2933,9 @@ void ChangeBrightContrastFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_
 	uint8 contrast_r[UCHAR_MAX+1], contrast_g[UCHAR_MAX+1], contrast_b[UCHAR_MAX+1];
 	int i, j;	// forp̃JE^
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	// eC[ɑ΂邳ERgXg̕ύXs
 	for(i=0; i<num_layer; i++)
 	{
@@ -3234,7 +3277,7 @@ void ExecuteChangeBrightContrastFilter(APPLICATION* app)
 		{
 			(void)memcpy(layers[i]->pixels, pixel_data[i],
 				layers[i]->width * layers[i]->height * layers[i]->channel);
-		}
+		}		UpdateFilterLayersGeneration(layers, num_layer);
 	}
 
 	// LoXXV
@@ -3285,6 +3328,9 @@ void ChangeHueSaturationFilter(
 	// forp̃JE^
 	int i, j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	// eC[ɑ΂FEʓxEPx̕ύXs
 	for(i=0; i<(int)num_layer; i++)
 	{
@@ -3627,7 +3673,7 @@ void ExecuteChangeHueSaturationFilter(APPLICATION* app)
 		{
 			(void)memcpy(layers[i]->pixels, pixel_data[i],
 				layers[i]->width * layers[i]->height * layers[i]->channel);
-		}
+		}		UpdateFilterLayersGeneration(layers, num_layer);
 	}
 
 	// LoXXV
@@ -4288,6 +4334,7 @@ static void UpdateColorLevelAdjust(EXECUTE_COLOR_LEVLE_ADJUST* adjust_data)
 			AdoptColorLevelAdjust(adjust_data->layers[i], &adjust_data->histgrams[i], adjust_data->filter_data);
 		}
 	}
+	UpdateFilterLayersGeneration(adjust_data->layers, adjust_data->num_layer);
 
 	if(adjust_data->layers[0] == adjust_data->layers[0]->window->active_layer)
 	{
@@ -4658,6 +4705,7 @@ void ExecuteColorLevelAdjust(APPLICATION* app)
 			(void)memcpy(adjust_data.layers[i]->pixels,
 				adjust_data.pixel_data[i], adjust_data.layers[i]->stride * adjust_data.layers[i]->height);
 		}
+		UpdateFilterLayersGeneration(adjust_data.layers, adjust_data.num_layer);
 		if(adjust_data.layers[0] == canvas->active_layer)
 		{
 			canvas->flags |= DRAW_WINDOW_UPDATE_ACTIVE_OVER;
@@ -4695,6 +4743,9 @@ void ColorLevelAdjustFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_laye
 	COLOR_HISTGRAM histgram;
 	unsigned int i;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer; i++)
 	{
 		if(layers[i]->layer_type == TYPE_NORMAL_LAYER)
@@ -5504,6 +5555,7 @@ static void UpdateToneCurve(EXECUTE_TONE_CURVE* tone_curve)
 			AdoptToneCurveFilter(tone_curve->layers[i], tone_curve->histgram, tone_curve->filter_data);
 		}
 	}
+	UpdateFilterLayersGeneration(tone_curve->layers, tone_curve->num_layer);
 
 	if(tone_curve->layers[0] == tone_curve->layers[0]->window->active_layer)
 	{
@@ -5978,6 +6030,7 @@ void ExecuteToneCurve(APPLICATION* app)
 			(void)memcpy(tone_curve.layers[i]->pixels,
 				tone_curve.pixel_data[i], tone_curve.layers[i]->stride * tone_curve.layers[i]->height);
 		}
+		UpdateFilterLayersGeneration(tone_curve.layers, tone_curve.num_layer);
 		if(tone_curve.layers[0] == canvas->active_layer)
 		{
 			canvas->flags |= DRAW_WINDOW_UPDATE_ACTIVE_OVER;
@@ -6014,6 +6067,9 @@ void ToneCurveFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, void
 	COLOR_HISTGRAM histgram;
 	unsigned int i;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer; i++)
 	{
 		if(layers[i]->layer_type == TYPE_NORMAL_LAYER)
@@ -6047,6 +6103,9 @@ void Luminosity2OpacityFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_la
 	unsigned int i;
 	int j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer; i++)
 	{
 		(void)memset(window->temp_layer->pixels, 0, window->pixel_buf_size);
@@ -6149,6 +6208,9 @@ static void Color2AlphaFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_la
 	unsigned int i;
 	int j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	(void)memcpy(color, setting->color, sizeof(color));
 #if defined(USE_BGR_COLOR_SPACE) && USE_BGR_COLOR_SPACE != 0
 	{
@@ -6296,10 +6358,14 @@ void ColorizeWithUnderFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_lay
 {
 	COLORIZE_WITH_UNDER *adjust = (COLORIZE_WITH_UNDER*)data;
 	LAYER *target;
+	LAYER_SUM_TABLE *sum_table;
 	int delete_target = 0;
 	const int width = (*layers)->width;
 	int y;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	cairo_set_operator(window->temp_layer->cairo_p, CAIRO_OPERATOR_OVER);
 
 	if(adjust->color_from == COLORIZE_WITH_UNDER_LAYER)
@@ -6337,8 +6403,12 @@ void ColorizeWithUnderFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_lay
 		delete_target++;
 	}
 
+	// ϐF̎擾͈͂̑傫Ɋւ炸莞ԂōsߗݐϘavZĂ
+	// (Ȃ1sNZςvZ)
+	sum_table = CreateLayerSumTable(target);
+
 #ifdef _OPENMP
-#pragma omp parallel for firstprivate(width, layers)
+#pragma omp parallel for firstprivate(width, layers, sum_table)
 #endif
 	for(y=0; y<(*layers)->height; y++)
 	{
@@ -6351,7 +6421,14 @@ void ColorizeWithUnderFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_lay
 		{
 			if((*layers)->pixels[y*(*layers)->stride+x*4+3] > 0)
 			{
-				GetAverageColor(target, x, y, adjust->size, src_color);
+				if(sum_table != NULL)
+				{
+					GetAverageColorWithSumTable(sum_table, x, y, adjust->size, src_color);
+				}
+				else
+				{
+					GetAverageColor(target, x, y, adjust->size, src_color);
+				}
 				if(src_color[3] > 0)
 				{
 					RGB2HSV_Pixel(src_color, &hsv);
@@ -6418,6 +6495,8 @@ void ColorizeWithUnderFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_lay
 		}
 	}
 
+	DeleteLayerSumTable(&sum_table);
+
 	if((window->flags & DRAW_WINDOW_HAS_SELECTION_AREA) != 0)
 	{
 		uint8 select_value;
@@ -6598,6 +6677,9 @@ void GradationMapFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, v
 	int max_value, min_value;
 	int i, j;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer; i++)
 	{
 		if((filter_data->flags & GRADATION_MAP_DETECT_MAX) != 0)
@@ -7101,6 +7183,9 @@ void FillWithVectorLineFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_la
 	int num_lines = 0;
 	int i;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	for(i=0; i<num_layer-1; i++)
 	{
 		line = ((VECTOR_LINE*)(layers[i]->layer_data.vector_layer_p->base))->base_data.next;
@@ -7692,6 +7777,9 @@ void PerlinNoiseFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, vo
 	uint8 *pixels;
 	int i;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	pixels = (uint8*)MEM_ALLOC_FUNC(filter_data->width * filter_data->height * 4);
 	surface_p = cairo_image_surface_create_for_data(pixels, CAIRO_FORMAT_ARGB32,
 		filter_data->width, filter_data->height, filter_data->width * 4);
@@ -8189,6 +8277,9 @@ void FractalFilter(DRAW_WINDOW* window, LAYER** layers, uint16 num_layer, void*
 	// tB^[Kp郌C[
 	int i;
 
+	// sNZf[^̕ύXL^
+	UpdateFilterLayersGeneration(layers, num_layer);
+
 	(void)MemRead(&data_size, sizeof(data_size), 1, &stream);
 	stream.data_size = data_size;
 
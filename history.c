@@ -5,13 +5,544 @@
 #endif
 
 #include <string.h>
+#include <zlib.h>
+#include <glib/gstdio.h>
+#ifdef _MSC_VER
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
 #include "memory.h"
 #include "application.h"
+#include "utils.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// kȂȗf[^̃oCg
+#define HISTORY_COMPRESS_MIN_SIZE 4096
+
+// 2GB𒴂ꎞt@Cłoʒuwł悤ɂ
+#ifdef _MSC_VER
+# define HISTORY_FSEEK _fseeki64
+# define HISTORY_FDOPEN _fdopen
+#else
+# define HISTORY_FSEEK fseeko
+# define HISTORY_FDOPEN fdopen
+#endif
+// ̎gȂȂ̈ꎞt@C؂l߂
+#ifdef _MSC_VER
+# define HISTORY_FTRUNCATE(FP, SIZE) _chsize_s(_fileno(FP), (SIZE))
+#else
+# define HISTORY_FTRUNCATE(FP, SIZE) ftruncate(fileno(FP), (off_t)(SIZE))
+#endif
+
+static gboolean CompressHistoryIdle(HISTORY* history);
+static void FreeHistorySpillExtent(HISTORY* history, gint64 offset, gint64 size);
+
+// ʃXbhŗf[^kA܂͈ꎞt@C֏o
+static gpointer CompressHistoryThread(HISTORY* history)
+{
+	HISTORY_COMPRESS *compress = &history->compress;
+	size_t buffer_size;
+
+	if(compress->spill != FALSE)
+	{	// ooCgŐۂ𔻒肷
+		compress->result_size = 0;
+		if(HISTORY_FSEEK(history->spill_file, compress->spill_offset, SEEK_SET) == 0)
+		{
+			compress->result_size = fwrite(compress->source, 1, compress->source_size, history->spill_file);
+			if(fflush(history->spill_file) != 0)
+			{
+				compress->result_size = 0;
+			}
+		}
+
+		compress->idle_id = g_idle_add((GSourceFunc)CompressHistoryIdle, history);
+
+		return NULL;
+	}
+
+	buffer_size = (size_t)compressBound((uLong)compress->source_size);
+	compress->result = (uint8*)MEM_ALLOC_FUNC(buffer_size);
+	if(compress->result != NULL)
+	{	// kłȂA܂͏ȂȂΌ̃f[^̂܂܎c
+		if(DeflateData(compress->source, compress->result, compress->source_size,
+			buffer_size, &compress->result_size, Z_BEST_SPEED) != 0
+				|| compress->result_size >= compress->source_size)
+		{
+			MEM_FREE_FUNC(compress->result);
+			compress->result = NULL;
+		}
+		else
+		{
+			compress->result = (uint8*)MEM_REALLOC_FUNC(compress->result, compress->result_size);
+		}
+	}
+
+	// kʂ̔f̓CXbhōs
+	compress->idle_id = g_idle_add((GSourceFunc)CompressHistoryIdle, history);
+
+	return NULL;
+}
+
+// k̃Xbh̏I҂Čʂ𗚗f[^ɔf
+static void FinishHistoryCompression(HISTORY* history, int in_idle)
+{
+	HISTORY_COMPRESS *compress = &history->compress;
+	HISTORY_DATA *data;
+
+	if(compress->thread == NULL)
+	{
+		return;
+	}
+
+	(void)g_thread_join(compress->thread);
+	compress->thread = NULL;
+	if(in_idle == FALSE && compress->idle_id != 0)
+	{
+		(void)g_source_remove(compress->idle_id);
+	}
+	compress->idle_id = 0;
+
+	data = &history->history[compress->index];
+	if(compress->spill != FALSE)
+	{
+		if(compress->result_size == compress->source_size)
+		{	// ̃f[^̂ĂĈꎞt@C̈ʒuL^
+			if(data->data != NULL)
+			{
+				history->total_size -= data->data_size;
+				MEM_FREE_FUNC(data->data);
+				data->data = NULL;
+			}
+			else
+			{
+				history->total_size -= data->compressed_size;
+				MEM_FREE_FUNC(data->compressed);
+				data->compressed = NULL;
+			}
+			data->spill_offset = compress->spill_offset;
+			data->flags |= HISTORY_DATA_SPILLED;
+		}
+		else
+		{	// fBXNtȂǂŏoȂΈȍ~͑ޔȂ
+			history->spill_steps = 0;
+			FreeHistorySpillExtent(history, compress->spill_offset, (gint64)compress->source_size);
+		}
+		compress->spill = FALSE;
+	}
+	else if(compress->result != NULL)
+	{
+		MEM_FREE_FUNC(data->data);
+		data->data = NULL;
+		data->compressed = compress->result;
+		data->compressed_size = compress->result_size;
+		history->total_size -= data->data_size;
+		history->total_size += data->compressed_size;
+		compress->result = NULL;
+	}
+	else
+	{
+		data->flags |= HISTORY_DATA_INCOMPRESSIBLE;
+	}
+	compress->source = NULL;
+}
+
+// Âf[^ޔꎞt@C쐬
+static int OpenHistorySpillFile(HISTORY* history)
+{
+	gint fd;
+
+	if(history->spill_file != NULL)
+	{
+		return 0;
+	}
+
+	fd = g_file_open_tmp("kaburagi_history_XXXXXX", &history->spill_path, NULL);
+	if(fd == -1)
+	{
+		return -1;
+	}
+	history->spill_file = HISTORY_FDOPEN(fd, "w+b");
+	if(history->spill_file == NULL)
+	{
+		(void)close(fd);
+		(void)g_remove(history->spill_path);
+		g_free(history->spill_path);
+		history->spill_path = NULL;
+		return -1;
+	}
+	history->spill_size = 0;
+
+	return 0;
+}
+
+// ꎞt@Cč폜
+static void CloseHistorySpillFile(HISTORY* history)
+{
+	if(history->spill_file != NULL)
+	{
+		(void)fclose(history->spill_file);
+		history->spill_file = NULL;
+	}
+	if(history->spill_path != NULL)
+	{
+		(void)g_remove(history->spill_path);
+		g_free(history->spill_path);
+		history->spill_path = NULL;
+	}
+	history->spill_size = 0;
+	history->num_spill_free = 0;
+}
+
+// ꎞt@Cɏömۂ
+	// gȂȂ̈Ɏ܂΂ėp
+static gint64 AllocateHistorySpillExtent(HISTORY* history, gint64 size)
+{
+	HISTORY_SPILL_EXTENT *extent;
+	gint64 offset;
+	int i;
+
+	for(i=0; i<history->num_spill_free; i++)
+	{
+		extent = &history->spill_free[i];
+		if(extent->size >= size)
+		{
+			offset = extent->offset;
+			extent->offset += size;
+			extent->size -= size;
+			if(extent->size == 0)
+			{
+				(void)memmove(extent, extent+1,
+					sizeof(*extent) * (history->num_spill_free - i - 1));
+				history->num_spill_free--;
+			}
+			return offset;
+		}
+	}
+
+	offset = history->spill_size;
+	history->spill_size += size;
+
+	return offset;
+}
+
+// gȂȂꎞt@C̗̈ėpł悤ɂ
+static void FreeHistorySpillExtent(HISTORY* history, gint64 offset, gint64 size)
+{
+	HISTORY_SPILL_EXTENT *extent;
+	int i;
+
+	if(size <= 0)
+	{
+		return;
+	}
+
+	// ʒȕɕׂėׂ荇̈ƂȂ
+	for(i=0; i<history->num_spill_free; i++)
+	{
+		if(history->spill_free[i].offset > offset)
+		{
+			break;
+		}
+	}
+	if(i > 0 && history->spill_free[i-1].offset + history->spill_free[i-1].size == offset)
+	{
+		extent = &history->spill_free[i-1];
+		extent->size += size;
+		if(i < history->num_spill_free
+			&& extent->offset + extent->size == history->spill_free[i].offset)
+		{
+			extent->size += history->spill_free[i].size;
+			(void)memmove(&history->spill_free[i], &history->spill_free[i+1],
+				sizeof(*extent) * (history->num_spill_free - i - 1));
+			history->num_spill_free--;
+		}
+	}
+	else if(i < history->num_spill_free && offset + size == history->spill_free[i].offset)
+	{
+		history->spill_free[i].offset = offset;
+		history->spill_free[i].size += size;
+	}
+	else if(history->num_spill_free < (int)(sizeof(history->spill_free) / sizeof(history->spill_free[0])))
+	{
+		(void)memmove(&history->spill_free[i+1], &history->spill_free[i],
+			sizeof(history->spill_free[0]) * (history->num_spill_free - i));
+		history->spill_free[i].offset = offset;
+		history->spill_free[i].size = size;
+		history->num_spill_free++;
+	}
+	else
+	{	// L^Ȃ͍̈ėpȂ
+		return;
+	}
+
+	// t@C̖̗̈͐؂l߂
+	extent = &history->spill_free[history->num_spill_free-1];
+	if(extent->offset + extent->size == history->spill_size)
+	{
+		history->spill_size = extent->offset;
+		history->num_spill_free--;
+		// õXbh΃t@Cɂ͐GȂ
+		if(history->compress.thread == NULL && history->spill_file != NULL)
+		{
+			(void)HISTORY_FTRUNCATE(history->spill_file, history->spill_size);
+		}
+	}
+}
+
+// kĂȂÂf[^ΕʃXbhňkn߂
+	// kς݂ŐVspill_stepsÂ͈̂ꎞt@C֏o
+static void StartHistoryCompression(HISTORY* history)
+{
+	HISTORY_COMPRESS *compress = &history->compress;
+	HISTORY_DATA *data;
+	int num_cold;
+	int index;
+	int i;
+
+	if(compress->thread != NULL)
+	{
+		return;
+	}
+
+	num_cold = (history->spill_steps > 0) ? (int)history->rest_undo - history->spill_steps : 0;
+
+	// ԐV͂Ɍɖ߂\̂ňkȂ
+	for(i=0; i<(int)history->rest_undo-1; i++)
+	{
+		index = ((int)history->point + HISTORY_BUFFER_SIZE*2 - (int)history->rest_undo + i)
+			% HISTORY_BUFFER_SIZE;
+		data = &history->history[index];
+		if(data->data != NULL && (data->flags & HISTORY_DATA_INCOMPRESSIBLE) == 0
+			&& (data->data_size < HISTORY_COMPRESS_MIN_SIZE || data->data_size > HISTORY_COMPRESS_MAX_SIZE))
+		{
+			data->flags |= HISTORY_DATA_INCOMPRESSIBLE;
+		}
+
+		if(data->data != NULL && (data->flags & HISTORY_DATA_INCOMPRESSIBLE) == 0)
+		{
+			compress->spill = FALSE;
+			compress->source = (uint8*)data->data;
+			compress->source_size = data->data_size;
+		}
+		else if(i < num_cold && (data->data != NULL || data->compressed != NULL)
+			&& (data->flags & HISTORY_DATA_SPILLED) == 0)
+		{
+			if(OpenHistorySpillFile(history) != 0)
+			{
+				history->spill_steps = 0;
+				num_cold = 0;
+				continue;
+			}
+			compress->spill = TRUE;
+			if(data->data != NULL)
+			{
+				compress->source = (uint8*)data->data;
+				compress->source_size = data->data_size;
+			}
+			else
+			{
+				compress->source = (uint8*)data->compressed;
+				compress->source_size = data->compressed_size;
+			}
+			// oIOɏömۂĂ
+			compress->spill_offset = AllocateHistorySpillExtent(history, (gint64)compress->source_size);
+		}
+		else
+		{
+			continue;
+		}
+
+		compress->index = index;
+		compress->result = NULL;
+#if GLIB_CHECK_VERSION(2, 32, 0)
+		compress->thread = g_thread_try_new("history",
+			(GThreadFunc)CompressHistoryThread, history, NULL);
+#else
+		compress->thread = g_thread_create(
+			(GThreadFunc)CompressHistoryThread, history, TRUE, NULL);
+#endif
+		if(compress->thread == NULL)
+		{
+			if(compress->spill == FALSE)
+			{
+				data->flags |= HISTORY_DATA_INCOMPRESSIBLE;
+			}
+			else
+			{
+				history->spill_steps = 0;
+				compress->spill = FALSE;
+				FreeHistorySpillExtent(history, compress->spill_offset, (gint64)compress->source_size);
+			}
+			compress->source = NULL;
+		}
+		return;
+	}
+}
+
+static gboolean CompressHistoryIdle(HISTORY* history)
+{
+	FinishHistoryCompression(history, TRUE);
+	StartHistoryCompression(history);
+
+	return FALSE;
+}
+
+static void ReleaseHistoryData(HISTORY* history, int index)
+{
+	HISTORY_DATA *data = &history->history[index];
+
+	// k̃f[^Ȃ爳k̏I҂
+	if(history->compress.thread != NULL && history->compress.index == index)
+	{
+		FinishHistoryCompression(history, FALSE);
+	}
+
+	if(data->data != NULL)
+	{
+		history->total_size -= data->data_size;
+		MEM_FREE_FUNC(data->data);
+		data->data = NULL;
+	}
+	if(data->compressed != NULL)
+	{
+		history->total_size -= data->compressed_size;
+		MEM_FREE_FUNC(data->compressed);
+		data->compressed = NULL;
+	}
+	if((data->flags & HISTORY_DATA_SPILLED) != 0)
+	{
+		FreeHistorySpillExtent(history, data->spill_offset, (gint64)((data->compressed_size != 0)
+			? data->compressed_size : data->data_size));
+	}
+	data->compressed_size = 0;
+	data->spill_offset = 0;
+	data->flags = 0;
+}
+
+// ꎞt@Cɑޔf[^ɓǂݖ߂
+	// (t@CŜł͂Ȃ̗͈̔͂ǂݍ)
+static int LoadSpilledHistoryData(HISTORY* history, HISTORY_DATA* data)
+{
+	uint8 *contents;
+	size_t size = (data->compressed_size != 0) ? data->compressed_size : data->data_size;
+
+	if(history->spill_file == NULL
+		|| HISTORY_FSEEK(history->spill_file, data->spill_offset, SEEK_SET) != 0)
+	{
+		return -1;
+	}
+
+	data->data = MEM_ALLOC_FUNC(data->data_size);
+	if(data->data == NULL)
+	{
+		return -1;
+	}
+
+	if(data->compressed_size != 0)
+	{
+		contents = (uint8*)MEM_ALLOC_FUNC(size);
+		if(contents == NULL
+			|| fread(contents, 1, size, history->spill_file) != size
+			|| InflateData(contents, (uint8*)data->data,
+				data->compressed_size, data->data_size, NULL) != 0)
+		{
+			MEM_FREE_FUNC(contents);
+			MEM_FREE_FUNC(data->data);
+			data->data = NULL;
+			return -1;
+		}
+		MEM_FREE_FUNC(contents);
+	}
+	else if(fread(data->data, 1, size, history->spill_file) != size)
+	{
+		MEM_FREE_FUNC(data->data);
+		data->data = NULL;
+		return -1;
+	}
+
+	// ꎞt@C̃f[^͏ꂽ̂߂ɎgȂȂ
+	FreeHistorySpillExtent(history, data->spill_offset, (gint64)size);
+	history->total_size += data->data_size;
+	data->compressed_size = 0;
+	data->spill_offset = 0;
+	data->flags &= ~(HISTORY_DATA_SPILLED);
+
+	return 0;
+}
+
+// kς݂̗f[^ɖ߂E蒼OɓWJ
+static int LoadHistoryData(HISTORY* history, int index)
+{
+	HISTORY_DATA *data = &history->history[index];
+
+	// ꎞt@Cւ̏oȂǂݍޑOɏI҂
+	if(history->compress.thread != NULL
+		&& (history->compress.index == index || (data->flags & HISTORY_DATA_SPILLED) != 0))
+	{
+		FinishHistoryCompression(history, FALSE);
+	}
+
+	if(data->data != NULL)
+	{
+		return 0;
+	}
+	if((data->flags & HISTORY_DATA_SPILLED) != 0)
+	{
+		return LoadSpilledHistoryData(history, data);
+	}
+	if(data->compressed == NULL)
+	{
+		return -1;
+	}
+
+	data->data = MEM_ALLOC_FUNC(data->data_size);
+	if(data->data == NULL)
+	{
+		return -1;
+	}
+	if(InflateData((uint8*)data->compressed, (uint8*)data->data,
+		data->compressed_size, data->data_size, NULL) != 0)
+	{
+		MEM_FREE_FUNC(data->data);
+		data->data = NULL;
+		return -1;
+	}
+
+	// ɖ߂Ńf[^邱Ƃ̂
+		// kς݂̃f[^͎̂ĂĕKvɂȂ爳k
+	history->total_size += data->data_size;
+	history->total_size -= data->compressed_size;
+	MEM_FREE_FUNC(data->compressed);
+	data->compressed = NULL;
+	data->compressed_size = 0;
+
+	return 0;
+}
+
+// gpʂ𒴂ĂÂ̂Ă
+static void ReduceHistoryMemory(HISTORY* history)
+{
+	int index;
+
+	if(history->memory_limit == 0)
+	{
+		return;
+	}
+
+	// ԐV͏𒴂ĂĂc
+	while(history->total_size > history->memory_limit && history->rest_undo > 1)
+	{
+		index = ((int)history->point + HISTORY_BUFFER_SIZE*2 - (int)history->rest_undo)
+			% HISTORY_BUFFER_SIZE;
+		ReleaseHistoryData(history, index);
+		history->rest_undo--;
+	}
+}
+
 static void ReleaseRedoData(HISTORY* history)
 {
 	int ref;
@@ -20,8 +551,7 @@ static void ReleaseRedoData(HISTORY* history)
 	for(i=0; i<history->rest_redo; i++)
 	{
 		ref = (history->point+i) % HISTORY_BUFFER_SIZE;
-		MEM_FREE_FUNC(history->history[ref].data);
-		history->history[ref].data = NULL;
+		ReleaseHistoryData(history, ref);
 	}
 	history->rest_redo = 0;
 }
@@ -29,7 +559,7 @@ static void ReleaseRedoData(HISTORY* history)
 static void AddHistoryData(
 	HISTORY_DATA* history,
 	const gchar* name,
-	const void* data,
+	void* data,
 	size_t data_size,
 	history_func undo,
 	history_func redo
@@ -39,8 +569,7 @@ static void AddHistoryData(
 	history->data_size = data_size;
 	history->undo = undo;
 	history->redo = redo;
-	history->data = MEM_ALLOC_FUNC(data_size);
-	(void)memcpy(history->data, data, data_size);
+	history->data = data;
 }
 
 void AddHistory(
@@ -51,6 +580,21 @@ void AddHistory(
 	history_func undo,
 	history_func redo
 )
+{
+	void *copy_data = MEM_ALLOC_FUNC(data_size);
+	(void)memcpy(copy_data, data, data_size);
+
+	AddHistoryBuffer(history, name, copy_data, data_size, undo, redo);
+}
+
+void AddHistoryBuffer(
+	HISTORY* history,
+	const gchar* name,
+	void* data,
+	size_t data_size,
+	history_func undo,
+	history_func redo
+)
 {
 	ReleaseRedoData(history);
 
@@ -64,25 +608,47 @@ void AddHistory(
 	if(history->point >= HISTORY_BUFFER_SIZE)
 	{
 		history->point = 0;
-		MEM_FREE_FUNC(history->history->data);
+		ReleaseHistoryData(history, 0);
 		AddHistoryData(history->history, name, data, data_size, undo, redo);
 	}
 	else
 	{
-		MEM_FREE_FUNC(history->history[history->point].data);
+		ReleaseHistoryData(history, history->point);
 		AddHistoryData(&history->history[history->point],
 			name, data, data_size, undo, redo);
 	}
+	history->total_size += data_size;
 
 	history->point++;
 
 	history->flags |= HISTORY_UPDATED;
 
+	// gpʂɎ߂ČÂk
+	ReduceHistoryMemory(history);
+	StartHistoryCompression(history);
+
 #ifdef _DEBUG
 	g_print("History Add : %s\n", name);
 #endif
 }
 
+// f[^ǂݍ߂Ɍɖ߂E蒼łȂƂm点
+static void ShowHistoryLoadError(APPLICATION* app)
+{
+	GtkWidget *dialog;
+
+	if((app->flags & APPLICATION_HEADLESS) != 0)
+	{
+		(void)fprintf(stderr, "%s\n", app->labels->menu.history_load_error);
+		return;
+	}
+
+	dialog = gtk_message_dialog_new(GTK_WINDOW(app->window), GTK_DIALOG_MODAL,
+		GTK_MESSAGE_ERROR, GTK_BUTTONS_OK, "%s", app->labels->menu.history_load_error);
+	(void)gtk_dialog_run(GTK_DIALOG(dialog));
+	gtk_widget_destroy(dialog);
+}
+
 void ExecuteUndo(struct _APPLICATION* app)
 {
 	DRAW_WINDOW *window = GetActiveDrawWindow(app);
@@ -91,6 +657,11 @@ void ExecuteUndo(struct _APPLICATION* app)
 	{
 		int execute = (window->history.point == 0) ? HISTORY_BUFFER_SIZE - 1
 			: window->history.point - 1;
+		if(LoadHistoryData(&window->history, execute) < 0)
+		{
+			ShowHistoryLoadError(app);
+			return;
+		}
 		window->history.history[execute].undo(
 			window, window->history.history[execute].data
 		);
@@ -105,8 +676,15 @@ void ExecuteUndo(struct _APPLICATION* app)
 		{
 			window->history.point = HISTORY_BUFFER_SIZE - 1;
 		}
+
+		StartHistoryCompression(&window->history);
 	}
 
+	// ANeBuȃC[̃sNZf[^ς\̂
+		// C[Zbg̃LbVƕs͈̔͂j
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
+
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 
 	gtk_widget_queue_draw(window->window);
@@ -123,6 +701,11 @@ void ExecuteRedo(struct _APPLICATION *app)
 		{
 			execute = 0;
 		}
+		if(LoadHistoryData(&window->history, execute) < 0)
+		{
+			ShowHistoryLoadError(app);
+			return;
+		}
 		window->history.history[execute].redo(
 			window, window->history.history[execute].data
 		);
@@ -134,13 +717,52 @@ void ExecuteRedo(struct _APPLICATION *app)
 		{
 			window->history.point = 0;
 		}
+
+		StartHistoryCompression(&window->history);
 	}
 
+	// ANeBuȃC[̃sNZf[^ς\̂
+		// C[Zbg̃LbVƕs͈̔͂j
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
+
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 
 	gtk_widget_queue_draw(window->window);
 }
 
+void ReleaseHistory(HISTORY* history)
+{
+	int i;
+
+	FinishHistoryCompression(history, FALSE);
+
+	for(i=0; i<HISTORY_BUFFER_SIZE; i++)
+	{
+		ReleaseHistoryData(history, i);
+	}
+
+	history->point = 0;
+	history->num_step = 0;
+	history->rest_undo = 0;
+	history->rest_redo = 0;
+	history->total_size = 0;
+
+	CloseHistorySpillFile(history);
+}
+
+void SetHistoryMemoryLimit(HISTORY* history, size_t limit)
+{
+	history->memory_limit = limit;
+	ReduceHistoryMemory(history);
+}
+
+void SetHistorySpillSteps(HISTORY* history, int steps)
+{
+	history->spill_steps = steps;
+	StartHistoryCompression(history);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,12 +11,24 @@ extern "C" {
 
 #define HISTORY_BUFFER_SIZE 256
 #define HISTORY_MAX_NAME_LEN 128
+// f[^̃gpʂ̏̏l(MB)
+#define HISTORY_DEFAULT_MEMORY_LIMIT 1024
+// ꎞt@CɑޔɎc̐̏l
+#define HISTORY_DEFAULT_SPILL_STEPS 8
+// k闚f[^̍őoCg(zlibɈxɓn͈)
+#define HISTORY_COMPRESS_MAX_SIZE 0x7FFFFFFF
 
 typedef enum _eHISTORY_FLAGS
 {
 	HISTORY_UPDATED = 0x01
 } eHISTORY_FLAGS;
 
+typedef enum _eHISTORY_DATA_FLAGS
+{
+	HISTORY_DATA_INCOMPRESSIBLE = 0x01,
+	HISTORY_DATA_SPILLED = 0x02
+} eHISTORY_DATA_FLAGS;
+
 typedef void (*history_func)(struct _DRAW_WINDOW* window, void* data);
 
 typedef struct _HISTORY_DATA
@@ -24,9 +36,42 @@ typedef struct _HISTORY_DATA
 	gchar name[HISTORY_MAX_NAME_LEN];
 	size_t data_size;
 	void* data;
+	// kς݂̃f[^(dataNULL̎ɗL)
+	void* compressed;
+	size_t compressed_size;
+	// ꎞt@Cɑޔf[^̈ʒu(HISTORY_DATA_SPILLED̎ɗL)
+	gint64 spill_offset;
+	uint32 flags;
 	history_func undo, redo;
 } HISTORY_DATA;
 
+/*************************************
+* HISTORY_SPILL_EXTENT\         *
+* ꎞt@C̎gĂȂ̈ *
+*************************************/
+typedef struct _HISTORY_SPILL_EXTENT
+{
+	gint64 offset;	// ̈̊Jnʒu
+	gint64 size;	// ̈̃oCg
+} HISTORY_SPILL_EXTENT;
+
+/***************************************************
+* HISTORY_COMPRESS\                           *
+* ʃXbhŗf[^kEޔ鏈̏ *
+***************************************************/
+typedef struct _HISTORY_COMPRESS
+{
+	GThread *thread;		// k̃Xbh(NULLȂ爳kĂȂ)
+	int index;				// k̗̈ʒu
+	int spill;				// kł͂Ȃꎞt@Cւ̏oȂTRUE
+	gint64 spill_offset;	// ꎞt@C̏oʒu
+	uint8 *source;			// kf[^
+	size_t source_size;		// kf[^̃oCg
+	uint8 *result;			// k(sȂNULL)
+	size_t result_size;		// kʂ̃oCg
+	guint idle_id;			// kʂ𔽉fAChID
+} HISTORY_COMPRESS;
+
 typedef struct _HISTORY
 {
 	uint16 point;
@@ -36,6 +81,24 @@ typedef struct _HISTORY
 
 	uint32 flags;
 
+	// f[^̃gpʂ̏(0Ȃ疳)
+	size_t memory_limit;
+	// ێĂ闚f[^̃oCg
+	size_t total_size;
+	// ʃXbhł̈k
+	HISTORY_COMPRESS compress;
+
+	// Âf[^ޔꎞt@C
+	FILE *spill_file;
+	gchar *spill_path;
+	// ꎞt@CɏooCg
+	gint64 spill_size;
+	// ėpłꎞt@C̗̈(ʒȕɕׂ)
+	HISTORY_SPILL_EXTENT spill_free[HISTORY_BUFFER_SIZE+1];
+	int num_spill_free;
+	// ꎞt@CɑޔɎc̐(0ȂޔȂ)
+	int spill_steps;
+
 	HISTORY_DATA history[HISTORY_BUFFER_SIZE];
 } HISTORY;
 
@@ -48,6 +111,54 @@ extern void AddHistory(
 	history_func redo
 );
 
+/*************************************************
+* AddHistoryBuffer֐                           *
+* mۍς݂̃obt@Rs[ɗɒǉ *
+* (obt@͈ȍ~f[^ŊJ)         *
+*                                            *
+* history	: f[^                         *
+* name		: ̖O                         *
+* data		: MEM_ALLOC_FUNCŊmۂf[^ *
+* data_size	: f[^̃oCg               *
+* undo		: ɖ߂֐                       *
+* redo		: 蒼̊֐                     *
+*************************************************/
+extern void AddHistoryBuffer(
+	HISTORY* history,
+	const gchar* name,
+	void* data,
+	size_t data_size,
+	history_func undo,
+	history_func redo
+);
+
+/***************************************
+* ReleaseHistory֐                   *
+* f[^SĊJ             *
+* (k̃XbhΏI҂) *
+*                                  *
+* history	: f[^               *
+***************************************/
+extern void ReleaseHistory(HISTORY* history);
+
+/*******************************************
+* SetHistoryMemoryLimit֐                *
+* f[^̃gpʂ̏ݒ肷 *
+*                                      *
+* history	: f[^                   *
+* limit		: ̃oCg(0Ȃ疳)  *
+*******************************************/
+extern void SetHistoryMemoryLimit(HISTORY* history, size_t limit);
+
+/*******************************************************
+* SetHistorySpillSteps֐                             *
+* ꎞt@CɑޔɎc̐ݒ肷 *
+*                                                  *
+* history	: f[^                               *
+* steps		: Ɏc̐(0ȂޔȂ)    *
+*******************************************************/
+extern void SetHistorySpillSteps(HISTORY* history, int steps);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1196,6 +1196,33 @@ void WriteJpegFile(
 	(void)fclose(fp);
 }
 
+// ǉɕۑꂽC[IDoĊ蓖Ă
+static void ReadLayerIDExtraData(LAYER* layer)
+{
+	uint32 id;
+	int i;
+
+	for(i=0; i<layer->num_extra_data && i<MAX_LAYER_EXTRA_DATA_NUM; i++)
+	{
+		if(layer->extra_data[i].name != NULL
+			&& strcmp(layer->extra_data[i].name, LAYER_ID_EXTRA_DATA_NAME) == 0
+			&& layer->extra_data[i].data_size == sizeof(id))
+		{
+			(void)memcpy(&id, layer->extra_data[i].data, sizeof(id));
+			AssignLayerID(layer, id);
+
+			// ۑɏôŒǉ񂩂͊O
+			MEM_FREE_FUNC(layer->extra_data[i].name);
+			MEM_FREE_FUNC(layer->extra_data[i].data);
+			(void)memmove(&layer->extra_data[i], &layer->extra_data[i+1],
+				sizeof(*layer->extra_data) * (MAX_LAYER_EXTRA_DATA_NUM - i - 1));
+			(void)memset(&layer->extra_data[MAX_LAYER_EXTRA_DATA_NUM-1], 0, sizeof(*layer->extra_data));
+			layer->num_extra_data--;
+			return;
+		}
+	}
+}
+
 /***********************************************************
 * ReadOriginalFormatLayers֐                             *
 * Ǝ`̃C[f[^ǂݍ                       *
@@ -1538,6 +1565,8 @@ LAYER* ReadOriginalFormatLayers(
 			layer->extra_data[j].data = MEM_ALLOC_FUNC(layer->extra_data[j].data_size);
 			(void)MemRead(layer->extra_data[j].data, 1, layer->extra_data[j].data_size, stream);
 		}
+		// ۑĂIDC[ɖ߂
+		ReadLayerIDExtraData(layer);
 
 		// i󋵂XV
 		current_progress += progress_step;
@@ -1929,6 +1958,8 @@ LAYER* ReadOriginalFormatLayersOldVersion5(
 			layer->extra_data[j].data = MEM_ALLOC_FUNC(layer->extra_data[j].data_size);
 			(void)MemRead(layer->extra_data[j].data, 1, layer->extra_data[j].data_size, stream);
 		}
+		// ۑĂIDC[ɖ߂
+		ReadLayerIDExtraData(layer);
 
 		// i󋵂XV
 		current_progress += progress_step;
@@ -2301,6 +2332,8 @@ LAYER* ReadOriginalFormatLayersOldVersion4(
 			layer->extra_data[j].data = MEM_ALLOC_FUNC(layer->extra_data[j].data_size);
 			(void)MemRead(layer->extra_data[j].data, 1, layer->extra_data[j].data_size, stream);
 		}
+		// ۑĂIDC[ɖ߂
+		ReadLayerIDExtraData(layer);
 
 		// i󋵂XV
 		current_progress += progress_step;
@@ -3777,6 +3810,14 @@ void ReadOriginalFormatMemoryStream(
 		NULL, NULL, NULL, window);
 	(void)memcpy(window->under_active->pixels, window->back_ground, window->pixel_buf_size);
 
+	// ANeBuC[摜̕ۑp
+	window->above_active = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, window);
+
+	// NbsÕ}XNpɃANeBuC[ƍƃC[摜̕ۑp
+	window->mask_source = CreateLayer(0, 0, width, height, 4, TYPE_NORMAL_LAYER,
+		NULL, NULL, NULL, window);
+
 	progress_step = 1.0 / (window->num_layer + 1);
 	// C[̓ǂݍ
 	window->layer = ReadOriginalFormatLayers(stream, progress_step, window, window->app, window->num_layer);
@@ -3854,6 +3895,8 @@ void WriteOriginalFormat(
 	int8 hierarchy = 0;
 	// 64bit̏ꍇsize_t̃oCgς邽ߕύXp
 	guint32 size_t_temp;
+	// oǉ̐
+	uint8 num_extra_data;
 	int i;	// forp̃JE^
 
 	// ip[Ze[W\
@@ -4191,8 +4234,13 @@ void WriteOriginalFormat(
 		}
 
 		// ǉ
-			// ǉ̐o
-		(void)write_func(&layer->num_extra_data, sizeof(layer->num_extra_data), 1, stream);
+			// ǉ̐o(󂫂΃C[ID܂߂)
+		num_extra_data = layer->num_extra_data;
+		if(layer->id != 0 && num_extra_data < MAX_LAYER_EXTRA_DATA_NUM)
+		{
+			num_extra_data++;
+		}
+		(void)write_func(&num_extra_data, sizeof(num_extra_data), 1, stream);
 		for(i=0; i<layer->num_extra_data; i++)
 		{
 			// f[^̖O̒o
@@ -4203,6 +4251,15 @@ void WriteOriginalFormat(
 			(void)write_func(&size_t_temp, sizeof(size_t_temp), 1, stream);
 			(void)write_func(layer->extra_data[i].data, 1, layer->extra_data[i].data_size, stream);
 		}
+		if(num_extra_data > layer->num_extra_data)
+		{	// C[IDo
+			name_length = (uint16)sizeof(LAYER_ID_EXTRA_DATA_NAME);
+			(void)write_func(&name_length, sizeof(name_length), 1, stream);
+			(void)write_func(LAYER_ID_EXTRA_DATA_NAME, 1, name_length, stream);
+			size_t_temp = (guint32)sizeof(layer->id);
+			(void)write_func(&size_t_temp, sizeof(size_t_temp), 1, stream);
+			(void)write_func(&layer->id, sizeof(layer->id), 1, stream);
+		}
 
 		layer = layer->next;
 
@@ -7,11 +7,186 @@
 #include "input.h"
 #include "brush_core.h"
 #include "transform.h"
+#include "display.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/***************************************************
+* FlushStrokeQueue֐                             *
+* ܂ĂuV̓͂SăuVɏ *
+*                                              *
+* window	: `̈̏                       *
+***************************************************/
+void FlushStrokeQueue(DRAW_WINDOW* window)
+{
+	STROKE_QUEUE *queue = &window->stroke_queue;
+	STROKE_SAMPLE *sample;
+
+	if(queue->dispatch_id != 0)
+	{
+		(void)g_source_remove(queue->dispatch_id);
+		queue->dispatch_id = 0;
+	}
+
+	while(queue->tail != queue->head)
+	{
+		sample = &queue->samples[queue->tail];
+		queue->tail = (queue->tail + 1) % STROKE_QUEUE_SIZE;
+		window->motion_time = sample->time;
+		sample->core->motion_func(window, sample->x, sample->y,
+			sample->pressure, sample->core, (void*)(&sample->state));
+	}
+}
+
+/*****************************************************
+* StrokeQueueIdle֐                                *
+* CxgAʍXVOɗ܂͂ *
+*                                                *
+* window	: `̈̏                         *
+* Ԃl                                             *
+*	FALSE(1ŏI)                             *
+*****************************************************/
+static gboolean StrokeQueueIdle(DRAW_WINDOW* window)
+{
+	window->stroke_queue.dispatch_id = 0;
+	FlushStrokeQueue(window);
+
+	return FALSE;
+}
+
+/*************************************
+* PushStrokeSample֐               *
+* uV̓͂L[ɒǉ     *
+*                                *
+* window		: `̈̏     *
+* core		: ͂uV   *
+* x			: LoXXW    *
+* y			: LoXYW    *
+* pressure	: M                   *
+* state		: {^ACL[̏ *
+* time		: ͂ꂽ         *
+*************************************/
+static void PushStrokeSample(
+	DRAW_WINDOW* window,
+	BRUSH_CORE* core,
+	gdouble x,
+	gdouble y,
+	gdouble pressure,
+	GdkModifierType state,
+	guint32 time
+)
+{
+	STROKE_QUEUE *queue = &window->stroke_queue;
+	STROKE_SAMPLE *sample;
+	int next = (queue->head + 1) % STROKE_QUEUE_SIZE;
+
+	// L[tȂɏĂ܂
+	if(next == queue->tail)
+	{
+		FlushStrokeQueue(window);
+	}
+
+	sample = &queue->samples[queue->head];
+	sample->core = core;
+	sample->x = x,	sample->y = y;
+	sample->pressure = pressure;
+	sample->state = state;
+	sample->time = time;
+	queue->head = next;
+
+	// ̓CxgIĂAʍXV̑Oɂ܂Ƃ߂ĕ`悷
+	if(queue->dispatch_id == 0)
+	{
+		queue->dispatch_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE,
+			(GSourceFunc)StrokeQueueIdle, window, NULL);
+	}
+}
+
+/*********************************************
+* CaptureMotionHistory֐                   *
+* ÕCxg獡̃Cxg܂ł̊Ԃ *
+* ̓foCXL^Wo     *
+* u␳ĂL[ɒǉ     *
+*                                        *
+* window	: `̈̏                 *
+* event	: }EX̏                       *
+* core	: ͂uV               *
+*********************************************/
+static void CaptureMotionHistory(
+	DRAW_WINDOW* window,
+	GdkEventMotion* event,
+	BRUSH_CORE* core
+)
+{
+	GdkTimeCoord **history;
+	gint num_history;
+	gdouble window_x, window_y;
+	gdouble cursor_x, cursor_y;
+	FLOAT_T x, y, pressure;
+	int i;
+
+	if(window->last_motion_time == 0 || event->time <= window->last_motion_time + 1)
+	{
+		return;
+	}
+
+	// ̃Cxg̍W͌Ăяoŏ̂Ŋ܂߂Ȃ
+	if(gdk_device_get_history(event->device, event->window, window->last_motion_time + 1,
+		event->time - 1, &history, &num_history) == FALSE)
+	{
+		return;
+	}
+
+	for(i=0; i<num_history; i++)
+	{
+		if(gdk_device_get_axis(event->device, history[i]->axes, GDK_AXIS_X, &window_x) == FALSE
+			|| gdk_device_get_axis(event->device, history[i]->axes, GDK_AXIS_Y, &window_y) == FALSE)
+		{
+			continue;
+		}
+		if(gdk_device_get_axis(event->device, history[i]->axes, GDK_AXIS_PRESSURE, &pressure) == FALSE)
+		{
+			pressure = 1.0;
+		}
+		if(pressure < MINIMUM_PRESSURE)
+		{
+			pressure = MINIMUM_PRESSURE;
+		}
+
+		// MotionNotifyEventƓ]AgkAE]߂
+		cursor_x = (window_x - window->half_size) * window->cos_value
+			- (window_y - window->half_size) * window->sin_value + window->add_cursor_x;
+		cursor_y = (window_x - window->half_size) * window->sin_value
+			+ (window_y - window->half_size) * window->cos_value + window->add_cursor_y;
+		x = window->rev_zoom * cursor_x;
+		y = window->rev_zoom * cursor_y;
+		if((window->flags & DRAW_WINDOW_DISPLAY_HORIZON_REVERSE) != 0)
+		{
+			x = window->width - x;
+		}
+
+		if(window->app->tool_window.smoother.num_use != 0
+			&& (window->app->tool_window.vector_control.flags & CONTROL_POINT_TOOL_HAS_POINT) == 0)
+		{
+			if(window->app->tool_window.smoother.mode == SMOOTH_GAUSSIAN)
+			{
+				Smooth(&window->app->tool_window.smoother, &x, &y, history[i]->time, window->rev_zoom);
+			}
+			else if(AddAverageSmoothPoint(&window->app->tool_window.smoother,
+				&x, &y, &pressure, window->rev_zoom) == FALSE)
+			{
+				continue;
+			}
+		}
+
+		PushStrokeSample(window, core, x, y, pressure, window->state, history[i]->time);
+	}
+
+	gdk_device_free_history(history, num_history);
+}
+
 /***********************************************
 * ButtonPressEvent֐                         *
 * }EXNbN̏                         *
@@ -40,6 +215,14 @@ gboolean ButtonPressEvent(GtkWidget *widget, GdkEventButton *event, DRAW_WINDOW*
 		return TRUE;
 	}
 
+	// ÕXg[N̓͂cĂΐɏ
+	FlushStrokeQueue(window);
+	// ̓͗o
+	window->last_motion_time = event->time;
+
+	// LoX̍ʂQƂc[̂߂Ɍ񂵂ɂ^CĂ
+	FlushStaleTiles(window);
+
 	// ʍXVp̃f[^擾
 	if(window->transform == NULL)
 	{
@@ -216,6 +399,11 @@ gboolean ButtonPressEvent(GtkWidget *widget, GdkEventButton *event, DRAW_WINDOW*
 		if(window->active_layer->layer_type == TYPE_NORMAL_LAYER
 			|| (window->flags & DRAW_WINDOW_EDIT_SELECTION) != 0)
 		{
+			// ÕXg[NŋL^ƃC[̃^CcȂ
+			ResetWorkLayerTiles(window);
+			// ͂L^ȂuV̊֐L^p̂̂ɍւ
+			BeginRecordStroke(window, window->app->tool_window.active_brush[window->app->input]);
+
 			if((event->state & GDK_CONTROL_MASK) == 0 && event->button != 3)
 			{
 				if((event->state & GDK_SHIFT_MASK) == 0)
@@ -331,6 +519,8 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 	gdouble x, y, x0, y0;
 	gdouble rev_zoom = window->rev_zoom;
 	int update_window = 0;
+	// uV̓͂L[ɗ߂ۂ
+	gboolean queued = FALSE;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *device;
 	GdkInputSource source;
@@ -353,6 +543,7 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 		x0 = event->x;
 		y0 = event->y;
 	}
+	window->motion_time = event->time;
 
 	// ]vZ
 	window->cursor_x = (x0 - window->half_size) * window->cos_value
@@ -512,6 +703,11 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 					if(window->active_layer->layer_type == TYPE_NORMAL_LAYER
 						|| (window->flags & DRAW_WINDOW_EDIT_SELECTION) != 0)
 					{
+						// ÕXg[NŋL^ƃC[̃^CcȂ
+						ResetWorkLayerTiles(window);
+						// ͂L^ȂuV̊֐L^p̂̂ɍւ
+						BeginRecordStroke(window, window->app->tool_window.active_brush[window->app->input]);
+
 						if((state & GDK_CONTROL_MASK) == 0)
 						{
 							if((state & GDK_SHIFT_MASK) == 0)
@@ -609,6 +805,9 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 				button.state = GDK_BUTTON1_MASK | state;
 				button.device = event->device;
 
+				// Xg[NIOɗ܂Ă͂
+				FlushStrokeQueue(window);
+
 				window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_OVER;
 
 				if(window->app->tool_window.smoother.num_use > 0 &&
@@ -813,6 +1012,9 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 			button.state = GDK_BUTTON1_MASK | state;
 			button.device = event->device;
 
+			// Xg[NIOɗ܂Ă͂
+			FlushStrokeQueue(window);
+
 			window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_OVER;
 
 			if(window->app->tool_window.smoother.num_use > 0 &&
@@ -1017,6 +1219,16 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 		pressure = MINIMUM_PRESSURE;
 	}
 
+	// uVŃhbOȂCxg̊ԂɋL^ꂽ͂o
+	if((window->state & GDK_BUTTON1_MASK) != 0 && window->transform == NULL
+		&& (window->app->tool_window.flags & TOOL_USING_BRUSH) != 0
+		&& (window->active_layer->layer_type == TYPE_NORMAL_LAYER
+			|| (window->flags & DRAW_WINDOW_EDIT_SELECTION) != 0))
+	{
+		CaptureMotionHistory(window, event,
+			window->app->tool_window.active_brush[window->app->input]);
+	}
+
 	// u␳s
 	if((window->state & GDK_BUTTON1_MASK) != 0)
 	{
@@ -1080,9 +1292,18 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 		if(window->active_layer->layer_type == TYPE_NORMAL_LAYER
 			|| (window->flags & DRAW_WINDOW_EDIT_SELECTION) != 0)
 		{
-			window->app->tool_window.active_brush[window->app->input]->motion_func(
-				window, x, y, pressure, window->app->tool_window.active_brush[window->app->input], (void*)(&window->state)
-			);
+			if((window->state & GDK_BUTTON1_MASK) != 0)
+			{	// hbO̓L[ɗ߂ăCxgɂ܂Ƃ߂ĕ`悷
+				PushStrokeSample(window, window->app->tool_window.active_brush[window->app->input],
+					x, y, pressure, window->state, event->time);
+				queued = TRUE;
+			}
+			else
+			{
+				window->app->tool_window.active_brush[window->app->input]->motion_func(
+					window, x, y, pressure, window->app->tool_window.active_brush[window->app->input], (void*)(&window->state)
+				);
+			}
 		}
 		else if(window->active_layer->layer_type == TYPE_VECTOR_LAYER)
 		{
@@ -1121,7 +1342,8 @@ gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW
 	update_func(window, x0, y0, update_data);
 
 func_end:
-	if(update_window != 0)
+	// L[ɗ߂͉͂ʍXVOɏ̂ő҂Ȃ
+	if(update_window != 0 && queued == FALSE)
 	{
 		GdkEvent *queued_event = NULL;
 
@@ -1153,6 +1375,7 @@ func_end:
 
 	window->before_cursor_x = x0;
 	window->before_cursor_y = y0;
+	window->last_motion_time = event->time;
 
 	if(event->is_hint != FALSE)
 	{
@@ -1173,6 +1396,9 @@ gboolean ButtonReleaseEvent(GtkWidget *widget, GdkEventButton *event, DRAW_WINDO
 	GdkInputSource source;
 #endif
 
+	// Xg[NIOɗ܂Ă͂
+	FlushStrokeQueue(window);
+
 	// ʍXVp̃f[^擾
 	if(window->transform == NULL)
 	{
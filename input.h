@@ -32,6 +32,14 @@ extern gboolean ButtonPressEvent(GtkWidget *widget, GdkEventButton *event, struc
 *************************************/
 extern gboolean MotionNotifyEvent(GtkWidget *widget, GdkEventMotion *event, DRAW_WINDOW* window);
 
+/***************************************************
+* FlushStrokeQueue֐                             *
+* ܂ĂuV̓͂SăuVɏ *
+*                                              *
+* window	: `̈̏                       *
+***************************************************/
+extern void FlushStrokeQueue(DRAW_WINDOW* window);
+
 extern gboolean ButtonReleaseEvent(GtkWidget *widget, GdkEventButton *event, DRAW_WINDOW* window);
 
 extern gboolean MouseWheelEvent(GtkWidget*widget, GdkEventScroll* event_info, DRAW_WINDOW* window);
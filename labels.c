@@ -180,6 +180,8 @@ void LoadLabels(
 	labels->menu.transform = g_convert(temp_str, length, "UTF-8", lang, NULL, NULL, NULL);
 	length = IniFileGetString(file, "EDIT", "PROJECTION", temp_str, MAX_STR_SIZE);
 	labels->menu.projection = g_convert(temp_str, length, "UTF-8", lang, NULL, NULL, NULL);
+	length = IniFileGetString(file, "EDIT", "HISTORY_LOAD_ERROR", temp_str, MAX_STR_SIZE);
+	labels->menu.history_load_error = g_convert(temp_str, length, "UTF-8", lang, NULL, NULL, NULL);
 
 	// LoXj[
 	length = IniFileGetString(file, "CANVAS", "MENU_NAME", temp_str, MAX_STR_SIZE);
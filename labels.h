@@ -55,7 +55,7 @@ typedef struct _APPLICATON_LABELS
 	{
 		gchar *file, *make_new, *open, *open_as_layer, *save, *save_as, *close, *quit;
 		gchar *edit, *undo, *redo, *copy, *copy_visible, *cut, *paste, *clip_board,
-			*transform, *projection;
+			*transform, *projection, *history_load_error;
 		gchar *canvas, *change_resolution, *change_canvas_size,
 			*flip_canvas_horizontally, *flip_canvas_vertically,
 			*switch_bg_color, *change_2nd_bg_color, *canvas_icc;
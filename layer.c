@@ -15,6 +15,7 @@
 #include <math.h>
 #include <zlib.h>
 #include "layer.h"
+#include "layer_blend_native.h"
 #include "memory.h"
 #include "application.h"
 #include "history.h"
@@ -75,6 +76,13 @@ LAYER* CreateLayer(
 	ret->alpha = 100;
 	ret->window = window;
 
+	// O̕tC[͗𓙂IDŒT悤ɂ
+	if(name != NULL)
+	{
+		AssignLayerID(ret, 0);
+	}
+	UpdateLayerContentGeneration(ret);
+
 	// sNZ
 	(void)memset(ret->pixels, 0x0, sizeof(uint8)*(ret->stride*height));
 
@@ -315,6 +323,7 @@ void DeleteLayer(LAYER** layer)
 	cairo_destroy((*layer)->cairo_p);
 	cairo_surface_destroy((*layer)->surface_p);
 	MEM_FREE_FUNC((*layer)->name);
+	UnregisterLayerID(*layer);
 
 	if((*layer)->widget != NULL)
 	{
@@ -365,6 +374,7 @@ void DeleteTempLayer(LAYER** layer)
 	cairo_destroy((*layer)->cairo_p);
 	cairo_surface_destroy((*layer)->surface_p);
 	MEM_FREE_FUNC((*layer)->name);
+	UnregisterLayerID(*layer);
 
 	if((*layer)->widget != NULL)
 	{
@@ -393,6 +403,7 @@ typedef struct _DELETE_LAYER_HISTORY
 	uint32 flags;				// C[̕\E\̃tO
 	int8 channel;				// C[̃`l
 	int8 alpha;					// C[̕sx
+	uint32 layer_id;			// C[ID
 	uint16 name_length;			// C[̖O̒
 	gchar* name;				// C[̖O
 	uint16 prev_name_length;	// ÕC[̕
@@ -468,6 +479,8 @@ static void DeleteLayerUndo(DRAW_WINDOW* window, void* p)
 		history.layer_type, prev, (prev == NULL) ? window->layer : prev->next,
 		history.name, window
 	);
+	// 폜OIDɖ߂đ̗f[^T悤ɂ
+	AssignLayerID(layer, history.layer_id);
 
 	// C[̃sNZf[^ǂݍ
 	(void)MemSeek(&stream, sizeof(size_t), SEEK_CUR);
@@ -512,6 +525,8 @@ static void DeleteLayerRedo(DRAW_WINDOW* window, void* p)
 	gchar* name;
 	// 폜C[̒
 	uint16 name_length;
+	// 폜C[ID
+	uint32 layer_id;
 
 	// Xg[
 	stream.block_size = 1;
@@ -524,8 +539,10 @@ static void DeleteLayerRedo(DRAW_WINDOW* window, void* p)
 	(void)MemRead(&name_length, sizeof(name_length), 1, &stream);
 	name = (gchar*)MEM_ALLOC_FUNC(name_length);
 	(void)MemRead(name, 1, name_length, &stream);
+	(void)memcpy(&layer_id,
+		&stream.buff_ptr[sizeof(size_t) + offsetof(DELETE_LAYER_HISTORY, layer_id)], sizeof(layer_id));
 
-	delete_layer = SearchLayer(window->layer, name);
+	delete_layer = SearchLayerByIDAndName(window, layer_id, name);
 	DeleteLayer(&delete_layer);
 
 	MEM_FREE_FUNC(name);
@@ -571,6 +588,7 @@ void AddDeleteLayerHistory(
 	history.flags = target->flags;
 	history.channel = target->channel;
 	history.alpha = target->alpha;
+	history.layer_id = target->id;
 	// Xg[֏
 	(void)MemWrite(&history, 1,
 		offsetof(DELETE_LAYER_HISTORY, name_length), history_data);
@@ -1048,6 +1066,7 @@ typedef struct _ADD_NEW_LAYER_HISTORY_DATA
 	int32 width, height;
 	uint8 channel;
 	uint16 prev_name_length;
+	uint32 layer_id;
 	char* layer_name, *prev_name;
 } ADD_NEW_LAYER_HISTORY_DATA;
 
@@ -1061,7 +1080,7 @@ static void AddNewLayerUndo(DRAW_WINDOW* window, void* p)
 	buff += offsetof(ADD_NEW_LAYER_HISTORY_DATA, layer_name);
 	data.layer_name = (char*)buff;
 
-	delete_layer = SearchLayer(window->layer, data.layer_name);
+	delete_layer = SearchLayerByIDAndName(window, data.layer_id, data.layer_name);
 	if(delete_layer == window->active_layer)
 	{
 		LAYER *new_active = (delete_layer->prev == NULL)
@@ -1102,6 +1121,7 @@ static void AddNewLayerRedo(DRAW_WINDOW* window, void* p)
 		data.x, data.y, data.width, data.height, data.channel,
 		data.layer_type, prev, next, data.layer_name, window
 	);
+	AssignLayerID(new_layer, data.layer_id);
 
 	window->num_layer++;
 	LayerViewAddLayer(new_layer, window->layer,
@@ -1124,6 +1144,7 @@ void AddNewLayerHistory(
 	data.x = new_layer->x, data.y = new_layer->y;
 	data.width = new_layer->width, data.height = new_layer->height;
 	data.channel = new_layer->channel;
+	data.layer_id = new_layer->id;
 	data.name_length = (uint16)strlen(new_layer->name) + 1;
 	if(new_layer->prev == NULL)
 	{
@@ -1232,6 +1253,7 @@ static void AddNewLayerWithImageRedo(DRAW_WINDOW* window, void* p)
 		data.x, data.y, data.width, data.height, data.channel,
 		data.layer_type, prev, next, data.layer_name, window
 	);
+	AssignLayerID(new_layer, data.layer_id);
 
 	// 摜f[^WJ
 	buff += data.prev_name_length;
@@ -1298,6 +1320,7 @@ void AddNewLayerWithImageHistory(
 	data.layer_history.x = new_layer->x, data.layer_history.y = new_layer->y;
 	data.layer_history.width = new_layer->width, data.layer_history.height = new_layer->height;
 	data.layer_history.channel = new_layer->channel;
+	data.layer_history.layer_id = new_layer->id;
 	data.layer_history.name_length = (uint16)strlen(new_layer->name) + 1;
 
 	// sNZf[^k
@@ -1612,7 +1635,7 @@ void ChangeActiveLayer(DRAW_WINDOW* window, LAYER* layer)
 	// ԏ̃C[ȂȂuֈړv@\OFF
 	gtk_widget_set_sensitive(window->app->layer_window.layer_control.up, layer->next != NULL);
 
-	(void)memset(window->work_layer->pixels, 0, window->pixel_buf_size);
+	ClearWorkLayer(window);
 
 	window->active_layer = layer;
 	window->active_layer_set = layer->layer_set;
@@ -1854,6 +1877,12 @@ void AddLayerMergeDownHistory(
 *******************************/
 void LayerMergeDown(LAYER* target)
 {
+	// ̃C[̃sNZf[^ύX
+	if(target->prev != NULL)
+	{
+		UpdateLayerContentGeneration(target->prev);
+	}
+
 	if(target->layer_type == TYPE_NORMAL_LAYER)
 	{
 		switch(target->layer_mode)
@@ -2437,7 +2466,7 @@ void RasterizeLayer(LAYER* target)
 		target->window->app->tool_window.brush_table);
 	gtk_widget_show_all(target->window->app->tool_window.brush_table);
 
-	(void)memset(target->window->work_layer->pixels, 0, target->window->pixel_buf_size);
+	ClearWorkLayer(target->window);
 }
 
 /*****************************
@@ -2971,6 +3000,140 @@ void GetAverageColor(LAYER* target, int x, int y, int size, uint8 color[4])
 	color[3] = (uint8)(sum_color[3] / count);
 }
 
+/**********************************************
+* CreateLayerSumTable֐                     *
+* ϐF擾p̗ݐϘae[u쐬      *
+* (쐬ɃC[蒼)    *
+*                                         *
+* target	: F擾郌C[            *
+* Ԃl                                      *
+*	ݐϘae[u(s̏ꍇNULL)    *
+**********************************************/
+LAYER_SUM_TABLE* CreateLayerSumTable(LAYER* target)
+{
+	LAYER_SUM_TABLE *ret;
+	const int row_size = (target->width + 1) * 4;
+	uint32 row_sum[4];
+	uint32 *prev_row, *row;
+	uint8 *ref;
+	int x, y;
+
+	if((ret = (LAYER_SUM_TABLE*)MEM_ALLOC_FUNC(sizeof(*ret))) == NULL)
+	{
+		return NULL;
+	}
+	ret->sums = (uint32*)MEM_ALLOC_FUNC(
+		(size_t)row_size * (target->height + 1) * sizeof(*ret->sums));
+	if(ret->sums == NULL)
+	{
+		MEM_FREE_FUNC(ret);
+		return NULL;
+	}
+	ret->width = target->width;
+	ret->height = target->height;
+
+	// 0sڂ0ڂ͏0
+	(void)memset(ret->sums, 0, row_size * sizeof(*ret->sums));
+	for(y=0; y<target->height; y++)
+	{
+		ref = &target->pixels[y*target->stride];
+		prev_row = &ret->sums[y*row_size];
+		row = &ret->sums[(y+1)*row_size];
+		row[0] = row[1] = row[2] = row[3] = 0;
+		row_sum[0] = row_sum[1] = row_sum[2] = row_sum[3] = 0;
+		for(x=0; x<target->width; x++, ref+=4)
+		{
+			row_sum[0] += ref[0] * ref[3];
+			row_sum[1] += ref[1] * ref[3];
+			row_sum[2] += ref[2] * ref[3];
+			row_sum[3] += ref[3];
+			row[(x+1)*4+0] = prev_row[(x+1)*4+0] + row_sum[0];
+			row[(x+1)*4+1] = prev_row[(x+1)*4+1] + row_sum[1];
+			row[(x+1)*4+2] = prev_row[(x+1)*4+2] + row_sum[2];
+			row[(x+1)*4+3] = prev_row[(x+1)*4+3] + row_sum[3];
+		}
+	}
+
+	return ret;
+}
+
+/***********************************************
+* DeleteLayerSumTable֐                      *
+* ϐF擾p̗ݐϘae[u폜       *
+*                                          *
+* table	: 폜e[ũ|C^̃AhX *
+***********************************************/
+void DeleteLayerSumTable(LAYER_SUM_TABLE** table)
+{
+	if(*table == NULL)
+	{
+		return;
+	}
+
+	MEM_FREE_FUNC((*table)->sums);
+	MEM_FREE_FUNC(*table);
+	*table = NULL;
+}
+
+/***************************************************
+* GetAverageColorWithSumTable֐                  *
+* ݐϘae[ugĎwWӂ̕ϐF擾 *
+* (ʂGetAverageColorƓ)                    *
+*                                              *
+* table	: ݐϘae[u                           *
+* x		: XW                                    *
+* y		: YW                                    *
+* size	: F擾͈                         *
+* color	: 擾Fi[(4oCg)              *
+***************************************************/
+void GetAverageColorWithSumTable(LAYER_SUM_TABLE* table, int x, int y, int size, uint8 color[4])
+{
+	const int row_size = (table->width + 1) * 4;
+	uint32 sum_color[4];
+	uint32 *top, *bottom;
+	int start_x, start_y;
+	int width, height;
+	int count;
+	int i;
+
+	// ͈͂̌ߕGetAverageColorƍ킹
+	start_x = x - size,	start_y = y - size;
+	width = height = size * 2 + 1;
+
+	if(start_x < 0)
+	{
+		start_x = 0;
+	}
+	if(start_x + width > table->width)
+	{
+		width = table->width - start_x;
+	}
+
+	if(start_y < 0)
+	{
+		start_y = 0;
+	}
+	if(start_y + height > table->height)
+	{
+		height = table->height - start_y;
+	}
+
+	top = &table->sums[start_y*row_size];
+	bottom = &table->sums[(start_y+height)*row_size];
+	for(i=0; i<4; i++)
+	{	// 2^32@ƂȂ̂Œڑ킹lƈv
+		sum_color[i] = bottom[(start_x+width)*4+i] - bottom[start_x*4+i]
+			- top[(start_x+width)*4+i] + top[start_x*4+i];
+	}
+	sum_color[3]++;
+	count = width * height;
+
+	color[0] = (uint8)(sum_color[0] / sum_color[3]);
+	color[1] = (uint8)(sum_color[1] / sum_color[3]);
+	color[2] = (uint8)(sum_color[2] / sum_color[3]);
+	color[3] = (uint8)(sum_color[3] / count);
+}
+
 /***************************************************
 * GetBlendedUnderLayer֐                         *
 * Ώۂ艺̃C[C[擾 *
@@ -3004,6 +3167,144 @@ LAYER* GetBlendedUnderLayer(LAYER* target, DRAW_WINDOW* window, int use_back_gro
 	return ret;
 }
 
+/*****************************************************************
+* IsLayerContentEditing֐                                      *
+* C[̃sNZf[^ҏWł\邩𔻒肷 *
+*                                                            *
+* layer	: 肷郌C[                                       *
+* Ԃl                                                         *
+*	ҏW̉\TRUE                                   *
+*****************************************************************/
+static int IsLayerContentEditing(LAYER* layer)
+{
+	DRAW_WINDOW *window = layer->window;
+
+	// Ɨp̃C[AC[r[ɖ̂͑ΏۊO
+	if(layer->widget == NULL || window == NULL || layer->channel != 4)
+	{
+		return TRUE;
+	}
+
+	// C[Zbg͎qC[̍Ŗω
+	if(layer->layer_type == TYPE_LAYER_SET || layer->layer_type == TYPE_3D_LAYER)
+	{
+		return TRUE;
+	}
+
+	// ANeBuC[̓uVŕ`撆̉\
+		// (ȊÕC[͏񂾉ӏUpdateLayerContentGenerationĂ)
+	if(layer == window->active_layer)
+	{
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/*********************************************
+* CalcLayerContentBounds֐                 *
+* C[̕sȕ܂ދ`vZ *
+*                                        *
+* layer	: vZ郌C[                   *
+*********************************************/
+static void CalcLayerContentBounds(LAYER* layer)
+{
+	CalcPixelsContentBounds(layer->pixels, layer->width, layer->height, layer->stride,
+		&layer->content_x, &layer->content_y, &layer->content_width, &layer->content_height);
+
+	layer->content_bounds_valid = TRUE;
+}
+
+/********************************************************************
+* GetLayerContentBounds֐                                         *
+* C[̕sȕ܂ދ`擾                        *
+*                                                               *
+* layer	: ׂ郌C[                                            *
+* x		: `̍XWi[AhX                       *
+* y		: `̍YWi[AhX                       *
+* width	: `̕i[AhX(sȕ0)       *
+* height	: `̍i[AhX(sȕ0) *
+* Ԃl                                                            *
+*	`𗘗płTRUE(ҏW̃C[FALSE)               *
+********************************************************************/
+int GetLayerContentBounds(LAYER* layer, int* x, int* y, int* width, int* height)
+{
+	if(IsLayerContentEditing(layer) != FALSE)
+	{
+		layer->content_bounds_valid = FALSE;
+		return FALSE;
+	}
+
+	if(layer->content_bounds_valid == FALSE)
+	{
+		CalcLayerContentBounds(layer);
+	}
+
+	*x = layer->content_x;
+	*y = layer->content_y;
+	*width = layer->content_width;
+	*height = layer->content_height;
+
+	return TRUE;
+}
+
+/***************************************************
+* ClearLayerContentBounds֐                      *
+* SẴC[̕sȕ܂ދ`j *
+* (SẴC[̍XVԍi߂)               *
+*                                              *
+* window	: `̈̏                       *
+***************************************************/
+void ClearLayerContentBounds(DRAW_WINDOW* window)
+{
+	LAYER *layer = window->layer;
+
+	while(layer != NULL)
+	{
+		UpdateLayerContentGeneration(layer);
+		layer = layer->next;
+	}
+}
+
+/*********************************************************
+* CheckLayerContentBounds֐                            *
+* ANeBuC[̕sȕ܂ދ`j   *
+* (uV̕`͈MɋL^ȂߍXVԍi߂) *
+*                                                    *
+* window	: `̈̏                             *
+*********************************************************/
+void CheckLayerContentBounds(DRAW_WINDOW* window)
+{
+	// ANeBuC[͏㉺̃C[̃LbV
+		// ԂɊ܂܂Ȃ̂Ŗi߂Ăč͋NȂ
+	if(window->active_layer != NULL)
+	{
+		window->active_layer->content_bounds_valid = FALSE;
+		UpdateLayerContentGeneration(window->active_layer);
+	}
+}
+
+/*****************************************************
+* UpdateLayerContentGeneration֐                   *
+* C[̃sNZf[^ύXꂽƂL^ *
+* (sȕ܂ދ`j)                 *
+*                                                *
+* layer	: sNZf[^ύXC[           *
+*****************************************************/
+void UpdateLayerContentGeneration(LAYER* layer)
+{
+	layer->content_bounds_valid = FALSE;
+
+
+	// `̈ŜňӂȒlɂ
+		// 폜ꂽC[ƓAhX̃C[Ƃʂ
+	if(layer->window != NULL)
+	{
+		layer->window->last_content_generation++;
+		layer->content_generation = layer->window->last_content_generation;
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
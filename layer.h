@@ -19,6 +19,10 @@ extern "C" {
 
 #define LAYER_CHAIN_BUFFER_SIZE 1024
 #define MAX_LAYER_EXTRA_DATA_NUM 8
+// C[IDۑǉ̖O
+#define LAYER_ID_EXTRA_DATA_NAME "LAYER_ID"
+// ID烌C[TnbVe[ȕTCY
+#define LAYER_ID_TABLE_SIZE 256
 
 typedef enum _eLAYER_FLAGS
 {
@@ -89,6 +93,7 @@ typedef struct _LAYER
 {
 	uint8 *pixels;			// sNZf[^
 	gchar* name;			// C[
+	uint32 id;				// `̈ňӂID(0Ȃ疢o^)
 	uint16 layer_type;		// C[^Cv(m[}AxNgAeLXg)
 	uint16 layer_mode;		// C[̍[h
 	int32 x, y;				// C[̍W
@@ -129,6 +134,13 @@ typedef struct _LAYER
 	void *modeling_data;
 	size_t modeling_data_size;
 
+	// sȕ܂ދ`
+	int content_x, content_y, content_width, content_height;
+	// sȕ܂ދ`vZς݂ǂ
+	int content_bounds_valid;
+	// sNZf[^̍XVԍ(C[Zbg̃LbVp)
+	unsigned int content_generation;
+
 	// `̈ւ̃|C^
 	struct _DRAW_WINDOW *window;
 } LAYER;
@@ -159,6 +171,19 @@ typedef struct _RGBA_DATA
 	uint8 r, g, b, a;
 } RGBA_DATA;
 
+/****************************************
+* LAYER_SUM_TABLE\                 *
+* C[̕ϐFɋ߂邽߂  *
+* sNZl̗ݐϘa(Summed Area Table) *
+****************************************/
+typedef struct _LAYER_SUM_TABLE
+{
+	// (+1)~(+1)~4`l̗ݐϘa
+		// (R~A, G~A, B~A, A ̏AI[o[t[GetAverageColorƓ2^32ŏ)
+	uint32 *sums;
+	int width, height;	// C[̕ƍ
+} LAYER_SUM_TABLE;
+
 // ֐̃vg^Cv錾
 EXTERN LAYER* CreateLayer(
 	int32 x,
@@ -303,6 +328,48 @@ EXTERN void ChangeLayerOrder(LAYER* change_layer, LAYER* new_prev, LAYER** botto
 
 EXTERN LAYER* SearchLayer(LAYER* bottom_layer, const gchar* name);
 
+/***************************************
+* UnregisterLayerID֐                *
+* C[ID\O         *
+*                                  *
+* layer	: IDOC[             *
+***************************************/
+EXTERN void UnregisterLayerID(LAYER* layer);
+
+/******************************************************************
+* AssignLayerID֐                                               *
+* C[ɕ`̈ňӂID蓖Ă                      *
+* ID烌C[T\ɓo^                            *
+*                                                             *
+* layer	: ID蓖Ă郌C[                                  *
+* id		: 蓖ĂID(0܂͎gpς݂ȂVID𔭍s) *
+******************************************************************/
+EXTERN void AssignLayerID(LAYER* layer, uint32 id);
+
+/*************************************
+* SearchLayerByID֐                *
+* ID烌C[T               *
+*                                *
+* window	: `̈̏         *
+* id		: C[ID           *
+* Ԃl                             *
+*	C[(NULL) *
+*************************************/
+EXTERN LAYER* SearchLayerByID(struct _DRAW_WINDOW* window, uint32 id);
+
+/*****************************************************
+* SearchLayerByIDAndName֐                         *
+* IDŃC[TAȂΖOŒT     *
+* (IDȂÂf[^蒼C[p) *
+*                                                *
+* window	: `̈̏                         *
+* id		: C[ID(0Ȃ疼OŒT)          *
+* name	: C[̖O                             *
+* Ԃl                                             *
+*	C[(NULL)                 *
+*****************************************************/
+EXTERN LAYER* SearchLayerByIDAndName(struct _DRAW_WINDOW* window, uint32 id, const gchar* name);
+
 EXTERN int32 GetLayerID(const LAYER* bottom, const LAYER* prev, uint16 num_layer);
 
 /*********************************
@@ -403,6 +470,45 @@ EXTERN LAYER* CreateLayerCopy(LAYER* src);
 *************************************************/
 EXTERN LAYER** GetLayerChain(struct _DRAW_WINDOW* window, uint16* num_layer);
 
+/********************************************************************
+* GetLayerContentBounds֐                                         *
+* C[̕sȕ܂ދ`擾                        *
+*                                                               *
+* layer	: ׂ郌C[                                            *
+* x		: `̍XWi[AhX                       *
+* y		: `̍YWi[AhX                       *
+* width	: `̕i[AhX(sȕ0)       *
+* height	: `̍i[AhX(sȕ0) *
+* Ԃl                                                            *
+*	`𗘗płTRUE(ҏW̃C[FALSE)               *
+********************************************************************/
+EXTERN int GetLayerContentBounds(LAYER* layer, int* x, int* y, int* width, int* height);
+
+/***************************************************
+* ClearLayerContentBounds֐                      *
+* SẴC[̕sȕ܂ދ`j *
+*                                              *
+* window	: `̈̏                       *
+***************************************************/
+EXTERN void ClearLayerContentBounds(struct _DRAW_WINDOW* window);
+
+/*******************************************************
+* CheckLayerContentBounds֐                          *
+* ANeBuC[̕sȕ܂ދ`j *
+*                                                  *
+* window	: `̈̏                           *
+*******************************************************/
+EXTERN void CheckLayerContentBounds(struct _DRAW_WINDOW* window);
+
+/*****************************************************
+* UpdateLayerContentGeneration֐                   *
+* C[̃sNZf[^ύXꂽƂL^ *
+* (sȕ܂ދ`j)                 *
+*                                                *
+* layer	: sNZf[^ύXC[           *
+*****************************************************/
+EXTERN void UpdateLayerContentGeneration(LAYER* layer);
+
 /***************************************************
 * LayerSetShowChildren֐                         *
 * C[Zbg̎qC[\             *
@@ -515,6 +621,38 @@ EXTERN void FillTextureLayer(LAYER* layer, TEXTURES* textures);
 ******************************************/
 EXTERN void GetAverageColor(LAYER* target, int x, int y, int size, uint8 color[4]);
 
+/**********************************************
+* CreateLayerSumTable֐                     *
+* ϐF擾p̗ݐϘae[u쐬      *
+* (쐬ɃC[蒼)    *
+*                                         *
+* target	: F擾郌C[            *
+* Ԃl                                      *
+*	ݐϘae[u(s̏ꍇNULL)    *
+**********************************************/
+EXTERN LAYER_SUM_TABLE* CreateLayerSumTable(LAYER* target);
+
+/***********************************************
+* DeleteLayerSumTable֐                      *
+* ϐF擾p̗ݐϘae[u폜       *
+*                                          *
+* table	: 폜e[ũ|C^̃AhX *
+***********************************************/
+EXTERN void DeleteLayerSumTable(LAYER_SUM_TABLE** table);
+
+/***************************************************
+* GetAverageColorWithSumTable֐                  *
+* ݐϘae[ugĎwWӂ̕ϐF擾 *
+* (ʂGetAverageColorƓ)                    *
+*                                              *
+* table	: ݐϘae[u                           *
+* x		: XW                                    *
+* y		: YW                                    *
+* size	: F擾͈                         *
+* color	: 擾Fi[(4oCg)              *
+***************************************************/
+EXTERN void GetAverageColorWithSumTable(LAYER_SUM_TABLE* table, int x, int y, int size, uint8 color[4]);
+
 #ifdef __cplusplus
 }
 #endif
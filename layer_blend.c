@@ -1,38 +1,117 @@
 #include <string.h>
+#include <math.h>
 #include "layer.h"
 #include "memory.h"
 #include "draw_window.h"
+#include "layer_blend_native.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*************************************************************************
+* GetClippingMaskSource֐                                              *
+* ̃C[ŃNbsOۂ̃}XŇf[^擾           *
+* }XNANeBuC[ȂƃC[LbVg *
+*                                                                    *
+* src		: NbsO郌C[                                   *
+* update	: XV͈̔(ŜꍇNULL)                   *
+* Ԃl                                                                 *
+*	}XŇf[^C[                                       *
+*************************************************************************/
+static LAYER* GetClippingMaskSource(LAYER* src, UPDATE_RECTANGLE* update)
+{
+	DRAW_WINDOW *window = src->window;
+	LAYER *mask_source = src->prev;
+	LAYER *cache = window->mask_source;
+
+	while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
+	{
+		mask_source = mask_source->prev;
+	}
+	if(mask_source != window->active_layer)
+	{
+		return mask_source;
+	}
+
+	if((window->flags & DRAW_WINDOW_MASK_SOURCE_CACHED) == 0
+		|| window->mask_source_layer != mask_source)
+	{	// LbVȂŜ蒼
+		(void)memcpy(cache->pixels, mask_source->pixels,
+			mask_source->stride*mask_source->height);
+		cairo_set_operator(cache->cairo_p, CAIRO_OPERATOR_OVER);
+		cairo_set_source_surface(cache->cairo_p, window->work_layer->surface_p, 0, 0);
+		cairo_paint(cache->cairo_p);
+
+		window->mask_source_layer = mask_source;
+		window->flags |= DRAW_WINDOW_MASK_SOURCE_CACHED;
+		if(update != NULL)
+		{
+			window->flags |= DRAW_WINDOW_MASK_SOURCE_UPDATED;
+		}
+	}
+	else if(update != NULL && (window->flags & DRAW_WINDOW_MASK_SOURCE_UPDATED) == 0)
+	{	// XVȂXV͈͂̂ݍ蒼
+			// (XV͈͂̑̃NbsOC[͍蒼ʂg)
+		int start_x = (int)floor(update->x), start_y = (int)floor(update->y);
+		int end_x = (int)ceil(update->x + update->width);
+		int end_y = (int)ceil(update->y + update->height);
+		int i;
+
+		if(start_x < 0)
+		{
+			start_x = 0;
+		}
+		if(start_y < 0)
+		{
+			start_y = 0;
+		}
+		if(end_x > cache->width)
+		{
+			end_x = cache->width;
+		}
+		if(end_y > cache->height)
+		{
+			end_y = cache->height;
+		}
+		if(end_x <= start_x || end_y <= start_y)
+		{
+			return cache;
+		}
+
+		for(i=start_y; i<end_y; i++)
+		{
+			(void)memcpy(&cache->pixels[i*cache->stride+start_x*4],
+				&mask_source->pixels[i*mask_source->stride+start_x*4], (end_x - start_x) * 4);
+		}
+
+		cairo_save(cache->cairo_p);
+		cairo_rectangle(cache->cairo_p, start_x, start_y, end_x - start_x, end_y - start_y);
+		cairo_clip(cache->cairo_p);
+		cairo_set_operator(cache->cairo_p, CAIRO_OPERATOR_OVER);
+		cairo_set_source_surface(cache->cairo_p, window->work_layer->surface_p, 0, 0);
+		cairo_paint(cache->cairo_p);
+		cairo_restore(cache->cairo_p);
+
+		window->flags |= DRAW_WINDOW_MASK_SOURCE_UPDATED;
+	}
+
+	return cache;
+}
+
 void BlendNormal_c(LAYER* src, LAYER* dst)
 {
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_OVER);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -78,27 +157,14 @@ void BlendAdd_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_ADD);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -115,27 +181,14 @@ void BlendMultiply_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_MULTIPLY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -152,27 +205,14 @@ void BlendScreen_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_SCREEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -189,27 +229,14 @@ void BlendOverLay_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_OVERLAY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -225,27 +252,14 @@ void BlendLighten_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_LIGHTEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -262,27 +276,14 @@ void BlendDarken_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_DARKEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -299,27 +300,14 @@ void BlendDodge_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_COLOR_DODGE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -336,27 +324,14 @@ void BlendBurn_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_COLOR_BURN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -373,27 +348,14 @@ void BlendHardLight_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_HARD_LIGHT);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -410,27 +372,14 @@ void BlendSoftLight_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_SOFT_LIGHT);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -447,27 +396,14 @@ void BlendDifference_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_DIFFERENCE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -484,27 +420,14 @@ void BlendExclusion_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_EXCLUSION);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -521,27 +444,14 @@ void BlendHslHue_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_HSL_HUE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -558,27 +468,14 @@ void BlendHslSaturation_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_HSL_SATURATION);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -595,27 +492,14 @@ void BlendHslColor_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_HSL_COLOR);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -632,27 +516,14 @@ void BlendHslLuminosity_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_HSL_LUMINOSITY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -672,7 +543,7 @@ void BlendBinalize_c(LAYER* src, LAYER* dst)
 
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		for(i=0; i<src->width * src->height; i++)
@@ -699,20 +570,7 @@ void BlendBinalize_c(LAYER* src, LAYER* dst)
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -794,27 +652,14 @@ void BlendSource_c(LAYER* src, LAYER* dst)
 	cairo_set_operator(dst->cairo_p, CAIRO_OPERATOR_SOURCE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
 		cairo_set_operator(src->window->mask->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(src->window->mask->cairo_p, src->surface_p,
 			src->x, src->y);
 		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(src->window->mask_temp->cairo_p, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(src->window->mask_temp->cairo_p,
-				src->window->work_layer->surface_p, 0, 0);
-			cairo_paint(src->window->mask_temp->cairo_p);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, NULL);
 
 		cairo_set_source_surface(dst->cairo_p, src->window->mask->surface_p, 0, 0);
 		cairo_mask_surface(dst->cairo_p, mask_source->surface_p, 0, 0);
@@ -874,6 +719,104 @@ void BlendSourceOver_c(LAYER* src, LAYER* dst)
 	*/
 }
 
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+
+/**********************************************************************
+* IsBlendTargetClipped֐                                            *
+* cairoReLXgɃNbsOݒ肳Ă邩𔻒肷 *
+*                                                                 *
+* cairo_p	: cairoReLXg                               *
+* width	: ̕                                                  *
+* height	: ̍                                            *
+* Ԃl                                                              *
+*	̈ꕔ݂̂ɐĂTRUE                            *
+**********************************************************************/
+static int IsBlendTargetClipped(cairo_t* cairo_p, int width, int height)
+{
+	double x1, y1, x2, y2;
+
+	cairo_clip_extents(cairo_p, &x1, &y1, &x2, &y2);
+
+	return x1 > 0 || y1 > 0 || x2 < width || y2 < height;
+}
+
+/*******************************************
+* NativeBlendLayer֐                     *
+* lCeBu̍ŃC[ *
+*                                      *
+* src			: ̃C[         *
+* dst			: ̃C[         *
+* blend_mode	: [h               *
+*******************************************/
+static void NativeBlendLayer(LAYER* src, LAYER* dst, int blend_mode)
+{
+	// ͈
+	int start_x = MAXIMUM(src->x, 0);
+	int start_y = MAXIMUM(src->y, 0);
+	int end_x = MINIMUM(src->x + src->width, dst->width);
+	int end_y = MINIMUM(src->y + src->height, dst->height);
+	// C[̕sȕ
+	int bounds_x, bounds_y, bounds_width, bounds_height;
+
+	// ȕĂωȂ̂ŕsȕ̂ݍ
+	if(GetLayerContentBounds(src, &bounds_x, &bounds_y, &bounds_width, &bounds_height) != FALSE)
+	{
+		start_x = MAXIMUM(start_x, src->x + bounds_x);
+		start_y = MAXIMUM(start_y, src->y + bounds_y);
+		end_x = MINIMUM(end_x, src->x + bounds_x + bounds_width);
+		end_y = MINIMUM(end_y, src->y + bounds_y + bounds_height);
+	}
+
+	if(end_x <= start_x || end_y <= start_y)
+	{
+		return;
+	}
+
+	NativeBlendPixels(&dst->pixels[start_y*dst->stride + start_x*4], dst->stride,
+		&src->pixels[(start_y-src->y)*src->stride + (start_x-src->x)*4], src->stride,
+		end_x - start_x, end_y - start_y, (src->alpha * 255 + 50) / 100,
+		GetNativeBlendFunction(blend_mode)
+	);
+}
+
+// ̃C[Ń}XLOꍇƍɃNbsOݒ肳Ăꍇ
+	// cairoł̍g
+#define NATIVE_BLEND_FUNCTION(NAME, MODE) \
+static void Blend##NAME##_native(LAYER* src, LAYER* dst) \
+{ \
+	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0 \
+		|| IsBlendTargetClipped(dst->cairo_p, dst->width, dst->height) != FALSE) \
+	{ \
+		Blend##NAME##_c(src, dst); \
+	} \
+	else \
+	{ \
+		NativeBlendLayer(src, dst, (MODE)); \
+	} \
+}
+
+NATIVE_BLEND_FUNCTION(Normal, LAYER_BLEND_NORMAL)
+NATIVE_BLEND_FUNCTION(Add, LAYER_BLEND_ADD)
+NATIVE_BLEND_FUNCTION(Multiply, LAYER_BLEND_MULTIPLY)
+NATIVE_BLEND_FUNCTION(Screen, LAYER_BLEND_SCREEN)
+NATIVE_BLEND_FUNCTION(OverLay, LAYER_BLEND_OVERLAY)
+NATIVE_BLEND_FUNCTION(Lighten, LAYER_BLEND_LIGHTEN)
+NATIVE_BLEND_FUNCTION(Darken, LAYER_BLEND_DARKEN)
+NATIVE_BLEND_FUNCTION(Dodge, LAYER_BLEND_DODGE)
+NATIVE_BLEND_FUNCTION(Burn, LAYER_BLEND_BURN)
+NATIVE_BLEND_FUNCTION(HardLight, LAYER_BLEND_HARD_LIGHT)
+NATIVE_BLEND_FUNCTION(SoftLight, LAYER_BLEND_SOFT_LIGHT)
+NATIVE_BLEND_FUNCTION(Difference, LAYER_BLEND_DIFFERENCE)
+NATIVE_BLEND_FUNCTION(Exclusion, LAYER_BLEND_EXCLUSION)
+NATIVE_BLEND_FUNCTION(HslHue, LAYER_BLEND_HSL_HUE)
+NATIVE_BLEND_FUNCTION(HslSaturation, LAYER_BLEND_HSL_SATURATION)
+NATIVE_BLEND_FUNCTION(HslColor, LAYER_BLEND_HSL_COLOR)
+NATIVE_BLEND_FUNCTION(HslLuminosity, LAYER_BLEND_HSL_LUMINOSITY)
+NATIVE_BLEND_FUNCTION(AlphaMinus, LAYER_BLEND_ALPHA_MINUS)
+NATIVE_BLEND_FUNCTION(Atop, LAYER_BLEND_ATOP)
+
+#endif	// #if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+
 /*********************************************************
 * SetLayerBlendFunctions֐                             *
 * C[Ɏgp֐|C^z̒gݒ肷 *
@@ -908,6 +851,32 @@ void SetLayerBlendFunctions(void (*layer_blend_functions[])(LAYER* src, LAYER* d
 	layer_blend_functions[LAYER_BLEND_SOURCE_OVER] = BlendSourceOver_c;
 	//BlendOver_c
 	layer_blend_functions[LAYER_BLEND_OVER] = BlendNormal_c;
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+	// cairỏZqōĂ[h̓lCeBu̍ɒu
+		// (\[X͍͈̔͊O̍̂cairô܂)
+	InitializeNativeBlendFunctions();
+	layer_blend_functions[LAYER_BLEND_NORMAL] = BlendNormal_native;
+	layer_blend_functions[LAYER_BLEND_ADD] = BlendAdd_native;
+	layer_blend_functions[LAYER_BLEND_MULTIPLY] = BlendMultiply_native;
+	layer_blend_functions[LAYER_BLEND_SCREEN] = BlendScreen_native;
+	layer_blend_functions[LAYER_BLEND_OVERLAY] = BlendOverLay_native;
+	layer_blend_functions[LAYER_BLEND_LIGHTEN] = BlendLighten_native;
+	layer_blend_functions[LAYER_BLEND_DARKEN] = BlendDarken_native;
+	layer_blend_functions[LAYER_BLEND_DODGE] = BlendDodge_native;
+	layer_blend_functions[LAYER_BLEND_BURN] = BlendBurn_native;
+	layer_blend_functions[LAYER_BLEND_HARD_LIGHT] = BlendHardLight_native;
+	layer_blend_functions[LAYER_BLEND_SOFT_LIGHT] = BlendSoftLight_native;
+	layer_blend_functions[LAYER_BLEND_DIFFERENCE] = BlendDifference_native;
+	layer_blend_functions[LAYER_BLEND_EXCLUSION] = BlendExclusion_native;
+	layer_blend_functions[LAYER_BLEND_HSL_HUE] = BlendHslHue_native;
+	layer_blend_functions[LAYER_BLEND_HSL_SATURATION] = BlendHslSaturation_native;
+	layer_blend_functions[LAYER_BLEND_HSL_COLOR] = BlendHslColor_native;
+	layer_blend_functions[LAYER_BLEND_HSL_LUMINOSITY] = BlendHslLuminosity_native;
+	layer_blend_functions[LAYER_BLEND_ALPHA_MINUS] = BlendAlphaMinus_native;
+	layer_blend_functions[LAYER_BLEND_ATOP] = BlendAtop_native;
+	layer_blend_functions[LAYER_BLEND_OVER] = BlendNormal_native;
+#endif
 }
 
 static void PartBlendNormal_c(LAYER* src, UPDATE_RECTANGLE* update)
@@ -915,46 +884,24 @@ static void PartBlendNormal_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_OVER);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER *mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -970,46 +917,24 @@ static void PartBlendAdd_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_ADD);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1025,46 +950,24 @@ static void PartBlendMultiply_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_MULTIPLY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1080,46 +983,24 @@ static void PartBlendScreen_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_SCREEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1135,46 +1016,24 @@ static void PartBlendOverLay_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_OVERLAY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1190,46 +1049,24 @@ static void PartBlendLighten_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_LIGHTEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1245,46 +1082,24 @@ static void PartBlendDarken_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_DARKEN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1300,46 +1115,24 @@ static void PartBlendDodge_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_COLOR_DODGE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1355,46 +1148,24 @@ static void PartBlendBurn_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_COLOR_BURN);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1410,46 +1181,24 @@ static void PartBlendHardLight_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_HARD_LIGHT);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1465,46 +1214,24 @@ static void PartBlendSoftLight_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_SOFT_LIGHT);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1520,46 +1247,24 @@ static void PartBlendDifference_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_DIFFERENCE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1575,46 +1280,24 @@ static void PartBlendExclusion_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_EXCLUSION);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1630,46 +1313,24 @@ static void PartBlendHslHue_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_HSL_HUE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1685,46 +1346,24 @@ static void PartBlendHslSaturation_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_HSL_SATURATION);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1740,46 +1379,24 @@ static void PartBlendHslColor_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_HSL_COLOR);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1795,40 +1412,24 @@ static void PartBlendHslLuminosity_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_HSL_LUMINOSITY);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-			src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-		cairo_t *update_temp = cairo_create(temp_surface);
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
-		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
+		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
-		cairo_mask_surface(update->cairo_p, temp_surface, 0, 0);
+		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		cairo_surface_destroy(temp_surface);
-		cairo_destroy(update_temp);
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1888,16 +1489,15 @@ static void PartBlendBinalize_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_OVER);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER* mask_source;
 
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_surface_t *temp_surface = cairo_surface_create_for_rectangle(
-			src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-		cairo_t *update_temp = cairo_create(temp_surface);
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		for(i=0; i<height; i++)
 		{
@@ -1925,28 +1525,13 @@ static void PartBlendBinalize_c(LAYER* src, UPDATE_RECTANGLE* update)
 
 		cairo_set_source_surface(update_cairo, src->window->mask_temp->surface_p,
 			- update->x, - update->y);
-		cairo_paint_with_alpha(src->window->mask->cairo_p, src->alpha * (FLOAT_T)0.01);
+		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_source = src->window->mask_temp;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
-		cairo_mask_surface(update->cairo_p, temp_surface, 0, 0);
+		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		cairo_surface_destroy(temp_surface);
-		cairo_destroy(update_temp);
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -1999,46 +1584,24 @@ static void PartBlendSource_c(LAYER* src, UPDATE_RECTANGLE* update)
 	cairo_set_operator(update->cairo_p, CAIRO_OPERATOR_SOURCE);
 	if((src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
 	{
-		LAYER* mask_source = src->prev;
+		LAYER *mask_source;
 		cairo_surface_t *update_surface = cairo_surface_create_for_rectangle(
 			src->window->mask->surface_p, update->x, update->y, update->width, update->height);
-		cairo_surface_t *temp_surface = NULL, *mask_surface = update_surface;
 		cairo_t *update_cairo = cairo_create(update_surface);
-		cairo_t *update_temp;
 
-		(void)memset(src->window->mask->pixels, 0, src->stride*src->height);
+		// }XN͍XV͈͂̂݃NA
+		cairo_set_operator(update_cairo, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(update_cairo);
 		cairo_set_operator(update_cairo, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(update_cairo, src->surface_p,
 			- update->x, - update->y);
 		cairo_paint_with_alpha(update_cairo, src->alpha * (FLOAT_T)0.01);
 
-		while((mask_source->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0)
-		{
-			mask_source = mask_source->prev;
-		}
-		if(mask_source == src->window->active_layer)
-		{
-			mask_surface = temp_surface = cairo_surface_create_for_rectangle(
-				src->window->mask_temp->surface_p, update->x, update->y, update->width, update->height);
-			update_temp = cairo_create(temp_surface);
-			cairo_set_operator(update_temp, CAIRO_OPERATOR_OVER);
-			(void)memcpy(src->window->mask_temp->pixels, mask_source->pixels,
-				mask_source->stride*mask_source->height);
-			cairo_set_source_surface(update_temp,
-				src->window->work_layer->surface_p, - update->x, - update->y);
-			cairo_paint(update_temp);
-			mask_surface = temp_surface;
-		}
+		mask_source = GetClippingMaskSource(src, update);
 
 		cairo_set_source_surface(update->cairo_p, update_surface, 0, 0);
 		cairo_mask_surface(update->cairo_p, mask_source->surface_p, - update->x, - update->y);
 
-		if(temp_surface != NULL)
-		{
-			cairo_surface_destroy(temp_surface);
-			cairo_destroy(update_temp);
-		}
-
 		cairo_surface_destroy(update_surface);
 		cairo_destroy(update_cairo);
 	}
@@ -2058,6 +1621,90 @@ static void PartBlendAtop_c(LAYER* src, UPDATE_RECTANGLE* update)
 
 #define PartBlendSourceOver_c DummyPartBlend
 
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+
+/*********************************************
+* PartNativeBlendLayer֐                   *
+* lCeBu̍ōXV͈͂̂ݍ *
+*                                        *
+* src			: ̃C[           *
+* update		: XV͈͂̏             *
+* blend_mode	: [h                 *
+*********************************************/
+static void PartNativeBlendLayer(LAYER* src, UPDATE_RECTANGLE* update, int blend_mode)
+{
+	LAYER *target = update->target;
+	// ͈
+	int start_x = MAXIMUM((int)floor(update->x), 0);
+	int start_y = MAXIMUM((int)floor(update->y), 0);
+	int end_x = (int)ceil(update->x + update->width);
+	int end_y = (int)ceil(update->y + update->height);
+
+	// C[̕sȕ
+	int bounds_x, bounds_y, bounds_width, bounds_height;
+
+	end_x = MINIMUM(MINIMUM(end_x, target->width), src->width);
+	end_y = MINIMUM(MINIMUM(end_y, target->height), src->height);
+
+	// ȕĂωȂ̂ŕsȕ̂ݍ
+	if(GetLayerContentBounds(src, &bounds_x, &bounds_y, &bounds_width, &bounds_height) != FALSE)
+	{
+		start_x = MAXIMUM(start_x, bounds_x);
+		start_y = MAXIMUM(start_y, bounds_y);
+		end_x = MINIMUM(end_x, bounds_x + bounds_width);
+		end_y = MINIMUM(end_y, bounds_y + bounds_height);
+	}
+
+	if(end_x <= start_x || end_y <= start_y)
+	{
+		return;
+	}
+
+	NativeBlendPixels(&target->pixels[start_y*target->stride + start_x*4], target->stride,
+		&src->pixels[start_y*src->stride + start_x*4], src->stride,
+		end_x - start_x, end_y - start_y, (src->alpha * 255 + 50) / 100,
+		GetNativeBlendFunction(blend_mode)
+	);
+}
+
+// ̃C[sȏꍇÃC[Ń}XLOꍇ
+	// ɃNbsOݒ肳Ăꍇcairoł̍g
+#define PART_NATIVE_BLEND_FUNCTION(NAME, MODE) \
+static void PartBlend##NAME##_native(LAYER* src, UPDATE_RECTANGLE* update) \
+{ \
+	if(update->target == NULL || (src->flags & LAYER_MASKING_WITH_UNDER_LAYER) != 0 \
+		|| IsBlendTargetClipped(update->cairo_p, (int)update->width, (int)update->height) != FALSE) \
+	{ \
+		PartBlend##NAME##_c(src, update); \
+	} \
+	else \
+	{ \
+		PartNativeBlendLayer(src, update, (MODE)); \
+	} \
+}
+
+PART_NATIVE_BLEND_FUNCTION(Normal, LAYER_BLEND_NORMAL)
+PART_NATIVE_BLEND_FUNCTION(Add, LAYER_BLEND_ADD)
+PART_NATIVE_BLEND_FUNCTION(Multiply, LAYER_BLEND_MULTIPLY)
+PART_NATIVE_BLEND_FUNCTION(Screen, LAYER_BLEND_SCREEN)
+PART_NATIVE_BLEND_FUNCTION(OverLay, LAYER_BLEND_OVERLAY)
+PART_NATIVE_BLEND_FUNCTION(Lighten, LAYER_BLEND_LIGHTEN)
+PART_NATIVE_BLEND_FUNCTION(Darken, LAYER_BLEND_DARKEN)
+PART_NATIVE_BLEND_FUNCTION(Dodge, LAYER_BLEND_DODGE)
+PART_NATIVE_BLEND_FUNCTION(Burn, LAYER_BLEND_BURN)
+PART_NATIVE_BLEND_FUNCTION(HardLight, LAYER_BLEND_HARD_LIGHT)
+PART_NATIVE_BLEND_FUNCTION(SoftLight, LAYER_BLEND_SOFT_LIGHT)
+PART_NATIVE_BLEND_FUNCTION(Difference, LAYER_BLEND_DIFFERENCE)
+PART_NATIVE_BLEND_FUNCTION(Exclusion, LAYER_BLEND_EXCLUSION)
+PART_NATIVE_BLEND_FUNCTION(HslHue, LAYER_BLEND_HSL_HUE)
+PART_NATIVE_BLEND_FUNCTION(HslSaturation, LAYER_BLEND_HSL_SATURATION)
+PART_NATIVE_BLEND_FUNCTION(HslColor, LAYER_BLEND_HSL_COLOR)
+PART_NATIVE_BLEND_FUNCTION(HslLuminosity, LAYER_BLEND_HSL_LUMINOSITY)
+PART_NATIVE_BLEND_FUNCTION(AlphaMinus, LAYER_BLEND_ALPHA_MINUS)
+PART_NATIVE_BLEND_FUNCTION(Atop, LAYER_BLEND_ATOP)
+
+#endif	// #if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+
 /*************************************************************
 * SetPartLayerBlendFunctions֐                             *
 * uVgp̃C[֐|C^z̒gݒ肷 *
@@ -2092,6 +1739,32 @@ void SetPartLayerBlendFunctions(void (*layer_blend_functions[])(LAYER* src, UPDA
 	layer_blend_functions[LAYER_BLEND_SOURCE_OVER] = PartBlendSourceOver_c;
 	//BlendOver_c
 	layer_blend_functions[LAYER_BLEND_OVER] = PartBlendNormal_c;
+
+#if defined(USE_NATIVE_LAYER_BLEND) && USE_NATIVE_LAYER_BLEND != 0
+	// cairỏZqōĂ[h̓lCeBu̍ɒu
+		// (\[X͍͈̔͊O̍̂cairô܂)
+	InitializeNativeBlendFunctions();
+	layer_blend_functions[LAYER_BLEND_NORMAL] = PartBlendNormal_native;
+	layer_blend_functions[LAYER_BLEND_ADD] = PartBlendAdd_native;
+	layer_blend_functions[LAYER_BLEND_MULTIPLY] = PartBlendMultiply_native;
+	layer_blend_functions[LAYER_BLEND_SCREEN] = PartBlendScreen_native;
+	layer_blend_functions[LAYER_BLEND_OVERLAY] = PartBlendOverLay_native;
+	layer_blend_functions[LAYER_BLEND_LIGHTEN] = PartBlendLighten_native;
+	layer_blend_functions[LAYER_BLEND_DARKEN] = PartBlendDarken_native;
+	layer_blend_functions[LAYER_BLEND_DODGE] = PartBlendDodge_native;
+	layer_blend_functions[LAYER_BLEND_BURN] = PartBlendBurn_native;
+	layer_blend_functions[LAYER_BLEND_HARD_LIGHT] = PartBlendHardLight_native;
+	layer_blend_functions[LAYER_BLEND_SOFT_LIGHT] = PartBlendSoftLight_native;
+	layer_blend_functions[LAYER_BLEND_DIFFERENCE] = PartBlendDifference_native;
+	layer_blend_functions[LAYER_BLEND_EXCLUSION] = PartBlendExclusion_native;
+	layer_blend_functions[LAYER_BLEND_HSL_HUE] = PartBlendHslHue_native;
+	layer_blend_functions[LAYER_BLEND_HSL_SATURATION] = PartBlendHslSaturation_native;
+	layer_blend_functions[LAYER_BLEND_HSL_COLOR] = PartBlendHslColor_native;
+	layer_blend_functions[LAYER_BLEND_HSL_LUMINOSITY] = PartBlendHslLuminosity_native;
+	layer_blend_functions[LAYER_BLEND_ALPHA_MINUS] = PartBlendAlphaMinus_native;
+	layer_blend_functions[LAYER_BLEND_ATOP] = PartBlendAtop_native;
+	layer_blend_functions[LAYER_BLEND_OVER] = PartBlendNormal_native;
+#endif
 }
 
 /********************************************************************
@@ -0,0 +1,737 @@
+#include <string.h>
+#include <math.h>
+#include "configure.h"
+#include "types.h"
+#include "layer.h"
+#include "layer_blend_native.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+# include <emmintrin.h>
+# define NATIVE_BLEND_SSE2 1
+# define SSE2_FUNCTION
+# if _MSC_VER >= 1700
+#  include <immintrin.h>
+#  define NATIVE_BLEND_AVX2 1
+#  define AVX2_FUNCTION
+# endif
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+# include <cpuid.h>
+# include <immintrin.h>
+# define NATIVE_BLEND_SSE2 1
+# define NATIVE_BLEND_AVX2 1
+# define SSE2_FUNCTION __attribute__((target("sse2")))
+# define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 0`255*255̒l255Ŋ(ľܓ)
+#define DIV255(X) ((((X) + 128) + (((X) + 128) >> 8)) >> 8)
+
+// CPŮg߂̃T|[g
+typedef enum _eNATIVE_BLEND_CPU_FEATURE
+{
+	NATIVE_BLEND_CPU_SSE2 = 0x01,
+	NATIVE_BLEND_CPU_AVX2 = 0x02
+} eNATIVE_BLEND_CPU_FEATURE;
+
+// [h̍̊֐
+static NATIVE_BLEND_FUNC g_native_blend_functions[NUM_LAYER_BLEND_FUNCTIONS];
+// ̊֐ς݂ǂ
+static int g_native_blend_initialized = 0;
+
+/*************************************
+* LoadSourcePixel֐                *
+* ̃sNZɕsx| *
+*                                *
+* s			: l󂯎z       *
+* src		: ̃sNZ       *
+* opacity	: ̕sx       *
+*************************************/
+static INLINE void LoadSourcePixel(int s[4], const uint8* src, int opacity)
+{
+	if(opacity == 0xff)
+	{
+		s[0] = src[0],	s[1] = src[1],	s[2] = src[2],	s[3] = src[3];
+	}
+	else
+	{
+		s[0] = DIV255(src[0] * opacity);
+		s[1] = DIV255(src[1] * opacity);
+		s[2] = DIV255(src[2] * opacity);
+		s[3] = DIV255(src[3] * opacity);
+	}
+}
+
+static void NativeBlendNormal_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity)
+{
+	int s[4];
+	int inv_alpha;
+	int i;
+
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4)
+	{
+		LoadSourcePixel(s, src, opacity);
+		if(s[3] == 0)
+		{
+			continue;
+		}
+		inv_alpha = 0xff - s[3];
+		dst[0] = (uint8)(s[0] + DIV255(dst[0] * inv_alpha));
+		dst[1] = (uint8)(s[1] + DIV255(dst[1] * inv_alpha));
+		dst[2] = (uint8)(s[2] + DIV255(dst[2] * inv_alpha));
+		dst[3] = (uint8)(s[3] + DIV255(dst[3] * inv_alpha));
+	}
+}
+
+static void NativeBlendAdd_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity)
+{
+	int s[4];
+	int value;
+	int i, j;
+
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4)
+	{
+		LoadSourcePixel(s, src, opacity);
+		for(j=0; j<4; j++)
+		{
+			value = dst[j] + s[j];
+			dst[j] = (uint8)((value > 0xff) ? 0xff : value);
+		}
+	}
+}
+
+// \ȍ[h
+	//  = ~(1-) + ~(1-惿) + B(, )
+	// B255*255{lŌvZ
+#define SEPARABLE_BLEND_FUNCTION(NAME, BLEND) \
+static void NativeBlend##NAME##_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity) \
+{ \
+	int s[4]; \
+	int sa, da, sc, dc; \
+	int value; \
+	int i, j; \
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4) \
+	{ \
+		LoadSourcePixel(s, src, opacity); \
+		if(s[3] == 0) \
+		{ \
+			continue; \
+		} \
+		sa = s[3], da = dst[3]; \
+		for(j=0; j<3; j++) \
+		{ \
+			sc = s[j], dc = dst[j]; \
+			value = dc * (0xff - sa) + sc * (0xff - da) + (BLEND); \
+			value = DIV255(value); \
+			dst[j] = (uint8)((value < 0) ? 0 : ((value > 0xff) ? 0xff : value)); \
+		} \
+		dst[3] = (uint8)(sa + da - DIV255(sa * da)); \
+	} \
+}
+
+static INLINE int BlendDodgeValue(int sc, int dc, int sa, int da)
+{
+	if(dc == 0)
+	{
+		return 0;
+	}
+	if(sc * da + dc * sa >= sa * da || sa == sc)
+	{
+		return sa * da;
+	}
+	return sa * sa * dc / (sa - sc);
+}
+
+static INLINE int BlendBurnValue(int sc, int dc, int sa, int da)
+{
+	if(dc >= da)
+	{
+		return sa * da;
+	}
+	if(sa * (da - dc) >= sc * da || sc == 0)
+	{
+		return 0;
+	}
+	return sa * (da - sa * (da - dc) / sc);
+}
+
+static INLINE int BlendSoftLightValue(int sc, int dc, int sa, int da)
+{
+	FLOAT_T s = sc, d = dc, fsa = sa, fda = da;
+	FLOAT_T value;
+
+	if(2 * sc < sa)
+	{
+		if(da == 0)
+		{
+			value = d * fsa;
+		}
+		else
+		{
+			value = d * fsa - d * (fda - d) * (fsa - 2 * s) / fda;
+		}
+	}
+	else if(da == 0)
+	{
+		value = 0;
+	}
+	else if(4 * dc <= da)
+	{
+		value = d * fsa + (2 * s - fsa) * d * ((16 * d / fda - 12) * d / fda + 3);
+	}
+	else
+	{
+		value = d * fsa + (sqrt(d * fda) - d) * (2 * s - fsa);
+	}
+
+	return (int)(value + 0.5);
+}
+
+SEPARABLE_BLEND_FUNCTION(Multiply, sc * dc)
+SEPARABLE_BLEND_FUNCTION(Screen, sc * da + dc * sa - sc * dc)
+SEPARABLE_BLEND_FUNCTION(OverLay, (2 * dc < da) ? 2 * sc * dc : sa * da - 2 * (da - dc) * (sa - sc))
+SEPARABLE_BLEND_FUNCTION(Lighten, MAXIMUM(sc * da, dc * sa))
+SEPARABLE_BLEND_FUNCTION(Darken, MINIMUM(sc * da, dc * sa))
+SEPARABLE_BLEND_FUNCTION(Dodge, BlendDodgeValue(sc, dc, sa, da))
+SEPARABLE_BLEND_FUNCTION(Burn, BlendBurnValue(sc, dc, sa, da))
+SEPARABLE_BLEND_FUNCTION(HardLight, (2 * sc < sa) ? 2 * sc * dc : sa * da - 2 * (da - dc) * (sa - sc))
+SEPARABLE_BLEND_FUNCTION(SoftLight, BlendSoftLightValue(sc, dc, sa, da))
+SEPARABLE_BLEND_FUNCTION(Difference, (sc * da > dc * sa) ? sc * da - dc * sa : dc * sa - sc * da)
+SEPARABLE_BLEND_FUNCTION(Exclusion, sc * da + dc * sa - 2 * sc * dc)
+
+// HSLn̍[h
+	// `l̕тB, G, R
+#define HSL_LUMINOSITY(C) ((C)[2] * 0.3 + (C)[1] * 0.59 + (C)[0] * 0.11)
+#define HSL_SATURATION(C) (MAXIMUM(MAXIMUM((C)[0], (C)[1]), (C)[2]) - MINIMUM(MINIMUM((C)[0], (C)[1]), (C)[2]))
+
+static void SetHslLuminosity(FLOAT_T c[3], FLOAT_T alpha, FLOAT_T luminosity)
+{
+	FLOAT_T delta = luminosity - HSL_LUMINOSITY(c);
+	FLOAT_T min_value, max_value;
+	int i;
+
+	c[0] += delta,	c[1] += delta,	c[2] += delta;
+
+	luminosity = HSL_LUMINOSITY(c);
+	min_value = MINIMUM(MINIMUM(c[0], c[1]), c[2]);
+	max_value = MAXIMUM(MAXIMUM(c[0], c[1]), c[2]);
+
+	if(min_value < 0 && luminosity - min_value > 0)
+	{
+		for(i=0; i<3; i++)
+		{
+			c[i] = luminosity + (c[i] - luminosity) * luminosity / (luminosity - min_value);
+		}
+	}
+	if(max_value > alpha && max_value - luminosity > 0)
+	{
+		for(i=0; i<3; i++)
+		{
+			c[i] = luminosity + (c[i] - luminosity) * (alpha - luminosity) / (max_value - luminosity);
+		}
+	}
+}
+
+static void SetHslSaturation(FLOAT_T c[3], FLOAT_T saturation)
+{
+	int max_index, mid_index, min_index;
+
+	if(c[0] > c[1])
+	{
+		max_index = 0,	min_index = 1;
+	}
+	else
+	{
+		max_index = 1,	min_index = 0;
+	}
+	if(c[2] > c[max_index])
+	{
+		mid_index = max_index,	max_index = 2;
+	}
+	else if(c[2] < c[min_index])
+	{
+		mid_index = min_index,	min_index = 2;
+	}
+	else
+	{
+		mid_index = 2;
+	}
+
+	if(c[max_index] > c[min_index])
+	{
+		c[mid_index] = (c[mid_index] - c[min_index]) * saturation / (c[max_index] - c[min_index]);
+		c[max_index] = saturation;
+	}
+	else
+	{
+		c[mid_index] = c[max_index] = 0;
+	}
+	c[min_index] = 0;
+}
+
+#define HSL_BLEND_FUNCTION(NAME, BLEND) \
+static void NativeBlend##NAME##_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity) \
+{ \
+	int s[4]; \
+	FLOAT_T sc[3], dc[3], c[3]; \
+	FLOAT_T sa, da; \
+	FLOAT_T value; \
+	int i, j; \
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4) \
+	{ \
+		LoadSourcePixel(s, src, opacity); \
+		if(s[3] == 0) \
+		{ \
+			continue; \
+		} \
+		sa = s[3], da = dst[3]; \
+		for(j=0; j<3; j++) \
+		{ \
+			sc[j] = s[j],	dc[j] = dst[j]; \
+		} \
+		BLEND \
+		for(j=0; j<3; j++) \
+		{ \
+			value = (dc[j] * (0xff - sa) + sc[j] * (0xff - da) + c[j]) / 0xff; \
+			dst[j] = (uint8)((value < 0) ? 0 : ((value > 0xff) ? 0xff : value + 0.5)); \
+		} \
+		dst[3] = (uint8)(s[3] + dst[3] - DIV255(s[3] * dst[3])); \
+	} \
+}
+
+HSL_BLEND_FUNCTION(HslHue,
+	c[0] = sc[0] * da;	c[1] = sc[1] * da;	c[2] = sc[2] * da;
+	SetHslSaturation(c, HSL_SATURATION(dc) * sa);
+	SetHslLuminosity(c, sa * da, HSL_LUMINOSITY(dc) * sa);
+)
+HSL_BLEND_FUNCTION(HslSaturation,
+	c[0] = dc[0] * sa;	c[1] = dc[1] * sa;	c[2] = dc[2] * sa;
+	SetHslSaturation(c, HSL_SATURATION(sc) * da);
+	SetHslLuminosity(c, sa * da, HSL_LUMINOSITY(dc) * sa);
+)
+HSL_BLEND_FUNCTION(HslColor,
+	c[0] = sc[0] * da;	c[1] = sc[1] * da;	c[2] = sc[2] * da;
+	SetHslLuminosity(c, sa * da, HSL_LUMINOSITY(dc) * sa);
+)
+HSL_BLEND_FUNCTION(HslLuminosity,
+	c[0] = dc[0] * sa;	c[1] = dc[1] * sa;	c[2] = dc[2] * sa;
+	SetHslLuminosity(c, sa * da, HSL_LUMINOSITY(sc) * da);
+)
+
+static void NativeBlendAlphaMinus_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity)
+{
+	int inv_alpha;
+	int i;
+
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4)
+	{
+		inv_alpha = 0xff - ((opacity == 0xff) ? src[3] : DIV255(src[3] * opacity));
+		dst[0] = (uint8)DIV255(dst[0] * inv_alpha);
+		dst[1] = (uint8)DIV255(dst[1] * inv_alpha);
+		dst[2] = (uint8)DIV255(dst[2] * inv_alpha);
+		dst[3] = (uint8)DIV255(dst[3] * inv_alpha);
+	}
+}
+
+static void NativeBlendSource_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity)
+{
+	int inv_opacity = 0xff - opacity;
+	int i;
+
+	if(opacity == 0xff)
+	{
+		(void)memcpy(dst, src, num_pixels * 4);
+		return;
+	}
+
+	// sxōƐ`Ԃ
+	for(i=0; i<num_pixels*4; i++)
+	{
+		dst[i] = (uint8)DIV255(src[i] * opacity + dst[i] * inv_opacity);
+	}
+}
+
+static void NativeBlendAtop_scalar(uint8* dst, const uint8* src, int num_pixels, int opacity)
+{
+	int s[4];
+	int inv_alpha;
+	int i;
+
+	for(i=0; i<num_pixels; i++, dst+=4, src+=4)
+	{
+		LoadSourcePixel(s, src, opacity);
+		inv_alpha = 0xff - s[3];
+		dst[0] = (uint8)DIV255(s[0] * dst[3] + dst[0] * inv_alpha);
+		dst[1] = (uint8)DIV255(s[1] * dst[3] + dst[1] * inv_alpha);
+		dst[2] = (uint8)DIV255(s[2] * dst[3] + dst[2] * inv_alpha);
+	}
+}
+
+#if defined(NATIVE_BLEND_SSE2) && NATIVE_BLEND_SSE2 != 0
+
+// SSE2
+	// 16rbgɓWJ4sNZA[̃sNZ̓XJ[łō
+#define SSE2_DIV255(X) _mm_mulhi_epu16(_mm_add_epi16((X), _mm_set1_epi16(128)), _mm_set1_epi16(257))
+#define SSE2_ALPHA(X) _mm_shufflehi_epi16(_mm_shufflelo_epi16((X), _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3))
+
+#define SSE2_BLEND_FUNCTION(NAME, BLEND) \
+static SSE2_FUNCTION void NativeBlend##NAME##_sse2(uint8* dst, const uint8* src, int num_pixels, int opacity) \
+{ \
+	const __m128i zero = _mm_setzero_si128(); \
+	const __m128i max_value = _mm_set1_epi16(0xff); \
+	const __m128i op = _mm_set1_epi16((short)opacity); \
+	__m128i s, d, s_lo, s_hi, d_lo, d_hi; \
+	int i; \
+	for(i=0; i+4<=num_pixels; i+=4, dst+=16, src+=16) \
+	{ \
+		s = _mm_loadu_si128((const __m128i*)src); \
+		d = _mm_loadu_si128((const __m128i*)dst); \
+		s_lo = _mm_unpacklo_epi8(s, zero),	s_hi = _mm_unpackhi_epi8(s, zero); \
+		d_lo = _mm_unpacklo_epi8(d, zero),	d_hi = _mm_unpackhi_epi8(d, zero); \
+		if(opacity != 0xff) \
+		{ \
+			s_lo = SSE2_DIV255(_mm_mullo_epi16(s_lo, op)); \
+			s_hi = SSE2_DIV255(_mm_mullo_epi16(s_hi, op)); \
+		} \
+		d_lo = BLEND(s_lo, d_lo, max_value); \
+		d_hi = BLEND(s_hi, d_hi, max_value); \
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(d_lo, d_hi)); \
+	} \
+	NativeBlend##NAME##_scalar(dst, src, num_pixels - i, opacity); \
+}
+
+//  + ~(1-)
+#define SSE2_NORMAL(S, D, MAX) _mm_add_epi16((S), \
+	SSE2_DIV255(_mm_mullo_epi16((D), _mm_sub_epi16((MAX), SSE2_ALPHA(S)))))
+//  +  (Oa)
+#define SSE2_ADD(S, D, MAX) _mm_min_epi16(_mm_add_epi16((S), (D)), (MAX))
+// ~(1-) + ~(1-惿) + ~
+#define SSE2_MULTIPLY(S, D, MAX) SSE2_DIV255(_mm_add_epi16(_mm_add_epi16( \
+	_mm_mullo_epi16((D), _mm_sub_epi16((MAX), SSE2_ALPHA(S))), \
+	_mm_mullo_epi16((S), _mm_sub_epi16((MAX), SSE2_ALPHA(D)))), _mm_mullo_epi16((S), (D))))
+//  +  - ~
+#define SSE2_SCREEN(S, D, MAX) _mm_sub_epi16(_mm_add_epi16((S), (D)), \
+	SSE2_DIV255(_mm_mullo_epi16((S), (D))))
+
+SSE2_BLEND_FUNCTION(Normal, SSE2_NORMAL)
+SSE2_BLEND_FUNCTION(Add, SSE2_ADD)
+SSE2_BLEND_FUNCTION(Multiply, SSE2_MULTIPLY)
+SSE2_BLEND_FUNCTION(Screen, SSE2_SCREEN)
+
+#endif	// #if defined(NATIVE_BLEND_SSE2) && NATIVE_BLEND_SSE2 != 0
+
+#if defined(NATIVE_BLEND_AVX2) && NATIVE_BLEND_AVX2 != 0
+
+// AVX2
+	// 16rbgɓWJ8sNZA[̃sNZ̓XJ[łō
+#define AVX2_DIV255(X) _mm256_mulhi_epu16(_mm256_add_epi16((X), _mm256_set1_epi16(128)), _mm256_set1_epi16(257))
+#define AVX2_ALPHA(X) _mm256_shufflehi_epi16(_mm256_shufflelo_epi16((X), _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3))
+
+#define AVX2_BLEND_FUNCTION(NAME, BLEND) \
+static AVX2_FUNCTION void NativeBlend##NAME##_avx2(uint8* dst, const uint8* src, int num_pixels, int opacity) \
+{ \
+	const __m256i zero = _mm256_setzero_si256(); \
+	const __m256i max_value = _mm256_set1_epi16(0xff); \
+	const __m256i op = _mm256_set1_epi16((short)opacity); \
+	__m256i s, d, s_lo, s_hi, d_lo, d_hi; \
+	int i; \
+	for(i=0; i+8<=num_pixels; i+=8, dst+=32, src+=32) \
+	{ \
+		s = _mm256_loadu_si256((const __m256i*)src); \
+		d = _mm256_loadu_si256((const __m256i*)dst); \
+		s_lo = _mm256_unpacklo_epi8(s, zero),	s_hi = _mm256_unpackhi_epi8(s, zero); \
+		d_lo = _mm256_unpacklo_epi8(d, zero),	d_hi = _mm256_unpackhi_epi8(d, zero); \
+		if(opacity != 0xff) \
+		{ \
+			s_lo = AVX2_DIV255(_mm256_mullo_epi16(s_lo, op)); \
+			s_hi = AVX2_DIV255(_mm256_mullo_epi16(s_hi, op)); \
+		} \
+		d_lo = BLEND(s_lo, d_lo, max_value); \
+		d_hi = BLEND(s_hi, d_hi, max_value); \
+		_mm256_storeu_si256((__m256i*)dst, _mm256_packus_epi16(d_lo, d_hi)); \
+	} \
+	NativeBlend##NAME##_scalar(dst, src, num_pixels - i, opacity); \
+}
+
+#define AVX2_NORMAL(S, D, MAX) _mm256_add_epi16((S), \
+	AVX2_DIV255(_mm256_mullo_epi16((D), _mm256_sub_epi16((MAX), AVX2_ALPHA(S)))))
+#define AVX2_ADD(S, D, MAX) _mm256_min_epi16(_mm256_add_epi16((S), (D)), (MAX))
+#define AVX2_MULTIPLY(S, D, MAX) AVX2_DIV255(_mm256_add_epi16(_mm256_add_epi16( \
+	_mm256_mullo_epi16((D), _mm256_sub_epi16((MAX), AVX2_ALPHA(S))), \
+	_mm256_mullo_epi16((S), _mm256_sub_epi16((MAX), AVX2_ALPHA(D)))), _mm256_mullo_epi16((S), (D))))
+#define AVX2_SCREEN(S, D, MAX) _mm256_sub_epi16(_mm256_add_epi16((S), (D)), \
+	AVX2_DIV255(_mm256_mullo_epi16((S), (D))))
+
+AVX2_BLEND_FUNCTION(Normal, AVX2_NORMAL)
+AVX2_BLEND_FUNCTION(Add, AVX2_ADD)
+AVX2_BLEND_FUNCTION(Multiply, AVX2_MULTIPLY)
+AVX2_BLEND_FUNCTION(Screen, AVX2_SCREEN)
+
+#endif	// #if defined(NATIVE_BLEND_AVX2) && NATIVE_BLEND_AVX2 != 0
+
+/*********************************************
+* GetNativeBlendCpuFeatures֐              *
+* CPŮg߂̃T|[g󋵂擾      *
+* Ԃl                                     *
+*	eNATIVE_BLEND_CPU_FEATURȆgݍ킹    *
+*********************************************/
+static int GetNativeBlendCpuFeatures(void)
+{
+	int features = 0;
+#if defined(NATIVE_BLEND_SSE2) && NATIVE_BLEND_SSE2 != 0
+	unsigned int info[4] = {0};
+	unsigned int max_leaf;
+	uint64 xcr0 = 0;
+
+# if defined(_MSC_VER)
+	__cpuid((int*)info, 0);
+	max_leaf = info[0];
+	__cpuid((int*)info, 1);
+# else
+	if(__get_cpuid(0, &info[0], &info[1], &info[2], &info[3]) == 0)
+	{
+		return 0;
+	}
+	max_leaf = info[0];
+	(void)__get_cpuid(1, &info[0], &info[1], &info[2], &info[3]);
+# endif
+
+	if((info[3] & 0x04000000) != 0)
+	{
+		features |= NATIVE_BLEND_CPU_SSE2;
+	}
+
+# if defined(NATIVE_BLEND_AVX2) && NATIVE_BLEND_AVX2 != 0
+	// OSAVX̃WX^ۑ邩(OSXSAVE, AVX)mF
+	if((info[2] & 0x18000000) == 0x18000000 && max_leaf >= 7)
+	{
+#  if defined(_MSC_VER)
+		xcr0 = _xgetbv(0);
+		__cpuidex((int*)info, 7, 0);
+#  else
+		unsigned int eax, edx;
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		xcr0 = ((uint64)edx << 32) | eax;
+		__cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+#  endif
+		if((xcr0 & 0x06) == 0x06 && (info[1] & 0x20) != 0)
+		{
+			features |= NATIVE_BLEND_CPU_AVX2;
+		}
+	}
+# endif
+#endif
+
+	return features;
+}
+
+/********************************************
+* InitializeNativeBlendFunctions֐        *
+* CPŰ@\𒲂ׂč̊֐肷 *
+********************************************/
+void InitializeNativeBlendFunctions(void)
+{
+	int features;
+
+	if(g_native_blend_initialized != 0)
+	{
+		return;
+	}
+
+	(void)memset(g_native_blend_functions, 0, sizeof(g_native_blend_functions));
+	g_native_blend_functions[LAYER_BLEND_NORMAL] = NativeBlendNormal_scalar;
+	g_native_blend_functions[LAYER_BLEND_ADD] = NativeBlendAdd_scalar;
+	g_native_blend_functions[LAYER_BLEND_MULTIPLY] = NativeBlendMultiply_scalar;
+	g_native_blend_functions[LAYER_BLEND_SCREEN] = NativeBlendScreen_scalar;
+	g_native_blend_functions[LAYER_BLEND_OVERLAY] = NativeBlendOverLay_scalar;
+	g_native_blend_functions[LAYER_BLEND_LIGHTEN] = NativeBlendLighten_scalar;
+	g_native_blend_functions[LAYER_BLEND_DARKEN] = NativeBlendDarken_scalar;
+	g_native_blend_functions[LAYER_BLEND_DODGE] = NativeBlendDodge_scalar;
+	g_native_blend_functions[LAYER_BLEND_BURN] = NativeBlendBurn_scalar;
+	g_native_blend_functions[LAYER_BLEND_HARD_LIGHT] = NativeBlendHardLight_scalar;
+	g_native_blend_functions[LAYER_BLEND_SOFT_LIGHT] = NativeBlendSoftLight_scalar;
+	g_native_blend_functions[LAYER_BLEND_DIFFERENCE] = NativeBlendDifference_scalar;
+	g_native_blend_functions[LAYER_BLEND_EXCLUSION] = NativeBlendExclusion_scalar;
+	g_native_blend_functions[LAYER_BLEND_HSL_HUE] = NativeBlendHslHue_scalar;
+	g_native_blend_functions[LAYER_BLEND_HSL_SATURATION] = NativeBlendHslSaturation_scalar;
+	g_native_blend_functions[LAYER_BLEND_HSL_COLOR] = NativeBlendHslColor_scalar;
+	g_native_blend_functions[LAYER_BLEND_HSL_LUMINOSITY] = NativeBlendHslLuminosity_scalar;
+	g_native_blend_functions[LAYER_BLEND_ALPHA_MINUS] = NativeBlendAlphaMinus_scalar;
+	g_native_blend_functions[LAYER_BLEND_SOURCE] = NativeBlendSource_scalar;
+	g_native_blend_functions[LAYER_BLEND_ATOP] = NativeBlendAtop_scalar;
+
+	features = GetNativeBlendCpuFeatures();
+#if defined(NATIVE_BLEND_SSE2) && NATIVE_BLEND_SSE2 != 0
+	if((features & NATIVE_BLEND_CPU_SSE2) != 0)
+	{
+		g_native_blend_functions[LAYER_BLEND_NORMAL] = NativeBlendNormal_sse2;
+		g_native_blend_functions[LAYER_BLEND_ADD] = NativeBlendAdd_sse2;
+		g_native_blend_functions[LAYER_BLEND_MULTIPLY] = NativeBlendMultiply_sse2;
+		g_native_blend_functions[LAYER_BLEND_SCREEN] = NativeBlendScreen_sse2;
+	}
+#endif
+#if defined(NATIVE_BLEND_AVX2) && NATIVE_BLEND_AVX2 != 0
+	if((features & NATIVE_BLEND_CPU_AVX2) != 0)
+	{
+		g_native_blend_functions[LAYER_BLEND_NORMAL] = NativeBlendNormal_avx2;
+		g_native_blend_functions[LAYER_BLEND_ADD] = NativeBlendAdd_avx2;
+		g_native_blend_functions[LAYER_BLEND_MULTIPLY] = NativeBlendMultiply_avx2;
+		g_native_blend_functions[LAYER_BLEND_SCREEN] = NativeBlendScreen_avx2;
+	}
+#endif
+
+	// ʏ퍇Ɠ
+	g_native_blend_functions[LAYER_BLEND_OVER] = g_native_blend_functions[LAYER_BLEND_NORMAL];
+
+	g_native_blend_initialized = 1;
+}
+
+/***********************************************
+* GetNativeBlendFunction֐                   *
+* [hɑΉ鍇̊֐擾 *
+*                                          *
+* blend_mode	: [h                   *
+* Ԃl                                       *
+*	̊֐(ΉĂȂ[hNULL) *
+***********************************************/
+NATIVE_BLEND_FUNC GetNativeBlendFunction(int blend_mode)
+{
+	if(blend_mode < 0 || blend_mode >= NUM_LAYER_BLEND_FUNCTIONS)
+	{
+		return NULL;
+	}
+
+	InitializeNativeBlendFunctions();
+
+	return g_native_blend_functions[blend_mode];
+}
+
+/*******************************************
+* NativeBlendPixels֐                    *
+* `͈͂̃sNZf[^       *
+*                                      *
+* dst			: ̃sNZf[^   *
+* dst_stride	: 1s̃oCg  *
+* src			: ̃sNZf[^   *
+* src_stride	: 1s̃oCg  *
+* width			: 镝               *
+* height		: 鍂             *
+* opacity		: ̕sx(0`255) *
+* func			: ̊֐           *
+*******************************************/
+void NativeBlendPixels(
+	uint8* dst,
+	int dst_stride,
+	const uint8* src,
+	int src_stride,
+	int width,
+	int height,
+	int opacity,
+	NATIVE_BLEND_FUNC func
+)
+{
+	int y;
+
+	if(width <= 0 || opacity <= 0)
+	{
+		return;
+	}
+	if(opacity > 0xff)
+	{
+		opacity = 0xff;
+	}
+
+	for(y=0; y<height; y++, dst+=dst_stride, src+=src_stride)
+	{
+		func(dst, src, width, opacity);
+	}
+}
+
+/**********************************************************
+* CalcPixelsContentBounds֐                             *
+* sNZf[^̕sȕ܂ދ`vZ        *
+*                                                     *
+* pixels		: sNZf[^(BGRA)                    *
+* width			:                                       *
+* height		:                                     *
+* stride		: 1s̃oCg                         *
+* x				: `̍XWi[AhX     *
+* y				: `̍YWi[AhX     *
+* bounds_width	: `̕i[AhX(0)   *
+* bounds_height	: `̍i[AhX(0) *
+**********************************************************/
+void CalcPixelsContentBounds(
+	const uint8* pixels,
+	int width,
+	int height,
+	int stride,
+	int* x,
+	int* y,
+	int* bounds_width,
+	int* bounds_height
+)
+{
+	int min_x = width, max_x = -1;
+	int min_y = -1, max_y = -1;
+	int i, j;
+
+	for(j=0; j<height; j++)
+	{
+		const uint8 *alpha = &pixels[j*stride+3];
+
+		// [sȃsNZT
+		for(i=0; i<width; i++)
+		{
+			if(alpha[i*4] != 0)
+			{
+				break;
+			}
+		}
+		if(i == width)
+		{	// Sēȍs
+			continue;
+		}
+
+		if(min_y < 0)
+		{
+			min_y = j;
+		}
+		max_y = j;
+		if(i < min_x)
+		{
+			min_x = i;
+		}
+
+		// E[sȃsNZT
+			// (ɌĂׂ͈͂̓͒Ȃ)
+		for(i=width-1; i>max_x; i--)
+		{
+			if(alpha[i*4] != 0)
+			{
+				max_x = i;
+				break;
+			}
+		}
+	}
+
+	if(min_y < 0)
+	{	// Sē
+		*x = *y = 0;
+		*bounds_width = *bounds_height = 0;
+	}
+	else
+	{
+		*x = min_x;
+		*y = min_y;
+		*bounds_width = max_x - min_x + 1;
+		*bounds_height = max_y - min_y + 1;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+#ifndef _INCLUDED_LAYER_BLEND_NATIVE_H_
+#define _INCLUDED_LAYER_BLEND_NATIVE_H_
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************
+* NATIVE_BLEND_FUNC^                          *
+* 1s̃sNZ֐                *
+*                                          *
+* dst			: ̃sNZf[^(BGRA) *
+* src			: ̃sNZf[^(BGRA) *
+* num_pixels	: sNZ           *
+* opacity		: ̕sx(0`255)     *
+***********************************************/
+typedef void (*NATIVE_BLEND_FUNC)(uint8* dst, const uint8* src, int num_pixels, int opacity);
+
+/********************************************
+* InitializeNativeBlendFunctions֐        *
+* CPŰ@\𒲂ׂč̊֐肷 *
+********************************************/
+EXTERN void InitializeNativeBlendFunctions(void);
+
+/***********************************************
+* GetNativeBlendFunction֐                   *
+* [hɑΉ鍇̊֐擾 *
+*                                          *
+* blend_mode	: [h                   *
+* Ԃl                                       *
+*	̊֐(ΉĂȂ[hNULL) *
+***********************************************/
+EXTERN NATIVE_BLEND_FUNC GetNativeBlendFunction(int blend_mode);
+
+/*******************************************
+* NativeBlendPixels֐                    *
+* `͈͂̃sNZf[^       *
+*                                      *
+* dst			: ̃sNZf[^   *
+* dst_stride	: 1s̃oCg  *
+* src			: ̃sNZf[^   *
+* src_stride	: 1s̃oCg  *
+* width			: 镝               *
+* height		: 鍂             *
+* opacity		: ̕sx(0`255) *
+* func			: ̊֐           *
+*******************************************/
+EXTERN void NativeBlendPixels(
+	uint8* dst,
+	int dst_stride,
+	const uint8* src,
+	int src_stride,
+	int width,
+	int height,
+	int opacity,
+	NATIVE_BLEND_FUNC func
+);
+
+/**********************************************************
+* CalcPixelsContentBounds֐                             *
+* sNZf[^̕sȕ܂ދ`vZ        *
+*                                                     *
+* pixels		: sNZf[^(BGRA)                    *
+* width			:                                       *
+* height		:                                     *
+* stride		: 1s̃oCg                         *
+* x				: `̍XWi[AhX     *
+* y				: `̍YWi[AhX     *
+* bounds_width	: `̕i[AhX(0)   *
+* bounds_height	: `̍i[AhX(0) *
+**********************************************************/
+EXTERN void CalcPixelsContentBounds(
+	const uint8* pixels,
+	int width,
+	int height,
+	int stride,
+	int* x,
+	int* y,
+	int* bounds_width,
+	int* bounds_height
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	// #ifndef _INCLUDED_LAYER_BLEND_NATIVE_H_
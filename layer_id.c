@@ -0,0 +1,96 @@
+/*
+* layer_id.c
+* C[ID̊蓖ĂIĎ`
+*/
+
+#include "layer.h"
+#include "draw_window.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************
+* UnregisterLayerID֐                *
+* C[ID\O         *
+*                                  *
+* layer	: IDOC[             *
+***************************************/
+void UnregisterLayerID(LAYER* layer)
+{
+	ght_hash_table_t *table;
+
+	if(layer->id == 0 || layer->window == NULL || layer->window->layer_table == NULL)
+	{
+		layer->id = 0;
+		return;
+	}
+
+	// IDō蒼C[o^ĂΎc
+	table = layer->window->layer_table;
+	if(ght_get(table, sizeof(layer->id), &layer->id) == layer)
+	{
+		(void)ght_remove(table, sizeof(layer->id), &layer->id);
+	}
+	layer->id = 0;
+}
+
+void AssignLayerID(LAYER* layer, uint32 id)
+{
+	DRAW_WINDOW *window = layer->window;
+
+	if(window == NULL)
+	{
+		return;
+	}
+
+	if(window->layer_table == NULL)
+	{
+		window->layer_table = ght_create(LAYER_ID_TABLE_SIZE);
+		ght_set_rehash(window->layer_table, TRUE);
+	}
+
+	UnregisterLayerID(layer);
+
+	// ̃C[gĂID͎gȂ
+	if(id == 0 || ght_get(window->layer_table, sizeof(id), &id) != NULL)
+	{
+		do
+		{
+			id = ++window->last_layer_id;
+		} while(id == 0 || ght_get(window->layer_table, sizeof(id), &id) != NULL);
+	}
+	else if(id > window->last_layer_id)
+	{
+		window->last_layer_id = id;
+	}
+
+	layer->id = id;
+	(void)ght_insert(window->layer_table, layer, sizeof(id), &id);
+}
+
+LAYER* SearchLayerByID(DRAW_WINDOW* window, uint32 id)
+{
+	if(id == 0 || window->layer_table == NULL)
+	{
+		return NULL;
+	}
+
+	return (LAYER*)ght_get(window->layer_table, sizeof(id), &id);
+}
+
+LAYER* SearchLayerByIDAndName(DRAW_WINDOW* window, uint32 id, const gchar* name)
+{
+	LAYER *layer = SearchLayerByID(window, id);
+
+	if(layer == NULL)
+	{
+		layer = SearchLayer(window->layer, name);
+	}
+
+	return layer;
+}
+
+#ifdef __cplusplus
+}
+#endif
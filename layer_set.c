@@ -309,6 +309,100 @@ GtkWidget* CreateLayerSetChildButton(LAYER* layer_set)
 	return layer_set->layer_data.layer_set_p->show_child_button;
 }
 
+/*****************************************************************
+* GetLayerSetChildrenState֐                                   *
+* C[Zbg̎qC[̏Ԃ\lvZ             *
+*                                                            *
+* bottom	: C[Zbg̈ԉ̃C[                   *
+* Ԃl                                                         *
+*	qC[IDAXVԍA[hAsxAtO   *
+*	vZl                                                   *
+*****************************************************************/
+static unsigned int GetLayerSetChildrenState(LAYER* bottom)
+{
+	static const unsigned int initial_fnv = 2166136261u;
+	static const unsigned int fnv_multiple = 16777619u;
+
+	LAYER *layer_set = bottom->layer_set;
+	LAYER *layer = bottom;
+	unsigned int state = initial_fnv;
+
+	while(layer != NULL && layer != layer_set)
+	{
+		state = (state ^ (unsigned int)layer->id) * fnv_multiple;
+		// q̃C[Zbg͍蒼ɐẽLbVĵ
+			// XVԍ͌Ȃ
+		if(layer->layer_type != TYPE_LAYER_SET)
+		{
+			state = (state ^ layer->content_generation) * fnv_multiple;
+		}
+		state = (state ^ (unsigned int)layer->layer_mode) * fnv_multiple;
+		state = (state ^ (unsigned int)layer->alpha) * fnv_multiple;
+		state = (state ^ (unsigned int)(layer->flags
+			& (LAYER_FLAG_INVISIBLE | LAYER_MASKING_WITH_UNDER_LAYER))) * fnv_multiple;
+
+		layer = layer->next;
+	}
+
+	return state;
+}
+
+/*************************************************************
+* IsLayerSetEditing֐                                      *
+* C[ZbgҏW̃C[Ɋ֌W邩𔻒肷     *
+*                                                        *
+* layer_set	: 肷郌C[Zbg                         *
+* window		: `̈Ǘ\̂̃AhX         *
+* Ԃl                                                     *
+*	ANeBuC[܂ނANeBuC[̎qȂTRUE *
+*************************************************************/
+static int IsLayerSetEditing(LAYER* layer_set, DRAW_WINDOW* window)
+{
+	LAYER *layer;
+
+	// ANeBuC[gAANeBuC[܂ނ
+	for(layer = window->active_layer; layer != NULL; layer = layer->layer_set)
+	{
+		if(layer == layer_set)
+		{
+			return TRUE;
+		}
+	}
+
+	// ANeBuȃC[Zbg̒̃C[Zbg
+		// (C[Zbgւ̃tB^[ŎqC[ύX)
+	for(layer = layer_set->layer_set; layer != NULL; layer = layer->layer_set)
+	{
+		if(layer == window->active_layer)
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/*******************************************************
+* ClearLayerSetCache֐                               *
+* SẴC[Zbg̍ʂ̃LbVj *
+*                                                  *
+* window	: `̈Ǘ\̂̃AhX       *
+*******************************************************/
+void ClearLayerSetCache(DRAW_WINDOW* window)
+{
+	LAYER *layer = window->layer;
+
+	while(layer != NULL)
+	{
+		if(layer->layer_type == TYPE_LAYER_SET)
+		{
+			layer->layer_data.layer_set_p->cache_valid = FALSE;
+		}
+
+		layer = layer->next;
+	}
+}
+
 /*************************************************
 * MixLayerSet֐                                *
 * C[Zbg                         *
@@ -327,6 +421,21 @@ void MixLayerSet(LAYER* bottom, LAYER** next, DRAW_WINDOW* window)
 	LAYER *layer = bottom;
 	LAYER *blend_layer;
 	int blend_mode;
+	// LbVp
+	unsigned int children_state = GetLayerSetChildrenState(bottom);
+	int editing = IsLayerSetEditing(layer_set, window);
+
+	// qC[ɕύXΑO̍ʂ̂܂܎g
+	if(editing == FALSE && layer_set->layer_data.layer_set_p->cache_valid != FALSE
+		&& layer_set->layer_data.layer_set_p->children_state == children_state)
+	{
+		while(layer != layer_set)
+		{
+			layer = layer->next;
+		}
+		*next = layer;
+		return;
+	}
 
 	// C[Zbg̃sNZf[^Zbg
 	(void)memset(layer_set->pixels, 0, pixel_bytes);
@@ -413,6 +522,15 @@ void MixLayerSet(LAYER* bottom, LAYER** next, DRAW_WINDOW* window)
 	}	// while(1)
 			// C[Zbg܂Ń[v
 
+	// ҏWłȂ΍ʂLbVƂĈ
+	layer_set->layer_data.layer_set_p->cache_valid = !editing;
+	layer_set->layer_data.layer_set_p->children_state = children_state;
+	// ẽC[Zbg͍
+	for(blend_layer = layer_set->layer_set; blend_layer != NULL; blend_layer = blend_layer->layer_set)
+	{
+		blend_layer->layer_data.layer_set_p->cache_valid = FALSE;
+	}
+
 	// TlCXV
 	gtk_widget_queue_draw(layer->widget->thumbnail);
 
@@ -8,6 +8,10 @@ typedef struct _LAYER_SET
 	struct _LAYER *active_under;
 	GtkWidget *show_child_button;
 	GtkWidget *button_image;
+	// ʂ̃LbVLǂ̃tO
+	int cache_valid;
+	// LbV쐬̎qC[̏
+	unsigned int children_state;
 } LAYER_SET;
 
 #endif	// #ifndef _INCLUDED_LAYER_SET_H_
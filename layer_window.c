@@ -1117,6 +1117,8 @@ static void UpadateLayerThumbnail(
 #endif
 	// Rs[̊g嗦
 	gdouble zoom;
+	// sȕ܂ދ`
+	int bounds_x, bounds_y, bounds_width, bounds_height;
 
 	// wif[^Rs[
 	cairo_set_source_surface(cairo_p,
@@ -1136,8 +1138,21 @@ static void UpadateLayerThumbnail(
 	// g嗦ZbgăC[̃sNZf[^gkăTlCɏ
 	cairo_set_operator(cairo_p, CAIRO_OPERATOR_OVER);
 	cairo_scale(cairo_p, zoom, zoom);
-	cairo_set_source_surface(cairo_p, layer->surface_p, 0, 0);
-	cairo_paint(cairo_p);
+	if(GetLayerContentBounds(layer, &bounds_x, &bounds_y, &bounds_width, &bounds_height) != FALSE)
+	{	// sȕk
+		if(bounds_width > 0)
+		{
+			cairo_rectangle(cairo_p, bounds_x, bounds_y, bounds_width, bounds_height);
+			cairo_clip(cairo_p);
+			cairo_set_source_surface(cairo_p, layer->surface_p, 0, 0);
+			cairo_paint(cairo_p);
+		}
+	}
+	else
+	{
+		cairo_set_source_surface(cairo_p, layer->surface_p, 0, 0);
+		cairo_paint(cairo_p);
+	}
 
 #if GTK_MAJOR_VERSION <= 2
 	// Cairoj
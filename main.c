@@ -8,6 +8,7 @@
 #include <locale.h>
 #include <gtk/gtk.h>
 #include "application.h"
+#include "brush_core.h"
 #include "MikuMikuGtk+/tbb.h"
 #include "memory.h"
 #include <gtk/gtkgl.h>
@@ -32,7 +33,7 @@ processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 # endif
 #endif
 
-# if !defined(_DEBUG)
+# if !defined(_DEBUG) && (!defined(STROKE_REPLAY) || STROKE_REPLAY == 0)
 #  pragma comment(linker, "/subsystem:\"windows\" /entry:\"mainCRTStartup\"")
 # endif
 
@@ -429,12 +430,24 @@ int main(int argc, char** argv)
 	tbb = TbbObjectNew();
 #endif
 
+#if defined(STROKE_REPLAY) && STROKE_REPLAY != 0
+	// ブラシの入力の再生のみ行う
+	application.flags |= APPLICATION_HEADLESS;
+#endif
+
 	{
 		gchar *raw_path;
 
 		application.labels = &labels;
 		application.fractal_labels = &fractal_labels;
 
+#if !GLIB_CHECK_VERSION(2, 32, 0)
+		// 履歴データの圧縮にスレッドを使う
+		if(g_thread_supported() == FALSE)
+		{
+			g_thread_init(NULL);
+		}
+#endif
 #if GTK_MAJOR_VERSION <= 2
 		gtk_set_locale();
 #endif
@@ -451,6 +464,10 @@ int main(int argc, char** argv)
 		g_free(raw_path);
 	}
 
+#if defined(STROKE_REPLAY) && STROKE_REPLAY != 0
+	return StrokeReplayMain(&application, argc, argv);
+#endif
+
 	/*
 	{
 		cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 500, 500);
@@ -6,6 +6,7 @@
 #include "memory.h"
 #include "widgets.h"
 #include "input.h"
+#include "display.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -169,6 +170,8 @@ static gboolean DisplayNavigation(
 	}
 
 	window = GetActiveDrawWindow(app);
+	// 񂵂ɂ^CcĂΐɍ
+	FlushStaleTiles(window);
 
 	// `̈̃TCY擾
 	gtk_widget_get_allocation(window->scroll, &draw_allocation);
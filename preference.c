@@ -998,6 +998,7 @@ void ExecuteSetPreference(APPLICATION* app)
 
 			if(app->icc_transform != NULL)
 			{
+				ReleaseIccDisplayLut(&app->icc_lut);
 				cmsDeleteTransform(app->icc_transform);
 			}
 
@@ -1021,6 +1022,7 @@ void ExecuteSetPreference(APPLICATION* app)
 						hProfiles[0] = app->draw_window[i]->input_icc;
 						if(app->draw_window[i]->icc_transform != NULL)
 						{
+							ReleaseIccDisplayLut(&app->draw_window[i]->icc_lut);
 							cmsDeleteTransform(app->draw_window[i]->icc_transform);
 						}
 						app->draw_window[i]->icc_transform = cmsCreateExtendedTransform(cmsGetProfileContextID(hProfiles[1]), 4, hProfiles,
@@ -1039,6 +1041,7 @@ void ExecuteSetPreference(APPLICATION* app)
 					{
 						if(app->draw_window[i]->icc_transform != NULL)
 						{
+							ReleaseIccDisplayLut(&app->draw_window[i]->icc_lut);
 							cmsDeleteTransform(app->draw_window[i]->icc_transform);
 						}
 						app->draw_window[i]->icc_transform = cmsCreateTransform(app->draw_window[i]->input_icc, TYPE_BGRA_8,
@@ -1140,6 +1143,7 @@ void ExecuteSetPreference(APPLICATION* app)
 
 				if(app->icc_transform != NULL)
 				{
+					ReleaseIccDisplayLut(&app->icc_lut);
 					cmsDeleteTransform(app->icc_transform);
 				}
 
@@ -1237,6 +1241,16 @@ void ReadPreference(INI_FILE_PTR file, PREFERENCE* preference)
 	{
 		preference->auto_save_time = 300;
 	}
+	preference->history_memory_limit = (int32)IniFileGetInteger(file, "PREFERENCE", "HISTORY_MEMORY_LIMIT");
+	if(preference->history_memory_limit <= 0)
+	{
+		preference->history_memory_limit = HISTORY_DEFAULT_MEMORY_LIMIT;
+	}
+	preference->history_spill_steps = (int32)IniFileGetInteger(file, "PREFERENCE", "HISTORY_SPILL_STEPS");
+	if(preference->history_spill_steps <= 0)
+	{
+		preference->history_spill_steps = HISTORY_DEFAULT_SPILL_STEPS;
+	}
 
 	if(IniFileGetString(file, "PREFERENCE", "BACK_GROUND_COLOR", color_string, 128) > 0)
 	{
@@ -1264,6 +1278,10 @@ void WritePreference(INI_FILE_PTR file, PREFERENCE* preference)
 		preference->auto_save, 10);
 	(void)IniFileAddInteger(file, "PREFERENCE", "AUTO_SAVE_INTERVAL",
 		preference->auto_save_time / 60, 10);
+	(void)IniFileAddInteger(file, "PREFERENCE", "HISTORY_MEMORY_LIMIT",
+		preference->history_memory_limit, 10);
+	(void)IniFileAddInteger(file, "PREFERENCE", "HISTORY_SPILL_STEPS",
+		preference->history_spill_steps, 10);
 
 	color = (preference->canvas_back_ground[0] << 16)
 		| (preference->canvas_back_ground[1] << 8)
@@ -26,6 +26,10 @@ typedef struct _PREFERENCE
 	int32 auto_save_time;
 	// LoX̔wiF
 	uint8 canvas_back_ground[3];
+	// f[^̃gpʂ̏(MB)
+	int32 history_memory_limit;
+	// ꎞt@CɑޔɎc̐
+	int32 history_spill_steps;
 } PREFERENCE;
 
 // ֐̃vg^Cv錾
@@ -2,6 +2,7 @@
 #include "preview_window.h"
 #include "application.h"
 #include "input.h"
+#include "display.h"
 #include "memory.h"
 
 #ifdef __cplusplus
@@ -132,6 +133,9 @@ static gboolean UpdatePreviewWindow(
 			(int32)(app->draw_window[app->active_window]->height * app->preview_window.zoom);
 	}
 
+	// 񂵂ɂ^CcĂΐɍ
+	FlushStaleTiles(app->draw_window[app->active_window]);
+
 	// 摜gkĕ`
 	cairo_scale(app->preview_window.cairo_p, app->preview_window.zoom, app->preview_window.zoom);
 	cairo_set_source_surface(app->preview_window.cairo_p,
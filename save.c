@@ -886,6 +886,9 @@ const char* Save(
 
 	system_path = g_locale_from_utf8(file_path, -1, NULL, NULL, NULL);
 
+	// 񂵂ɂ^C΍Ă珑o
+	FlushStaleTiles(window);
+
 	// gqŏo@؂ւ
 	if(StringCompareIgnoreCase(file_type, "kab") == 0)
 	{	// Ǝ`
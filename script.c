@@ -620,6 +620,18 @@ static int ScriptHSV2RGB(lua_State* lua)
 	return 3;
 }
 
+// XNvgɓnC[̃e[uID擾(0)
+static uint32 ScriptGetLayerTableID(lua_State* lua, int index)
+{
+	uint32 id;
+
+	lua_getfield(lua, index, "id");
+	id = (uint32)lua_tounsigned(lua, -1);
+	lua_pop(lua, 1);
+
+	return id;
+}
+
 static void ScriptReturnLayer(lua_State* lua, LAYER* layer)
 {
 	guint32 pixel_value;
@@ -630,9 +642,9 @@ static void ScriptReturnLayer(lua_State* lua, LAYER* layer)
 	switch(layer->layer_type)
 	{
 	case TYPE_VECTOR_LAYER:
-		data_num = 9;
+		data_num = 10;
 	default:
-		data_num = 8;
+		data_num = 9;
 	}
 
 	lua_createtable(lua, 0, data_num);
@@ -642,6 +654,8 @@ static void ScriptReturnLayer(lua_State* lua, LAYER* layer)
 	lua_setfield(lua, -2, "height");
 	lua_pushstring(lua, layer->name);
 	lua_setfield(lua, -2, "name");
+	lua_pushunsigned(lua, layer->id);
+	lua_setfield(lua, -2, "id");
 	lua_pushinteger(lua, layer->alpha);
 	lua_setfield(lua, -2, "alpha");
 	lua_pushunsigned(lua, layer->flags);
@@ -740,13 +754,15 @@ static void ScriptReturnLayer(lua_State* lua, LAYER* layer)
 
 static void ScriptReturnLayerInfo(lua_State* lua, LAYER* layer)
 {
-	lua_createtable(lua, 0, 6);
+	lua_createtable(lua, 0, 7);
 	lua_pushinteger(lua, layer->width);
 	lua_setfield(lua, -2, "width");
 	lua_pushinteger(lua, layer->height);
 	lua_setfield(lua, -2, "height");
 	lua_pushstring(lua, layer->name);
 	lua_setfield(lua, -2, "name");
+	lua_pushunsigned(lua, layer->id);
+	lua_setfield(lua, -2, "id");
 	lua_pushinteger(lua, layer->alpha);
 	lua_setfield(lua, -2, "alpha");
 	lua_pushunsigned(lua, layer->flags);
@@ -779,11 +795,8 @@ static int ScriptUpdateLayerPixels(lua_State* lua)
 
 	lua_getfield(lua, -1, "name");
 	layer_name = luaL_checkstring(lua, -1);
-	layer = script->app->draw_window[script->app->active_window]->layer;
-	while(layer != NULL && strcmp(layer_name, layer->name) != 0)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(script->app->draw_window[script->app->active_window],
+		ScriptGetLayerTableID(lua, -2), layer_name);
 	lua_pop(lua, 1);
 
 	if(layer->layer_type != TYPE_NORMAL_LAYER)
@@ -874,11 +887,8 @@ static int ScriptUpdateVectorLayer(lua_State* lua)
 
 	lua_getfield(lua, -1, "name");
 	layer_name = luaL_checkstring(lua, -1);
-	layer = script->app->draw_window[script->app->active_window]->layer;
-	while(layer != NULL && strcmp(layer_name, layer->name) != 0)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(script->app->draw_window[script->app->active_window],
+		ScriptGetLayerTableID(lua, -2), layer_name);
 	lua_pop(lua, 1);
 
 	if(layer->layer_type != TYPE_VECTOR_LAYER)
@@ -1198,12 +1208,7 @@ static int ScriptGetPreviousLayer(lua_State* lua)
 	}
 
 	window = script->window;
-	layer = window->layer;
-
-	while(strcmp(name, layer->name) != 0 && layer != NULL)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(window, ScriptGetLayerTableID(lua, -3), name);
 
 	if(layer == NULL || layer->prev == NULL)
 	{
@@ -1234,12 +1239,7 @@ static int ScriptGetPreviousLayerInfo(lua_State* lua)
 	}
 
 	window = script->window;
-	layer = window->layer;
-
-	while(strcmp(name, layer->name) != 0 && layer != NULL)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(window, ScriptGetLayerTableID(lua, -3), name);
 
 	if(layer == NULL || layer->prev == NULL)
 	{
@@ -1270,12 +1270,7 @@ static int ScriptGetNextLayer(lua_State* lua)
 	}
 
 	window = script->window;
-	layer = window->layer;
-
-	while(strcmp(name, layer->name) != 0 && layer != NULL)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(window, ScriptGetLayerTableID(lua, -3), name);
 
 	if(layer == NULL || layer->next == NULL)
 	{
@@ -1306,12 +1301,7 @@ static int ScriptGetNextLayerInfo(lua_State* lua)
 	}
 
 	window = script->window;
-	layer = window->layer;
-
-	while(strcmp(name, layer->name) != 0 && layer != NULL)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(window, ScriptGetLayerTableID(lua, -3), name);
 
 	if(layer == NULL || layer->next == NULL)
 	{
@@ -1518,9 +1508,11 @@ static int ScriptGetLayer(lua_State* lua)
 {
 	SCRIPT *script;
 	LAYER *layer;
-	const char *name = lua_tostring(lua, 1);
+	// lȂIDƂĈ
+	uint32 id = (lua_type(lua, 1) == LUA_TNUMBER) ? (uint32)lua_tounsigned(lua, 1) : 0;
+	const char *name = (id != 0) ? "" : lua_tostring(lua, 1);
 
-	if(name == NULL || name[0] == '\0')
+	if(name == NULL || (id == 0 && name[0] == '\0'))
 	{
 		return 0;
 	}
@@ -1533,12 +1525,7 @@ static int ScriptGetLayer(lua_State* lua)
 		return 0;
 	}
 
-	layer = script->app->draw_window[script->app->active_window]->layer;
-
-	while(layer != NULL && strcmp(name, layer->name) != 0)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(script->app->draw_window[script->app->active_window], id, name);
 
 	if(layer == NULL)
 	{
@@ -1583,11 +1570,7 @@ static int ScriptGetBlendedUnderLayer(lua_State* lua)
 
 	window = script->app->draw_window[script->app->active_window];
 
-	layer = window->layer;
-	while(layer != NULL && strcmp(layer_name, layer->name) != 0)
-	{
-		layer = layer->next;
-	}
+	layer = SearchLayerByIDAndName(window, ScriptGetLayerTableID(lua, -2), layer_name);
 	lua_pop(lua, 1);
 
 	blended = CreateLayer(0, 0, window->width, window->height,
@@ -4153,6 +4136,8 @@ void ScriptUndo(DRAW_WINDOW* window, void* p)
 	ClearLayerView(&window->app->layer_window);
 	LayerViewSetDrawWindow(&window->app->layer_window, window);
 
+	ClearLayerSetCache(window);
+	ClearLayerContentBounds(window);
 	window->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 	gtk_widget_queue_draw(window->window);
 
@@ -4289,6 +4274,10 @@ void ExecuteScript(GtkWidget* menu_item, APPLICATION* app)
 		// XNvgp̃f[^폜
 		DeleteScript(&script);
 
+		// XNvg͂ǂ̃C[̃sNZf[^ύXł̂
+			// C[Zbg̃LbVƕs͈̔͂j
+		ClearLayerSetCache(GetActiveDrawWindow(app));
+		ClearLayerContentBounds(GetActiveDrawWindow(app));
 		GetActiveDrawWindow(app)->flags |= DRAW_WINDOW_UPDATE_ACTIVE_UNDER;
 	}
 }
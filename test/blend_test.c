@@ -0,0 +1,278 @@
+/*****************************************************************
+* blend_test.c                                                   *
+* lCeBũC[cairoł̍ʂr     *
+* GTK͏Ȃ̂ŕ\Ăsł             *
+* g : make blend_test && ./blend_test                       *
+*****************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cairo.h>
+#include "../layer.h"
+#include "../layer_blend_native.h"
+
+// eXgp̉摜̃TCY(SIMDł̒[ʂ悤ɂ)
+#define TEST_WIDTH 67
+#define TEST_HEIGHT 9
+// 炵Ĕzuꍇ̈ʒuƃTCY
+#define TEST_OFFSET_X 13
+#define TEST_OFFSET_Y 3
+#define TEST_PART_WIDTH 29
+#define TEST_PART_HEIGHT 4
+
+/*************************************
+* BLEND_TEST_CASE\              *
+* [hƑΉcairỏZq *
+*************************************/
+typedef struct _BLEND_TEST_CASE
+{
+	const char *name;
+	int blend_mode;
+	cairo_operator_t op;
+	// e덷(pixmanƂ̊ۂ߂̈Ⴂ)
+	int tolerance;
+	// ͈̔͊O̍ύXȂ[h
+	int keep_outside;
+} BLEND_TEST_CASE;
+
+static const BLEND_TEST_CASE g_test_cases[] =
+{
+	{"NORMAL", LAYER_BLEND_NORMAL, CAIRO_OPERATOR_OVER, 1, 1},
+	{"ADD", LAYER_BLEND_ADD, CAIRO_OPERATOR_ADD, 1, 1},
+	{"MULTIPLY", LAYER_BLEND_MULTIPLY, CAIRO_OPERATOR_MULTIPLY, 2, 1},
+	{"SCREEN", LAYER_BLEND_SCREEN, CAIRO_OPERATOR_SCREEN, 2, 1},
+	{"OVERLAY", LAYER_BLEND_OVERLAY, CAIRO_OPERATOR_OVERLAY, 2, 1},
+	{"LIGHTEN", LAYER_BLEND_LIGHTEN, CAIRO_OPERATOR_LIGHTEN, 2, 1},
+	{"DARKEN", LAYER_BLEND_DARKEN, CAIRO_OPERATOR_DARKEN, 2, 1},
+	{"DODGE", LAYER_BLEND_DODGE, CAIRO_OPERATOR_COLOR_DODGE, 2, 1},
+	{"BURN", LAYER_BLEND_BURN, CAIRO_OPERATOR_COLOR_BURN, 2, 1},
+	{"HARD_LIGHT", LAYER_BLEND_HARD_LIGHT, CAIRO_OPERATOR_HARD_LIGHT, 2, 1},
+	{"SOFT_LIGHT", LAYER_BLEND_SOFT_LIGHT, CAIRO_OPERATOR_SOFT_LIGHT, 3, 1},
+	{"DIFFERENCE", LAYER_BLEND_DIFFERENCE, CAIRO_OPERATOR_DIFFERENCE, 2, 1},
+	{"EXCLUSION", LAYER_BLEND_EXCLUSION, CAIRO_OPERATOR_EXCLUSION, 2, 1},
+	{"HSL_HUE", LAYER_BLEND_HSL_HUE, CAIRO_OPERATOR_HSL_HUE, 4, 1},
+	{"HSL_SATURATION", LAYER_BLEND_HSL_SATURATION, CAIRO_OPERATOR_HSL_SATURATION, 4, 1},
+	{"HSL_COLOR", LAYER_BLEND_HSL_COLOR, CAIRO_OPERATOR_HSL_COLOR, 4, 1},
+	{"HSL_LUMINOSITY", LAYER_BLEND_HSL_LUMINOSITY, CAIRO_OPERATOR_HSL_LUMINOSITY, 4, 1},
+	{"ALPHA_MINUS", LAYER_BLEND_ALPHA_MINUS, CAIRO_OPERATOR_DEST_OUT, 1, 1},
+	{"SOURCE", LAYER_BLEND_SOURCE, CAIRO_OPERATOR_SOURCE, 1, 0},
+	{"ATOP", LAYER_BLEND_ATOP, CAIRO_OPERATOR_ATOP, 1, 1},
+	{"OVER", LAYER_BLEND_OVER, CAIRO_OPERATOR_OVER, 1, 1}
+};
+
+// sx
+static const int g_test_opacities[] = {255, 200, 128, 37, 1};
+
+/*******************************************
+* FillRandomPixels֐                     *
+* Zς݃BGRA̒l_ɐݒ肷 *
+*                                      *
+* pixels		: ݒ肷sNZf[^   *
+* num_pixels	: sNZ               *
+*******************************************/
+static void FillRandomPixels(uint8* pixels, int num_pixels)
+{
+	int alpha;
+	int i;
+
+	for(i=0; i<num_pixels; i++, pixels+=4)
+	{
+		// SɓEsȃsNZ܂߂
+		switch(rand() % 8)
+		{
+		case 0:
+			alpha = 0;
+			break;
+		case 1:
+			alpha = 0xff;
+			break;
+		default:
+			alpha = rand() % 256;
+		}
+		pixels[0] = (uint8)((alpha == 0) ? 0 : rand() % (alpha + 1));
+		pixels[1] = (uint8)((alpha == 0) ? 0 : rand() % (alpha + 1));
+		pixels[2] = (uint8)((alpha == 0) ? 0 : rand() % (alpha + 1));
+		pixels[3] = (uint8)alpha;
+	}
+}
+
+/*****************************************************
+* BlendWithCairo֐                                 *
+* C[cairołƓ@ō         *
+*                                                *
+* dst		: ̃sNZf[^(TEST_WIDTH) *
+* src		: ̃sNZf[^               *
+* src_x		: uXW                    *
+* src_y		: uYW                    *
+* width		: ̕                           *
+* height	: ̍                         *
+* opacity	: ̕sx(0`255)             *
+* op		: cairỏZq                        *
+*****************************************************/
+static void BlendWithCairo(
+	uint8* dst,
+	uint8* src,
+	int src_x,
+	int src_y,
+	int width,
+	int height,
+	int opacity,
+	cairo_operator_t op
+)
+{
+	cairo_surface_t *dst_surface = cairo_image_surface_create_for_data(dst,
+		CAIRO_FORMAT_ARGB32, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4);
+	cairo_surface_t *src_surface = cairo_image_surface_create_for_data(src,
+		CAIRO_FORMAT_ARGB32, width, height, width * 4);
+	cairo_t *cairo_p = cairo_create(dst_surface);
+
+	cairo_set_operator(cairo_p, op);
+	cairo_set_source_surface(cairo_p, src_surface, src_x, src_y);
+	cairo_paint_with_alpha(cairo_p, opacity / 255.0);
+
+	cairo_destroy(cairo_p);
+	cairo_surface_destroy(src_surface);
+	cairo_surface_flush(dst_surface);
+	cairo_surface_destroy(dst_surface);
+}
+
+/*********************************************
+* CompareTestPixels֐                      *
+* 2̌ʂ̍ő̍vZ             *
+*                                        *
+* a				: rsNZf[^     *
+* b				: rsNZf[^     *
+* num_bytes		: oCg                   *
+* error_index	: ő̍̈ʒui[   *
+* Ԃl                                     *
+*	ő̍                                 *
+*********************************************/
+static int CompareTestPixels(const uint8* a, const uint8* b, int num_bytes, int* error_index)
+{
+	int max_diff = 0;
+	int diff;
+	int i;
+
+	for(i=0; i<num_bytes; i++)
+	{
+		diff = abs((int)a[i] - (int)b[i]);
+		if(diff > max_diff)
+		{
+			max_diff = diff;
+			*error_index = i;
+		}
+	}
+
+	return max_diff;
+}
+
+/*****************************************************
+* RunBlendTest֐                                   *
+* 1̍[hɂcairoƂ̌ʂr     *
+*                                                *
+* test		: [h̏                       *
+* Ԃl                                             *
+*	v0A덷e͈͂𒴂1           *
+*****************************************************/
+static int RunBlendTest(const BLEND_TEST_CASE* test)
+{
+	uint8 src[TEST_WIDTH*TEST_HEIGHT*4];
+	uint8 dst[TEST_WIDTH*TEST_HEIGHT*4];
+	uint8 expected[TEST_WIDTH*TEST_HEIGHT*4];
+	uint8 part[TEST_PART_WIDTH*TEST_PART_HEIGHT*4];
+	NATIVE_BLEND_FUNC func = GetNativeBlendFunction(test->blend_mode);
+	int max_diff = 0, diff;
+	int error_index = 0;
+	int failed = 0;
+	unsigned int i;
+
+	if(func == NULL)
+	{
+		(void)printf("%-16s : no native function\n", test->name);
+		return 1;
+	}
+
+	for(i=0; i<sizeof(g_test_opacities)/sizeof(g_test_opacities[0]); i++)
+	{
+		// ƓTCY̍
+		FillRandomPixels(src, TEST_WIDTH*TEST_HEIGHT);
+		FillRandomPixels(dst, TEST_WIDTH*TEST_HEIGHT);
+		(void)memcpy(expected, dst, sizeof(dst));
+
+		BlendWithCairo(expected, src, 0, 0, TEST_WIDTH, TEST_HEIGHT,
+			g_test_opacities[i], test->op);
+		NativeBlendPixels(dst, TEST_WIDTH*4, src, TEST_WIDTH*4,
+			TEST_WIDTH, TEST_HEIGHT, g_test_opacities[i], func);
+
+		diff = CompareTestPixels(dst, expected, sizeof(dst), &error_index);
+		if(diff > test->tolerance)
+		{
+			(void)printf("%-16s : opacity %3d pixel (%d, %d) channel %d native %d cairo %d\n",
+				test->name, g_test_opacities[i], (error_index / 4) % TEST_WIDTH,
+				error_index / (TEST_WIDTH*4), error_index % 4, dst[error_index], expected[error_index]);
+			failed = 1;
+		}
+		if(diff > max_diff)
+		{
+			max_diff = diff;
+		}
+
+		// 炵Ĕzuȍ(C[ƓdȂ͈͂̂ݍ)
+			// \[X͔͈͊Ôcairoō
+		if(test->keep_outside == 0)
+		{
+			continue;
+		}
+		FillRandomPixels(part, TEST_PART_WIDTH*TEST_PART_HEIGHT);
+		FillRandomPixels(dst, TEST_WIDTH*TEST_HEIGHT);
+		(void)memcpy(expected, dst, sizeof(dst));
+
+		BlendWithCairo(expected, part, TEST_OFFSET_X, TEST_OFFSET_Y,
+			TEST_PART_WIDTH, TEST_PART_HEIGHT, g_test_opacities[i], test->op);
+		NativeBlendPixels(&dst[TEST_OFFSET_Y*TEST_WIDTH*4 + TEST_OFFSET_X*4], TEST_WIDTH*4,
+			part, TEST_PART_WIDTH*4, TEST_PART_WIDTH, TEST_PART_HEIGHT, g_test_opacities[i], func);
+
+		diff = CompareTestPixels(dst, expected, sizeof(dst), &error_index);
+		if(diff > test->tolerance)
+		{
+			(void)printf("%-16s : offset opacity %3d pixel (%d, %d) channel %d native %d cairo %d\n",
+				test->name, g_test_opacities[i], (error_index / 4) % TEST_WIDTH,
+				error_index / (TEST_WIDTH*4), error_index % 4, dst[error_index], expected[error_index]);
+			failed = 1;
+		}
+		if(diff > max_diff)
+		{
+			max_diff = diff;
+		}
+	}
+
+	(void)printf("%-16s : max difference %d (tolerance %d) %s\n",
+		test->name, max_diff, test->tolerance, (failed == 0) ? "OK" : "FAILED");
+
+	return failed;
+}
+
+int main(int argc, char** argv)
+{
+	int num_failed = 0;
+	unsigned int i;
+
+	// ŗ̎wł悤ɂ
+	srand((argc > 1) ? (unsigned int)atoi(argv[1]) : 1u);
+
+	InitializeNativeBlendFunctions();
+
+	for(i=0; i<sizeof(g_test_cases)/sizeof(g_test_cases[0]); i++)
+	{
+		num_failed += RunBlendTest(&g_test_cases[i]);
+	}
+
+	if(num_failed > 0)
+	{
+		(void)printf("%d mode(s) failed\n", num_failed);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,236 @@
+/*****************************************************************
+* content_bounds_test.c                                          *
+* C[̕sȕ܂ދ`̌vZSŤʂƔׂ   *
+* GTK͏Ȃ̂ŕ\Ăsł              *
+* g : make content_bounds_test && ./content_bounds_test     *
+*****************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../layer_blend_native.h"
+
+// eXgp̉摜̍őTCY
+#define TEST_MAX_WIDTH 53
+#define TEST_MAX_HEIGHT 31
+// 1s̖ɗ]ɊmۂoCg(͈͊O𒲂ׂĂȂ̊mFp)
+#define TEST_STRIDE_PADDING 12
+// _ȃeXg̉
+#define TEST_RANDOM_COUNT 2000
+
+/*******************************************
+* CONTENT_BOUNDS\                     *
+* sȕ܂ދ`                   *
+*******************************************/
+typedef struct _CONTENT_BOUNDS
+{
+	int x, y;
+	int width, height;
+} CONTENT_BOUNDS;
+
+/*************************************************
+* CalcBoundsBruteForce֐                       *
+* SẴsNZ𒲂ׂċ`vZ           *
+*                                            *
+* pixels	: sNZf[^                     *
+* width		:                                  *
+* height	:                                *
+* stride	: 1s̃oCg                    *
+* bounds	: ʂi[AhX             *
+*************************************************/
+static void CalcBoundsBruteForce(
+	const uint8* pixels,
+	int width,
+	int height,
+	int stride,
+	CONTENT_BOUNDS* bounds
+)
+{
+	int min_x = width, min_y = height, max_x = -1, max_y = -1;
+	int x, y;
+
+	for(y=0; y<height; y++)
+	{
+		for(x=0; x<width; x++)
+		{
+			if(pixels[y*stride+x*4+3] != 0)
+			{
+				if(x < min_x)
+				{
+					min_x = x;
+				}
+				if(x > max_x)
+				{
+					max_x = x;
+				}
+				if(y < min_y)
+				{
+					min_y = y;
+				}
+				if(y > max_y)
+				{
+					max_y = y;
+				}
+			}
+		}
+	}
+
+	if(max_x < 0)
+	{
+		bounds->x = bounds->y = 0;
+		bounds->width = bounds->height = 0;
+	}
+	else
+	{
+		bounds->x = min_x;
+		bounds->y = min_y;
+		bounds->width = max_x - min_x + 1;
+		bounds->height = max_y - min_y + 1;
+	}
+}
+
+/*************************************************
+* SetTestPixel֐                               *
+* 1̃sNZsɂ                    *
+*                                            *
+* pixels	: sNZf[^                     *
+* stride	: 1s̃oCg                    *
+* x			: XW                              *
+* y			: YW                              *
+* alpha		: ݒ肷郿l                       *
+*************************************************/
+static void SetTestPixel(uint8* pixels, int stride, int x, int y, uint8 alpha)
+{
+	pixels[y*stride+x*4+0] = alpha;
+	pixels[y*stride+x*4+1] = alpha;
+	pixels[y*stride+x*4+2] = alpha;
+	pixels[y*stride+x*4+3] = alpha;
+}
+
+/*************************************************
+* ClearTestPixels֐                            *
+* 摜𓧖ɂ1s͈̔͊Osɂ      *
+*                                            *
+* pixels	: sNZf[^                     *
+* width		:                                  *
+* height	:                                *
+* stride	: 1s̃oCg                    *
+*************************************************/
+static void ClearTestPixels(uint8* pixels, int width, int height, int stride)
+{
+	int y;
+
+	for(y=0; y<height; y++)
+	{
+		(void)memset(&pixels[y*stride], 0, width*4);
+		(void)memset(&pixels[y*stride+width*4], 0xff, stride - width*4);
+	}
+}
+
+/*************************************************
+* CheckBounds֐                                *
+* vZʂSŤʂƔr               *
+*                                            *
+* name		: eXg̖O                       *
+* pixels	: sNZf[^                     *
+* width		:                                  *
+* height	:                                *
+* stride	: 1s̃oCg                    *
+* Ԃl                                         *
+*	v0AقȂ1                       *
+*************************************************/
+static int CheckBounds(
+	const char* name,
+	const uint8* pixels,
+	int width,
+	int height,
+	int stride
+)
+{
+	CONTENT_BOUNDS expected;
+	CONTENT_BOUNDS result;
+
+	CalcBoundsBruteForce(pixels, width, height, stride, &expected);
+	CalcPixelsContentBounds(pixels, width, height, stride,
+		&result.x, &result.y, &result.width, &result.height);
+
+	if(memcmp(&expected, &result, sizeof(result)) != 0)
+	{
+		(void)printf("%s (%dx%d) : expected (%d, %d, %d, %d) result (%d, %d, %d, %d)\n",
+			name, width, height, expected.x, expected.y, expected.width, expected.height,
+			result.x, result.y, result.width, result.height);
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	static uint8 pixels[TEST_MAX_HEIGHT*(TEST_MAX_WIDTH*4+TEST_STRIDE_PADDING)];
+	const int stride = TEST_MAX_WIDTH*4 + TEST_STRIDE_PADDING;
+	int num_failed = 0;
+	int width, height;
+	int x, y;
+	int i, j;
+
+	// ŗ̎wł悤ɂ
+	srand((argc > 1) ? (unsigned int)atoi(argv[1]) : 1u);
+
+	// Sē(1s͈̔͊OɂsNZ͊܂߂Ȃ)
+	ClearTestPixels(pixels, TEST_MAX_WIDTH, TEST_MAX_HEIGHT, stride);
+	num_failed += CheckBounds("empty", pixels, TEST_MAX_WIDTH, TEST_MAX_HEIGHT, stride);
+
+	// l1sNZ̉摜
+	for(i=0; i<4; i++)
+	{
+		x = ((i & 1) == 0) ? 0 : TEST_MAX_WIDTH - 1;
+		y = ((i & 2) == 0) ? 0 : TEST_MAX_HEIGHT - 1;
+		SetTestPixel(pixels, stride, x, y, 1);
+		num_failed += CheckBounds("corner", pixels, TEST_MAX_WIDTH, TEST_MAX_HEIGHT, stride);
+		SetTestPixel(pixels, stride, x, y, 0);
+	}
+	ClearTestPixels(pixels, 1, 1, stride);
+	SetTestPixel(pixels, stride, 0, 0, 0xff);
+	num_failed += CheckBounds("1x1", pixels, 1, 1, stride);
+
+	// Sĕs
+	for(y=0; y<TEST_MAX_HEIGHT; y++)
+	{
+		for(x=0; x<TEST_MAX_WIDTH; x++)
+		{
+			SetTestPixel(pixels, stride, x, y, 0xff);
+		}
+	}
+	num_failed += CheckBounds("full", pixels, TEST_MAX_WIDTH, TEST_MAX_HEIGHT, stride);
+
+	// _ȃTCYɃ_ɃsNZu
+		// (E̒[sɍLꍇƋ܂ꍇ𗼕ʂ)
+	for(i=0; i<TEST_RANDOM_COUNT; i++)
+	{
+		int num_pixels;
+
+		width = 1 + rand() % TEST_MAX_WIDTH;
+		height = 1 + rand() % TEST_MAX_HEIGHT;
+		num_pixels = rand() % 6;
+
+		ClearTestPixels(pixels, width, height, stride);
+		for(j=0; j<num_pixels; j++)
+		{
+			SetTestPixel(pixels, stride, rand() % width, rand() % height,
+				(uint8)(1 + rand() % 0xff));
+		}
+
+		num_failed += CheckBounds("random", pixels, width, height, stride);
+	}
+
+	if(num_failed > 0)
+	{
+		(void)printf("%d case(s) failed\n", num_failed);
+		return 1;
+	}
+
+	(void)printf("content bounds : OK\n");
+
+	return 0;
+}
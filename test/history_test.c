@@ -0,0 +1,256 @@
+/*****************************************************************
+* history_test.c                                                 *
+* f[^̈kEꎞt@Cւ̑ޔƓǂݖ߂mF     *
+* ̊֐ĂԂhistory.c𒼐ڎ荞                    *
+* GTK͏Ȃ̂ŕ\Ăsł              *
+* g : make history_test && ./history_test                   *
+*****************************************************************/
+
+#include "../history.c"
+
+// eXgŒǉ闚̐
+#define TEST_NUM_HISTORY 12
+// ꎞt@CɑޔɎc̐
+#define TEST_SPILL_STEPS 3
+// f[^̍ŏ̃oCg(k傫ɂ)
+#define TEST_DATA_SIZE (HISTORY_COMPRESS_MIN_SIZE * 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************
+* ȉ͗̒ǉEǂݖ߂ł͌Ă΂Ȃ֐̑ *
+*****************************************************/
+DRAW_WINDOW* GetActiveDrawWindow(APPLICATION* app)
+{
+	return NULL;
+}
+
+void ClearLayerSetCache(DRAW_WINDOW* window)
+{
+}
+
+void ClearLayerContentBounds(DRAW_WINDOW* window)
+{
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+// f[^̔z񂪑傫̂staticɂ
+static HISTORY g_history;
+
+/*************************************************
+* GetTestDataSize֐                            *
+* eXgp̗f[^̃oCg߂         *
+*                                            *
+* number	: ̔ԍ                         *
+* Ԃl                                         *
+*	f[^̃oCg                         *
+*************************************************/
+static size_t GetTestDataSize(int number)
+{
+	return TEST_DATA_SIZE + (size_t)number * 777;
+}
+
+/*************************************************
+* FillTestData֐                               *
+* eXgp̗f[^쐬                 *
+* (Ԗڂ͈kłf[^AԖڂ͗)   *
+*                                            *
+* data		: f[^ރobt@           *
+* number	: ̔ԍ                         *
+*************************************************/
+static void FillTestData(uint8* data, int number)
+{
+	size_t size = GetTestDataSize(number);
+	guint32 random = (guint32)number * 2654435761u + 1;
+	size_t i;
+
+	for(i=0; i<size; i++)
+	{
+		if((number & 1) == 0)
+		{
+			data[i] = (uint8)(number + i / 64);
+		}
+		else
+		{
+			random = random * 1103515245u + 12345u;
+			data[i] = (uint8)(random >> 16);
+		}
+	}
+}
+
+/*************************************************
+* GetTestHistoryIndex֐                        *
+* Ԗڂɒǉz̈ʒu߂   *
+*                                            *
+* number	: ̔ԍ                         *
+* Ԃl                                         *
+*	f[^z̃CfbNX                 *
+*************************************************/
+static int GetTestHistoryIndex(int number)
+{
+	return number % HISTORY_BUFFER_SIZE;
+}
+
+/*************************************************
+* WaitHistoryCompression֐                     *
+* ʃXbhł̈kEoSďI܂   *
+* C[ṽAChs           *
+*************************************************/
+static void WaitHistoryCompression(void)
+{
+	while(g_history.compress.thread != NULL)
+	{
+		(void)g_main_context_iteration(NULL, TRUE);
+	}
+}
+
+/*************************************************
+* CheckLoadedData֐                            *
+* f[^ǂݖ߂Č̃f[^Ɣr     *
+*                                            *
+* number	: ̔ԍ                         *
+* Ԃl                                         *
+*	v0AقȂ1                       *
+*************************************************/
+static int CheckLoadedData(int number)
+{
+	HISTORY_DATA *data = &g_history.history[GetTestHistoryIndex(number)];
+	uint8 *expected = (uint8*)MEM_ALLOC_FUNC(GetTestDataSize(number));
+	int result = 0;
+
+	FillTestData(expected, number);
+
+	if(LoadHistoryData(&g_history, GetTestHistoryIndex(number)) != 0)
+	{
+		(void)printf("history %d : failed to load\n", number);
+		result = 1;
+	}
+	else if(data->data_size != GetTestDataSize(number)
+		|| memcmp(data->data, expected, data->data_size) != 0)
+	{
+		(void)printf("history %d : loaded data differs\n", number);
+		result = 1;
+	}
+	else if((data->flags & HISTORY_DATA_SPILLED) != 0 || data->compressed != NULL)
+	{
+		(void)printf("history %d : still marked as spilled or compressed\n", number);
+		result = 1;
+	}
+
+	MEM_FREE_FUNC(expected);
+
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	uint8 *buffer = (uint8*)MEM_ALLOC_FUNC(GetTestDataSize(TEST_NUM_HISTORY));
+	HISTORY_DATA *data;
+	gint64 spill_size;
+	gint64 spill_offset;
+	int num_spilled = 0;
+	int num_failed = 0;
+	int reload;
+	int i;
+
+#if !GLIB_CHECK_VERSION(2, 32, 0)
+	if(g_thread_supported() == FALSE)
+	{
+		g_thread_init(NULL);
+	}
+#endif
+
+	g_history.spill_steps = TEST_SPILL_STEPS;
+
+	// ǉxɌÂ̂kEޔ
+	for(i=0; i<TEST_NUM_HISTORY; i++)
+	{
+		FillTestData(buffer, i);
+		AddHistory(&g_history, "test", buffer, GetTestDataSize(i), NULL, NULL);
+		WaitHistoryCompression();
+	}
+
+	// VTEST_SPILL_STEPSȊO͈ꎞt@Cɂ
+	for(i=0; i<TEST_NUM_HISTORY; i++)
+	{
+		data = &g_history.history[GetTestHistoryIndex(i)];
+		if((data->flags & HISTORY_DATA_SPILLED) != 0)
+		{
+			num_spilled++;
+			if(data->data != NULL || data->compressed != NULL)
+			{
+				(void)printf("history %d : spilled but still in memory\n", i);
+				num_failed++;
+			}
+		}
+		else if(i < TEST_NUM_HISTORY - TEST_SPILL_STEPS)
+		{
+			(void)printf("history %d : not spilled\n", i);
+			num_failed++;
+		}
+	}
+	if(num_spilled == 0 || g_history.spill_file == NULL)
+	{
+		(void)printf("no history was spilled\n");
+		MEM_FREE_FUNC(buffer);
+		ReleaseHistory(&g_history);
+		return 1;
+	}
+
+	// r̗ǂݖ߂Ƌ󂢂̈ɏo
+	reload = (TEST_NUM_HISTORY - TEST_SPILL_STEPS) / 2;
+	data = &g_history.history[GetTestHistoryIndex(reload)];
+	spill_size = g_history.spill_size;
+	spill_offset = data->spill_offset;
+	num_failed += CheckLoadedData(reload);
+	if(g_history.num_spill_free != 1)
+	{
+		(void)printf("freed extent is not recorded (%d extents)\n", g_history.num_spill_free);
+		num_failed++;
+	}
+	StartHistoryCompression(&g_history);
+	WaitHistoryCompression();
+	if((data->flags & HISTORY_DATA_SPILLED) == 0 || data->spill_offset != spill_offset
+		|| g_history.spill_size != spill_size || g_history.num_spill_free != 0)
+	{
+		(void)printf("history %d : freed extent was not reused\n", reload);
+		num_failed++;
+	}
+
+	// ɖ߂̂ƓVSēǂݖ߂
+	for(i=TEST_NUM_HISTORY-1; i>=0; i--)
+	{
+		num_failed += CheckLoadedData(i);
+	}
+
+	// Sēǂݖ߂Έꎞt@C͋ɂȂ
+	if(g_history.spill_size != 0 || g_history.num_spill_free != 0)
+	{
+		(void)printf("spill file is not empty (%d bytes, %d extents)\n",
+			(int)g_history.spill_size, g_history.num_spill_free);
+		num_failed++;
+	}
+
+	MEM_FREE_FUNC(buffer);
+	ReleaseHistory(&g_history);
+	if(g_history.spill_file != NULL || g_history.total_size != 0)
+	{
+		(void)printf("history is not released\n");
+		num_failed++;
+	}
+
+	if(num_failed > 0)
+	{
+		(void)printf("%d check(s) failed\n", num_failed);
+		return 1;
+	}
+
+	(void)printf("history spill : %d of %d spilled, OK\n", num_spilled, TEST_NUM_HISTORY);
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*****************************************************************
+* layer_id_test.c                                                *
+* C[ID̊蓖ĂIĎmF                 *
+* GTK͏Ȃ̂ŕ\Ăsł              *
+* g : make layer_id_test && ./layer_id_test                 *
+*****************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "../layer.h"
+#include "../draw_window.h"
+
+// eXgō쐬郌C[̐(\̍ănbVʂ鐔ɂ)
+#define TEST_NUM_LAYER (LAYER_ID_TABLE_SIZE * 4)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************
+* SearchLayer֐                        *
+* layer.cƓOŃC[T    *
+* (layer.cGTKɈˑ̂ő)   *
+*****************************************/
+LAYER* SearchLayer(LAYER* bottom_layer, const gchar* name)
+{
+	LAYER* layer = bottom_layer;
+
+	while(layer != NULL)
+	{
+		if(strcmp(layer->name, name) == 0)
+		{
+			return layer;
+		}
+		layer = layer->next;
+	}
+
+	return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+// `̈ƃC[͑傫̂staticɂ
+static DRAW_WINDOW g_window;
+static LAYER g_layers[TEST_NUM_LAYER];
+static char g_names[TEST_NUM_LAYER][16];
+
+#define CHECK(CONDITION, MESSAGE) \
+	if(!(CONDITION)) \
+	{ \
+		(void)printf("line %d : %s\n", __LINE__, (MESSAGE)); \
+		num_failed++; \
+	}
+
+int main(int argc, char** argv)
+{
+	LAYER recreated = {0};
+	uint32 id;
+	int num_failed = 0;
+	int i, j;
+
+	// OŒT悤ɃC[Ȃł
+	for(i=0; i<TEST_NUM_LAYER; i++)
+	{
+		(void)sprintf(g_names[i], "layer %d", i);
+		g_layers[i].name = g_names[i];
+		g_layers[i].window = &g_window;
+		g_layers[i].next = (i < TEST_NUM_LAYER - 1) ? &g_layers[i+1] : NULL;
+		g_layers[i].prev = (i > 0) ? &g_layers[i-1] : NULL;
+	}
+	g_window.layer = g_layers;
+
+	// VID0ȊOŏdȂȂ
+	for(i=0; i<TEST_NUM_LAYER; i++)
+	{
+		AssignLayerID(&g_layers[i], 0);
+		CHECK(g_layers[i].id != 0, "new ID is 0");
+	}
+	for(i=0; i<TEST_NUM_LAYER; i++)
+	{
+		CHECK(SearchLayerByID(&g_window, g_layers[i].id) == &g_layers[i],
+			"layer is not found by its ID");
+		for(j=i+1; j<TEST_NUM_LAYER; j++)
+		{
+			if(g_layers[i].id == g_layers[j].id)
+			{
+				(void)printf("layer %d and %d share ID %u\n", i, j, (unsigned int)g_layers[i].id);
+				num_failed++;
+			}
+		}
+	}
+	CHECK(SearchLayerByID(&g_window, 0) == NULL, "ID 0 finds a layer");
+	CHECK(SearchLayerByID(&g_window, g_window.last_layer_id + 1) == NULL,
+		"unused ID finds a layer");
+
+	// gpIDw肷ƐVIDɂȂ
+	id = g_layers[0].id;
+	AssignLayerID(&g_layers[1], id);
+	CHECK(g_layers[1].id != id && g_layers[1].id != 0, "used ID is assigned twice");
+	CHECK(SearchLayerByID(&g_window, id) == &g_layers[0], "owner of the used ID changed");
+	CHECK(SearchLayerByID(&g_window, g_layers[1].id) == &g_layers[1],
+		"reassigned layer is not found");
+
+	// gp̑傫IDw肷Ƃȍ~ID͂̎甭s
+	id = g_window.last_layer_id + 100;
+	AssignLayerID(&g_layers[2], id);
+	CHECK(g_layers[2].id == id, "unused ID is not kept");
+	CHECK(g_window.last_layer_id == id, "last ID is not updated");
+	AssignLayerID(&g_layers[3], 0);
+	CHECK(g_layers[3].id == id + 1, "next ID does not follow the last ID");
+
+	// 폜C[IDō蒼C[(ɖ߂)
+	id = g_layers[4].id;
+	UnregisterLayerID(&g_layers[4]);
+	CHECK(g_layers[4].id == 0, "unregistered layer keeps its ID");
+	CHECK(SearchLayerByID(&g_window, id) == NULL, "unregistered layer is found");
+	recreated.name = g_names[4];
+	recreated.window = &g_window;
+	AssignLayerID(&recreated, id);
+	CHECK(recreated.id == id, "recreated layer does not get the old ID");
+	CHECK(SearchLayerByID(&g_window, id) == &recreated, "recreated layer is not found");
+
+	// ʂ̃C[o^ĂIDC[OĂ\͕ςȂ
+	g_layers[4].id = id;
+	UnregisterLayerID(&g_layers[4]);
+	CHECK(SearchLayerByID(&g_window, id) == &recreated, "recreated layer was unregistered");
+
+	// IDŌȂΖOŒT
+	CHECK(SearchLayerByIDAndName(&g_window, g_layers[5].id, "no such layer") == &g_layers[5],
+		"ID is not preferred to the name");
+	CHECK(SearchLayerByIDAndName(&g_window, 0, g_names[6]) == &g_layers[6],
+		"layer is not found by name");
+	CHECK(SearchLayerByIDAndName(&g_window, g_window.last_layer_id + 1, g_names[7]) == &g_layers[7],
+		"unknown ID does not fall back to the name");
+
+	ght_finalize(g_window.layer_table);
+
+	if(num_failed > 0)
+	{
+		(void)printf("%d check(s) failed\n", num_failed);
+		return 1;
+	}
+
+	(void)printf("layer id : OK\n");
+
+	return 0;
+}
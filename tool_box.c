@@ -1298,6 +1298,8 @@ void DeleteBrushData(APPLICATION* app)
 	target->image_file_path = NULL;
 	MEM_FREE_FUNC(target->brush_data);
 	target->brush_data = NULL;
+	ReleaseBrushDabCache(target);
+	ReleaseBrushImageCache(target);
 
 	for(y=0; y<BRUSH_TABLE_HEIGHT && target_y < 0; y++)
 	{
@@ -118,6 +118,7 @@ TRANSFORM_DATA *CreateTransformData(DRAW_WINDOW* window)
 
 			cairo_set_source(ret->layers[i]->cairo_p, before_pattern);
 			cairo_paint(ret->layers[i]->cairo_p);
+			UpdateLayerContentGeneration(ret->layers[i]);
 
 			cairo_pattern_destroy(before_pattern);
 			cairo_surface_destroy(before_surface);
@@ -679,6 +680,7 @@ void Transform(TRANSFORM_DATA* transform)
 		cairo_set_operator(transform->layers[i]->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(transform->layers[i]->cairo_p, window->mask_temp->surface_p, 0, 0);
 		cairo_mask_surface(transform->layers[i]->cairo_p, surface_p, 0, 0);
+		UpdateLayerContentGeneration(transform->layers[i]);
 	}
 
 	cairo_surface_destroy(surface_p);
@@ -781,6 +783,7 @@ void ProjectionTransform(TRANSFORM_DATA* transform, FLOAT_T projection_param[4][
 		cairo_set_operator(transform->layers[i]->cairo_p, CAIRO_OPERATOR_OVER);
 		cairo_set_source_surface(transform->layers[i]->cairo_p, window->temp_layer->surface_p, 0, 0);
 		cairo_mask_surface(transform->layers[i]->cairo_p, surface_p, 0, 0);
+		UpdateLayerContentGeneration(transform->layers[i]);
 	}
 
 	cairo_surface_destroy(surface_p);
@@ -1677,6 +1680,7 @@ typedef struct _TRANSFORM_HISTORY_DATA
 	uint16 num_layer;
 	uint16 *layer_name_length;
 	char **layer_names;
+	uint32 *layer_ids;
 	uint8 **pixels;
 } TRANSFORM_HISTORY_DATA;
 
@@ -1707,6 +1711,9 @@ void TransformUndoRedo(DRAW_WINDOW *window, void* p)
 		data.layer_names[i] = (char*)byte_data;
 		byte_data += data.layer_name_length[i];
 	}
+	data.layer_ids = (uint32*)MEM_ALLOC_FUNC(sizeof(*data.layer_ids)*data.num_layer);
+	(void)memcpy(data.layer_ids, byte_data, sizeof(*data.layer_ids)*data.num_layer);
+	byte_data += sizeof(*data.layer_ids) * data.num_layer;
 	data.pixels = (uint8**)MEM_ALLOC_FUNC(sizeof(*data.pixels)*(data.num_layer+1));
 	for(i=0; i<data.num_layer; i++)
 	{
@@ -1717,11 +1724,7 @@ void TransformUndoRedo(DRAW_WINDOW *window, void* p)
 
 	for(i=0; i<data.num_layer; i++)
 	{
-		layer = window->layer;
-		while(strcmp(data.layer_names[i], layer->name) != 0)
-		{
-			layer = layer->next;
-		}
+		layer = SearchLayerByIDAndName(window, data.layer_ids[i], data.layer_names[i]);
 
 		for(j=0; j<(unsigned int)data.height; j++)
 		{
@@ -1756,6 +1759,7 @@ void TransformUndoRedo(DRAW_WINDOW *window, void* p)
 	}
 
 	MEM_FREE_FUNC(data.layer_names);
+	MEM_FREE_FUNC(data.layer_ids);
 	MEM_FREE_FUNC(data.pixels);
 }
 
@@ -1785,6 +1789,10 @@ void AddTransformHistory(DRAW_WINDOW *window, uint8* before_selection_area)
 			1, strlen(transform->layers[i]->name) + 1, stream);
 	}
 	for(i=0; i<transform->num_layers; i++)
+	{
+		(void)MemWrite(&transform->layers[i]->id, sizeof(transform->layers[i]->id), 1, stream);
+	}
+	for(i=0; i<transform->num_layers; i++)
 	{
 		(void)memcpy(window->temp_layer->pixels, transform->before_pixels[i],
 			transform->layers[i]->stride * transform->layers[i]->height);
@@ -2030,6 +2038,7 @@ static void ClickedTransformButtonCancel(GtkWidget* button, APPLICATION* app)
 			window->transform->layers[i]->stride * window->transform->layers[i]->height);
 		cairo_set_source_surface(restore_cairo, before_surface, 0, 0);
 		cairo_paint(restore_cairo);
+		UpdateLayerContentGeneration(window->transform->layers[i]);
 
 		cairo_destroy(restore_cairo);
 		cairo_surface_destroy(before_surface);